@@ -16,7 +16,8 @@
  * REQUIREMENTS:
  *   - Single-writer access (caller must ensure)
  *   - Finite input values (no NaN/Inf)
- *   - Regular observation rate (caller provides)
+ *   - Regular observation rate (caller provides), or timestamps via
+ *     base_step_at()
  * 
  * See: lessons/module2-baseline/ for proofs and data dictionary
  * 
@@ -27,6 +28,7 @@
 #ifndef BASELINE_H
 #define BASELINE_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /**
@@ -61,12 +63,17 @@ typedef struct {
  * 
  * INVARIANTS:
  *   INV-1: state ∈ { LEARNING, STABLE, DEVIATION }
- *   INV-2: (state ≠ LEARNING) → (n ≥ cfg.n_min ∧ variance > cfg.epsilon)
+ *   INV-2: (state ≠ LEARNING ∧ ¬faulted) → (n ≥ cfg.n_min); LEARNING →
+ *          STABLE also needs variance > cfg.epsilon, which may decay
+ *          below it afterwards (z = 0 under the floor)
  *   INV-3: (fault_fp ∨ fault_reentry) → (state == DEVIATION)
  *   INV-4: (in_step == 0) when not executing base_step
  *   INV-5: variance ≥ 0
- *   INV-6: sigma == √variance (cached, always consistent)
+ *   INV-6: sigma == √variance (cached; refreshed by base_sigma() while
+ *          sigma_stale is set by base_step_fast())
  *   INV-7: n increments monotonically (nₜ = nₜ₋₁ + 1 on each non-faulted step)
+ *   INV-8: log2_keep == log₂(1 - cfg.alpha); t_last is the latest time
+ *          of any non-faulted base_step_at()
  * 
  * FAULT BEHAVIOUR:
  *   fault_* flags are sticky; only cleared by base_reset().
@@ -89,6 +96,13 @@ typedef struct {
 
     /* Atomicity guard */
     uint8_t      in_step;       /* Reentrancy guard                     */
+
+    /* Lazy σ (base_step_fast) */
+    uint8_t      sigma_stale;   /* sigma lags variance until base_sigma() */
+
+    /* Irregular sampling (base_step_at) */
+    uint64_t     t_last;        /* Time of the last timed observation   */
+    double       log2_keep;     /* Cached: log₂(1 - α)                  */
 } base_fsm_t;
 
 /**
@@ -152,6 +166,94 @@ int base_init(base_fsm_t *b, const base_config_t *cfg);
  */
 base_result_t base_step(base_fsm_t *b, double x);
 
+/**
+ * Execute one atomic step for an observation taken at time t.
+ *
+ * For irregular sampling: the observation carries the weight the EMA
+ * would give it after dt = t - t_last of regular steps of period T,
+ *
+ *   λ = (1-α)^(dt/T),   μₜ = (1-λ)·xₜ + λ·μₜ₋₁,
+ *                       σₜ² = (1-λ)·deviation² + λ·σₜ₋₁²
+ *
+ * so a burst of close samples counts as about one, and a long gap
+ * forgets the old statistics as that many missed samples would. λ
+ * comes from a 64-entry table of 2^(j/64) and a degree-5 polynomial,
+ * not pow(): its relative error against pow(1-α, dt/T) is at most
+ * (1 + |log₂ λ|) · 2⁻⁵¹, the rounding of the exponent itself.
+ *
+ * The first observation, T == 0 and dt == T all step exactly as
+ * base_step() does. t ≤ t_last (a repeated or late timestamp) gives
+ * the observation no weight: it is scored but does not move μ, σ² or
+ * t_last, so the next in-order sample is spaced from the latest one.
+ *
+ * @param b Pointer to initialised FSM
+ * @param x Observation value (must be finite)
+ * @param t Observation time, in any unit
+ * @param T Nominal sampling period alpha was chosen for, same unit
+ * @return  Result containing z-score and new state
+ *
+ * GUARANTEE: State transitions and faults exactly as base_step();
+ *            faulted observations leave t_last unchanged.
+ */
+base_result_t base_step_at(base_fsm_t *b, double x, uint64_t t, uint64_t T);
+
+/**
+ * Execute base_step() on every element of x, in order.
+ *
+ * Equivalent to a loop of base_step(b, x[i]): the same statistics,
+ * states and z-scores, computed by the same operations in the same
+ * order. The statistics stay in locals for the whole array, with no
+ * per-call guard toggling, re-validation or result struct. Each
+ * output may be NULL.
+ *
+ * @param b         Pointer to initialised FSM
+ * @param x         n observations
+ * @param n         Number of observations
+ * @param z_out     n z-scores (base_result_t.z), or NULL
+ * @param state_out n states after each observation, or NULL
+ * @param dev_mask  (n + 63) / 64 words; bit i % 64 of word i / 64 is
+ *                  set iff the state after x[i] is DEVIATION. Or NULL.
+ * @return          Number of observations that left b in DEVIATION
+ *
+ * CONTRACT: b must have been initialised via base_init().
+ * GUARANTEE: b, and every output, equal what the base_step() loop
+ *            would have produced; a reentrant call faults every entry.
+ */
+size_t base_step_batch(base_fsm_t *b, const double *x, size_t n,
+                       double *z_out, uint8_t *state_out,
+                       uint64_t *dev_mask);
+
+/**
+ * Execute one atomic step without √ or ÷: the fast evaluation mode.
+ *
+ * Updates μ, σ², n, state and faults as base_step() does, but decides
+ * z > k as deviation² > k²·σ², which is the same test for σ > 0. Only
+ * z within a few ulps of k can round to the other side. σ is
+ * refreshed and z computed only when asked for, by base_sigma() and
+ * base_zscore().
+ *
+ * @param b Pointer to initialised FSM
+ * @param x Observation value (must be finite)
+ * @return  As base_step(), except r.z is NaN (not computed)
+ *
+ * CONTRACT: b must have been initialised via base_init().
+ * GUARANTEE: μ, σ², n and faults equal base_step()'s exactly.
+ */
+base_result_t base_step_fast(base_fsm_t *b, double x);
+
+/**
+ * Current σ, refreshing the cached value after base_step_fast().
+ */
+double base_sigma(base_fsm_t *b);
+
+/**
+ * z-score of a deviation against the current σ: r.z of base_step()
+ * when given r.deviation from the same step of base_step_fast().
+ *
+ * @return |deviation| / σ, or 0.0 while σ² ≤ ε (variance floor)
+ */
+double base_zscore(base_fsm_t *b, double deviation);
+
 /**
  * Reset baseline to initial state (re-enter LEARNING).
  * Preserves configuration, clears statistics and faults.
@@ -0,0 +1,74 @@
+/**
+ * baseline_backfill.h - Multi-Threaded Historical Backfill
+ *
+ * Replays a long recorded series through a baseline monitor on every
+ * core, producing the same final base_fsm_t and per-sample z-scores a
+ * base_step() loop would, in a fraction of the wall time.
+ *
+ * THE CORE INSIGHT:
+ *   The EMA is an affine recurrence, μₜ = α·xₜ + (1-α)·μₜ₋₁, and the
+ *   composition of affine maps is associative. A chunk of L samples
+ *   run from an arbitrary start g yields mₗ with
+ *
+ *     μₗ = mₗ + (1-α)ᴸ·(μ₀ - g)
+ *
+ *   for whatever μ₀ the chunk really starts from. The variance is
+ *   affine in σ² too, but its input (xₜ - μₜ₋₁)² is quadratic in the
+ *   start, so each chunk carries three coefficients:
+ *
+ *     σ²ₗ = v₀ + v₁·δ + v₂·δ² + (1-α)ᴸ·σ²₀       δ = μ₀ - g
+ *
+ *   Pass 1 summarises every chunk in parallel, a short serial scan
+ *   turns the summaries into each chunk's true start, and pass 2
+ *   replays every chunk from its start in parallel, writing z.
+ *
+ * The FSM needs no scan of its own: from STABLE or DEVIATION the next
+ * state depends only on that step's z > k, so a chunk only reports
+ * where it first became ready and where it first faulted.
+ *
+ * CONTRACTS:
+ *   1. EQUIVALENCE: b ends as a base_step() loop over x would leave it
+ *                   (n, state, faults exactly; μ, σ² to rounding).
+ *   2. PRECISION:   Each chunk starts from μ and σ² that differ from
+ *                   the serial values only by the rounding of the
+ *                   scan; the difference decays as (1-α)ᵗ inside the
+ *                   chunk. Only a z within that rounding of k can
+ *                   classify differently.
+ *   3. FALLBACK:    Short series, one thread, a reentrant call or an
+ *                   overflowing update run base_step_batch() instead,
+ *                   which is exact.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to b (caller must ensure)
+ *   - POSIX threads
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef BASELINE_BACKFILL_H
+#define BASELINE_BACKFILL_H
+
+#include <stddef.h>
+#include "baseline.h"
+
+/** Fewest samples per thread worth a chunk of its own */
+#define BASE_BACKFILL_MIN_CHUNK 65536u
+
+/**
+ * Step b through every element of x, in order, on several threads.
+ *
+ * @param b       Pointer to initialised FSM (continues from its state)
+ * @param x       n observations
+ * @param n       Number of observations
+ * @param z_out   n z-scores (base_result_t.z of each step), or NULL
+ * @param threads Threads to use; 0 uses every online CPU
+ * @return        Number of observations that left b in DEVIATION
+ *
+ * CONTRACT: b must have been initialised via base_init().
+ * GUARANTEE: Non-finite samples fault exactly as in base_step().
+ */
+size_t base_backfill(base_fsm_t *b, const double *x, size_t n,
+                     double *z_out, unsigned threads);
+
+#endif /* BASELINE_BACKFILL_H */
@@ -0,0 +1,224 @@
+/**
+ * baseline_fleet.h - Structure-of-Arrays Fleet of Normality Monitors
+ *
+ * The same closed, total, deterministic state machine as baseline.h,
+ * stored column-wise so that N streams sharing one configuration can
+ * be stepped together, one observation per stream, 4 or 8 streams
+ * per vector instruction.
+ *
+ * An array of base_fsm_t costs 88 bytes per stream, config included,
+ * and every step pays a call, a reentrancy toggle and a switch. The
+ * fleet keeps the config once and each state field in its own column:
+ *
+ *   mu[]             base_value_t   8 / 4 / 4 bytes
+ *   variance[]       base_value_t   8 / 4 / 4 bytes
+ *   sigma[]          base_value_t   8 / 4 / 4 bytes
+ *   count[]          uint32_t       4 bytes   (base_fsm_t.n)
+ *   state[]          uint8_t        1 byte
+ *   fault_fp[]       uint8_t        1 byte
+ *   fault_reentry[]  uint8_t        1 byte
+ *
+ * Step kernels:
+ *
+ *   BASE_KERNEL_SCALAR   Portable C, one stream at a time
+ *   BASE_KERNEL_AVX2     4 streams per 256-bit vector (8 in float32)
+ *   BASE_KERNEL_AVX512   8 streams per 512-bit vector (16 in float32)
+ *
+ * The vector kernels replace the switch on state with lane masks and
+ * commit statistics per lane: a NaN in one stream faults that stream
+ * alone, never its neighbours in the vector.
+ *
+ * CONTRACTS:
+ *   Identical to baseline.h. Stream i of a fleet stepped with
+ *   base_fleet_step() reaches exactly the state (mu, variance, sigma,
+ *   n, state, faults) a base_fsm_t would reach under base_step() with
+ *   the observation x[i], whichever kernel runs. No kernel contracts
+ *   multiply-adds or reorders arithmetic.
+ *
+ *   In a reduced-precision build the statistics instead stay within
+ *   the bounds below of that reference, and every kernel of the build
+ *   still produces identical results.
+ *
+ * REDUCED PRECISION (compile time, for bandwidth-bound fleets):
+ *
+ *   -DBASE_FLOAT32      Columns and arithmetic in IEEE single precision
+ *   -DBASE_FIXED_POINT  Columns in Q16.16; mean and variance updated in
+ *                       integer arithmetic (√ and z via double)
+ *
+ *   Either cuts a stream from 31 to 19 bytes. Observations, z-scores
+ *   and the configuration stay double.
+ *
+ *   Q16.16 represents |x| < 32768 and σ² < 32768 (σ < 181): a value
+ *   outside that range faults the stream exactly as ±∞ does. From the
+ *   initial μ = 0, σ² peaks near 0.28·x² (α = 0.1), so a stream must
+ *   start within |x| ≲ 340 or be recentred by the caller. It also
+ *   quantises α to a multiple of 2⁻¹⁶ and ε down to a multiple of
+ *   2⁻¹⁶ (the default 1e-9 becomes 0: any non-zero σ² is above it).
+ *
+ * ERROR BOUNDS against base_step() on the same observations, once
+ * the EMA has forgotten its start (t ≫ 1/α):
+ *
+ *   M = max |xₜ|, D = max |xₜ - μₜ₋₁|, σ = current σₜ
+ *
+ *   float32 (u = 2⁻²⁴)             Q16.16 (q = 2⁻¹⁷)
+ *   Eμ  = 4·u·M / α                Eμ  = (1 + 1/α)·q + (q/α)·D
+ *   Ed  = Eμ + 2·u·M               Ed  = Eμ + q
+ *   Eσ² = 2·D·Ed + 4·u·D² / α      Eσ² = 2·D·Ed + Ed² + (q/α)·D²
+ *                                        + (1 + 1/α)·q
+ *   Eσ  = Eσ² / (2σ) + u·σ         Eσ  = Eσ² / (2σ) + 2q
+ *   Ez  = (Ed + z·Eσ) / σ + 2·u·z  Ez  = (Ed + z·Eσ) / σ
+ *
+ *   |μ - μ_ref| ≤ Eμ, |σ² - σ²_ref| ≤ Eσ², |σ - σ_ref| ≤ Eσ and
+ *   |z - z_ref| ≤ Ez, to first order in u or q. Float32 error scales
+ *   with the signal's magnitude M, Q16.16 error with its swing D: both
+ *   reach z through 1/σ, so a signal far from zero (float32) or with
+ *   σ near the resolution (Q16.16) loses z accuracy first. With the
+ *   default α = 0.1, x ≈ 300, σ ≈ 1 and z near k = 3, Ez is about
+ *   8e-3 in float32 and 5e-3 in Q16.16; measured errors are 2-5
+ *   times smaller. A z within Ez of k may classify differently from
+ *   the reference.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to the whole fleet (caller must ensure)
+ *   - Backing memory provided by the caller (no allocation here)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef BASELINE_FLEET_H
+#define BASELINE_FLEET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "baseline.h"
+
+/*===========================================================================
+ * Column Precision: double (default), float32 or Q16.16
+ *===========================================================================*/
+
+#if defined(BASE_FLOAT32) && defined(BASE_FIXED_POINT)
+    #error "BASE_FLOAT32 and BASE_FIXED_POINT are mutually exclusive"
+#endif
+
+#if defined(BASE_FIXED_POINT)
+    typedef int32_t base_value_t;
+    #define BASE_VALUE_SCALE 65536
+    #define BASE_TO_DOUBLE(v)  ((double)(v) / BASE_VALUE_SCALE)
+#elif defined(BASE_FLOAT32)
+    typedef float base_value_t;
+    #define BASE_VALUE_SCALE 1
+    #define BASE_TO_DOUBLE(v)  ((double)(v))
+#else
+    typedef double base_value_t;
+    #define BASE_VALUE_SCALE 1
+    #define BASE_TO_DOUBLE(v)  (v)
+#endif
+
+/**
+ * Implementation of the per-stream step body.
+ *
+ * All kernels produce identical results; they differ only in speed.
+ * Q16.16 builds have only the scalar kernel.
+ */
+typedef enum {
+    BASE_KERNEL_SCALAR = 0,  /* Portable C                      */
+    BASE_KERNEL_AVX2   = 1,  /* 4 streams per step, x86-64 AVX2 */
+    BASE_KERNEL_AVX512 = 2   /* 8 streams per step, AVX-512F    */
+} base_kernel_t;
+
+/**
+ * Fleet of normality monitors sharing one configuration.
+ *
+ * INVARIANTS (for every i < n): those of base_fsm_t, column-wise.
+ *   INV-1: state[i] ∈ { LEARNING, STABLE, DEVIATION }
+ *   INV-3: (fault_fp[i] ∨ fault_reentry[i]) → (state[i] == DEVIATION)
+ *   INV-4: (in_step == 0) when not executing base_fleet_step
+ *   INV-6: sigma[i] == √variance[i]
+ *
+ * The per-stream reentrancy guard of base_fsm_t becomes a single
+ * fleet-wide guard: the fleet is the unit of atomicity.
+ */
+typedef struct {
+    base_config_t cfg;           /* Shared configuration              */
+    base_value_t  epsilon;       /* cfg.epsilon in column precision   */
+    size_t        n;             /* Number of streams                 */
+    base_value_t *mu;            /* Column: EWMA mean                 */
+    base_value_t *variance;      /* Column: EWMA variance             */
+    base_value_t *sigma;         /* Column: cached √variance          */
+    uint32_t     *count;         /* Column: observation count         */
+    uint8_t      *state;         /* Column: base_state_t as one byte  */
+    uint8_t      *fault_fp;      /* Column: NaN/Inf detected          */
+    uint8_t      *fault_reentry; /* Column: atomicity violation       */
+    uint8_t       in_step;       /* Fleet-wide reentrancy guard       */
+    base_kernel_t kernel;        /* Step kernel used by the fleet     */
+} base_fleet_t;
+
+/**
+ * Bytes of backing memory required for a fleet of n streams, in the
+ * precision this library was built with.
+ *
+ * Each column starts on a 64-byte boundary relative to the start of
+ * the buffer, so a 64-byte-aligned buffer gives cache-aligned columns.
+ *
+ * @return Required size in bytes (0 if n is 0 or the size overflows)
+ */
+size_t base_fleet_bytes(size_t n);
+
+/**
+ * Initialise a fleet over caller-provided memory.
+ *
+ * Every stream is initialised as if by base_init(b, cfg), and the
+ * fleet is set to step with the widest kernel this CPU supports.
+ *
+ * @param f        Pointer to fleet structure
+ * @param mem      Backing memory, aligned to sizeof(base_value_t)
+ * @param mem_size Size of mem in bytes (>= base_fleet_bytes(n))
+ * @param n        Number of streams (> 0)
+ * @param cfg      Configuration shared by every stream (C1-C4)
+ * @return         0 on success, -1 on invalid parameters
+ */
+int base_fleet_init(base_fleet_t *f, void *mem, size_t mem_size, size_t n,
+                    const base_config_t *cfg);
+
+/**
+ * Execute one atomic step of every stream in the fleet.
+ *
+ * Equivalent to r = base_step(&b[i], x[i]) for every i in order.
+ *
+ * @param f     Pointer to initialised fleet
+ * @param x     n observations, x[i] for stream i
+ * @param z_out n z-scores (r.z of each stream), or NULL
+ */
+void base_fleet_step(base_fleet_t *f, const double *x, double *z_out);
+
+/**
+ * Choose the kernel used by base_fleet_step().
+ *
+ * @return 0 on success, -1 if k is not supported on this CPU
+ */
+int base_fleet_set_kernel(base_fleet_t *f, base_kernel_t k);
+
+/** Check whether a kernel is compiled in and supported by this CPU. */
+uint8_t base_kernel_supported(base_kernel_t k);
+
+/** Widest kernel supported by the running CPU. */
+base_kernel_t base_kernel_best(void);
+
+/** Query current state of stream i. */
+static inline base_state_t base_fleet_state(const base_fleet_t *f,
+                                            size_t i) {
+    return (base_state_t)f->state[i];
+}
+
+/** Check if stream i has detected any fault. */
+static inline uint8_t base_fleet_faulted(const base_fleet_t *f, size_t i) {
+    return f->fault_fp[i] || f->fault_reentry[i];
+}
+
+/** Check if stream i is ready (as base_ready()). */
+static inline uint8_t base_fleet_ready(const base_fleet_t *f, size_t i) {
+    return (f->count[i] >= f->cfg.n_min) && (f->variance[i] > f->epsilon);
+}
+
+#endif /* BASELINE_FLEET_H */
@@ -0,0 +1,173 @@
+/**
+ * baseline_multi.h - Multivariate Normality Monitor
+ *
+ * One closed, total, deterministic state machine for d metrics of the
+ * same source (CPU, latency, error rate of one host), where d separate
+ * base_fsm_t would each update and score their own metric:
+ *
+ *   δₜ  = xₜ - μₜ₋₁                     (vector, before update)
+ *   μₜ  = α·xₜ + (1-α)·μₜ₋₁
+ *   Σₜ  = α·δₜδₜᵀ + (1-α)·Σₜ₋₁          (diagonal: σ²ᵢ only)
+ *   Dₜ  = √(δₜᵀ Σₜ⁻¹ δₜ)                 (Mahalanobis, Σ AFTER update)
+ *
+ * Dₜ replaces z and is compared against cfg.k. With a diagonal Σ it
+ * is the root-sum-square of the d z-scores; with the full Σ it also
+ * weighs how the metrics move together, so a step against their usual
+ * correlation (latency up while CPU drops) scores high even when each
+ * metric alone is within k σ.
+ *
+ * MODES:
+ *   BASE_MULTI_DIAG  σ²ᵢ per metric: O(d) per step
+ *   BASE_MULTI_FULL  full Σ: O(d²) update, O(d³/6) Cholesky score
+ *
+ * The update of μ and Σ is one pass over contiguous vectors, 4
+ * metrics (or matrix entries) per AVX2 instruction where available,
+ * with the operations of base_step() in the same order: in DIAG mode
+ * μᵢ and σ²ᵢ equal a base_fsm_t's for metric i exactly.
+ *
+ * A metric whose conditional variance (its Cholesky pivot; σ²ᵢ when
+ * diagonal) is at or below ε carries no information and is left out
+ * of D, as base_step() scores z = 0 below its variance floor. This
+ * also drops exact duplicates of another metric.
+ *
+ * CHOOSING k: for normal data D² follows χ² with d degrees of freedom,
+ * so the false-positive rate of k grows with d. k for P = 0.27% (the
+ * rate of k = 3 in one dimension):
+ *
+ *   d   1     2     3     4     6     8
+ *   k   3.00  3.44  3.76  4.03  4.48  4.86
+ *
+ * As with z, Σₜ already holds α·δₜδₜᵀ, so Dₜ < 1/√α: k must stay
+ * below it (3.16 for the default alpha).
+ *
+ * INVARIANTS:
+ *   INV-1: state ∈ { LEARNING, STABLE, DEVIATION }
+ *   INV-2: (state ≠ LEARNING) → (n ≥ cfg.n_min); LEARNING → STABLE
+ *          also needs every σ²ᵢ > cfg.epsilon
+ *   INV-3: (fault_fp ∨ fault_reentry) → (state == DEVIATION)
+ *   INV-4: (in_step == 0) when not executing base_multi_step
+ *   INV-5: σ²ᵢ ≥ 0; Σ symmetric in FULL mode
+ *   INV-7: n increments monotonically (nₜ = nₜ₋₁ + 1 on each non-faulted step)
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access (caller must ensure)
+ *   - Backing memory provided by the caller (no allocation here)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef BASELINE_MULTI_H
+#define BASELINE_MULTI_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "baseline.h"
+#include "baseline_fleet.h"
+
+/**
+ * Covariance kept by the monitor.
+ */
+typedef enum {
+    BASE_MULTI_DIAG = 0,  /* Per-metric variances              */
+    BASE_MULTI_FULL = 1   /* Full d × d covariance matrix      */
+} base_multi_mode_t;
+
+/**
+ * Multivariate monitor over caller-provided memory.
+ *
+ * The statistics are double-buffered: a step writes μₜ and Σₜ into the
+ * spare buffers and swaps them in only if every entry is finite, so a
+ * faulted step leaves the committed state untouched.
+ */
+typedef struct {
+    /* Configuration (immutable after init); k in Mahalanobis units */
+    base_config_t     cfg;
+    base_multi_mode_t mode;
+    uint32_t          d;           /* Number of metrics                */
+
+    /* Committed state: Sₜ = (μₜ, Σₜ, nₜ, qₜ) */
+    double           *mu;          /* Mean vector, d                   */
+    double           *cov;         /* σ² (d) or Σ row-major (d × d)    */
+    uint32_t          n;           /* Observation count (nₜ)           */
+    base_state_t      state;       /* FSM state (qₜ)                   */
+
+    /* Fault flags (sticky until reset) */
+    uint8_t           fault_fp;      /* NaN/Inf in input or state      */
+    uint8_t           fault_reentry; /* Atomicity violation detected   */
+
+    /* Atomicity guard */
+    uint8_t           in_step;     /* Reentrancy guard                 */
+
+    /* Update kernel: BASE_KERNEL_SCALAR or BASE_KERNEL_AVX2 */
+    base_kernel_t     kernel;
+
+    /* Working memory */
+    double           *mu_next;     /* Spare mean buffer                */
+    double           *cov_next;    /* Spare covariance buffer          */
+    double           *dev;         /* δₜ of the last step, d           */
+    double           *chol;        /* Cholesky factor (FULL), d × d    */
+} base_multi_t;
+
+/**
+ * Bytes of backing memory for d metrics in the given mode.
+ *
+ * @return Required size in bytes (0 if d is 0 or the size overflows)
+ */
+size_t base_multi_bytes(uint32_t d, base_multi_mode_t mode);
+
+/**
+ * Initialise the monitor over caller-provided memory.
+ *
+ * The widest update kernel this CPU supports is selected.
+ *
+ * @param m        Pointer to monitor structure
+ * @param mem      Backing memory, aligned to sizeof(double)
+ * @param mem_size Size of mem in bytes (>= base_multi_bytes(d, mode))
+ * @param d        Number of metrics (> 0)
+ * @param mode     BASE_MULTI_DIAG or BASE_MULTI_FULL
+ * @param cfg      Configuration (C1-C4 of baseline.h; k applies to D)
+ * @return         0 on success, -1 on invalid parameters
+ */
+int base_multi_init(base_multi_t *m, void *mem, size_t mem_size, uint32_t d,
+                    base_multi_mode_t mode, const base_config_t *cfg);
+
+/**
+ * Execute one atomic step with the observation vector x[0..d).
+ *
+ * This function is total: it always returns a valid base_result_t.
+ *
+ * @param m Pointer to initialised monitor
+ * @param x d observations, one per metric (must be finite)
+ * @return  r.z = Dₜ, the Mahalanobis distance; r.deviation = 0 (the
+ *          per-metric δₜ is left in m->dev until the next step)
+ *
+ * GUARANTEE: If any xᵢ or any updated statistic is not finite, state →
+ *            DEVIATION, fault flag set, n, μ and Σ unchanged.
+ */
+base_result_t base_multi_step(base_multi_t *m, const double *x);
+
+/**
+ * Choose the update kernel.
+ *
+ * @return 0 on success, -1 if k is not SCALAR or a supported AVX2
+ */
+int base_multi_set_kernel(base_multi_t *m, base_kernel_t k);
+
+/**
+ * Reset to initial state (re-enter LEARNING).
+ * Preserves configuration and memory, clears statistics and faults.
+ */
+void base_multi_reset(base_multi_t *m);
+
+/** Query current FSM state. */
+static inline base_state_t base_multi_state(const base_multi_t *m) {
+    return m->state;
+}
+
+/** Check if any fault has been detected. */
+static inline uint8_t base_multi_faulted(const base_multi_t *m) {
+    return m->fault_fp || m->fault_reentry;
+}
+
+#endif /* BASELINE_MULTI_H */
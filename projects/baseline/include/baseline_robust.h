@@ -0,0 +1,198 @@
+/**
+ * baseline_robust.h - Sliding-Window Robust Normality Monitor
+ *
+ * The same closed, total, deterministic state machine as baseline.h,
+ * driven by the median and MAD of the last w observations instead of
+ * the EWMA mean and variance.
+ *
+ * The EWMA variance is a sum of squares: one latency spike of size M
+ * inflates σ² by α·M², masking real deviations for about 1/α steps,
+ * and heavy tails keep σ permanently wide. The median and the median
+ * absolute deviation ignore up to half the window:
+ *
+ *   m   = median(x₁ … x_w)
+ *   MAD = median(|x₁ - m| … |x_w - m|)
+ *   σ̂   = 1.4826 · MAD           (σ for normal data)
+ *   z   = |xₜ - mₜ₋₁| / σ̂ₜ
+ *
+ * THE CORE INSIGHT:
+ *   Re-sorting the window costs O(w log w) per sample. An indexable
+ *   skip list keeps the window sorted under one insertion and one
+ *   eviction per sample, O(log w) each, and finds the r-th smallest
+ *   in O(log w). The median is one or two such selections. The
+ *   deviations below m and above m are two sorted runs of the same
+ *   list, so the MAD is the k-th smallest of two sorted sequences: a
+ *   binary search of O(log w) selections.
+ *
+ *   Node heights are drawn at insertion from a seeded generator, so
+ *   they are independent of the values whatever the input's pattern
+ *   and the list stays balanced in expectation. The generator is
+ *   reseeded on reset: the same input gives the same steps.
+ *
+ * EXPECTED COST PER STEP (over the heights, for any input):
+ *   insert + evict + median   O(log w)
+ *   MAD                       O(log² w)
+ *
+ * CONTRACTS:
+ *   1. EXACTNESS:   median, mad and sigma equal those of the sorted
+ *                   window, computed by the same operations.
+ *   2. ROBUSTNESS:  Fewer than w/2 outliers, of any size, move m and
+ *                   MAD no further than the range of the other samples.
+ *   3. FSM:         States, transitions and faults exactly as
+ *                   base_step(), with σ̂ for σ and σ̂² for σ².
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access (caller must ensure)
+ *   - Backing memory provided by the caller (no allocation here)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef BASELINE_ROBUST_H
+#define BASELINE_ROBUST_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "baseline.h"
+
+#define BASE_ROBUST_MAX_LEVELS 16  /* 4¹⁶ > any uint32_t window       */
+#define BASE_ROBUST_MAD_SCALE  1.482602218505602  /* 1 / Φ⁻¹(3/4)     */
+
+/**
+ * Configuration parameters (immutable after init).
+ *
+ * CONSTRAINTS:
+ *   R1: window >= 3
+ *   R2: epsilon > 0
+ *   R3: k > 0
+ *   R4: n_min >= window (a full window before STABLE)
+ */
+typedef struct {
+    uint32_t window;     /* Observations in the median window (w)      */
+    double   epsilon;    /* σ̂² floor for safe z-score computation      */
+    double   k;          /* Deviation threshold (z-score units)        */
+    uint32_t n_min;      /* Minimum observations before STABLE         */
+} base_robust_config_t;
+
+/**
+ * Robust monitor over a window of caller-provided memory.
+ *
+ * INVARIANTS:
+ *   INV-1: state ∈ { LEARNING, STABLE, DEVIATION }
+ *   INV-3: (fault_fp ∨ fault_reentry) → (state == DEVIATION)
+ *   INV-4: (in_step == 0) when not executing base_robust_step
+ *   INV-5: mad ≥ 0
+ *   INV-6: sigma == BASE_ROBUST_MAD_SCALE · mad
+ *   INV-7: n increments monotonically (nₜ = nₜ₋₁ + 1 on each non-faulted step)
+ *   INV-8: fill == min(n, window); the list holds exactly the last fill
+ *          non-faulted observations
+ */
+typedef struct {
+    /* Configuration (immutable after init) */
+    base_robust_config_t cfg;
+
+    /* Statistics of the current window */
+    double       median;        /* Window median (mₜ)                   */
+    double       mad;           /* Median absolute deviation            */
+    double       sigma;         /* Cached: 1.4826 · mad (σ̂ₜ)            */
+    uint32_t     n;             /* Observation count (nₜ)               */
+    base_state_t state;         /* FSM state (qₜ)                       */
+
+    /* Fault flags (sticky until reset) */
+    uint8_t      fault_fp;      /* NaN/Inf detected in input or state   */
+    uint8_t      fault_reentry; /* Atomicity violation detected         */
+
+    /* Atomicity guard */
+    uint8_t      in_step;       /* Reentrancy guard                     */
+
+    /* Indexable skip list: node i + 1 holds value[i], node 0 is head */
+    uint32_t     fill;          /* Observations in the window           */
+    uint32_t     slot;          /* Slot the next observation replaces   */
+    uint32_t     levels;        /* Levels in use: 1 + ⌊log₄ w⌋          */
+    uint64_t     rng;           /* Height generator state               */
+    double      *value;         /* Window, in arrival order (ring)      */
+    uint32_t    *next;          /* Successor per node and level, 0 = end */
+    uint32_t    *width;         /* Ranks skipped by each link           */
+    uint8_t     *height;        /* Levels of each node                  */
+} base_robust_t;
+
+/**
+ * Default configuration.
+ *
+ * window  = 64    About three EWMA lifetimes of the default alpha
+ * epsilon = 1e-9  σ̂² floor for numerical safety
+ * k       = 3.0   Three-sigma deviation threshold
+ * n_min   = 64    One full window
+ */
+static const base_robust_config_t BASE_ROBUST_DEFAULT_CONFIG = {
+    .window  = 64,
+    .epsilon = 1e-9,
+    .k       = 3.0,
+    .n_min   = 64
+};
+
+/**
+ * Bytes of backing memory required for a window of w observations.
+ *
+ * @return Required size in bytes (0 if w < 3 or the size overflows)
+ */
+size_t base_robust_bytes(uint32_t window);
+
+/**
+ * Initialise the robust monitor over caller-provided memory.
+ *
+ * @param r        Pointer to monitor structure
+ * @param mem      Backing memory, aligned to sizeof(double)
+ * @param mem_size Size of mem in bytes (>= base_robust_bytes(window))
+ * @param cfg      Configuration parameters (R1-R4, copied into r)
+ * @return         0 on success, -1 on invalid parameters
+ *
+ * POSTCONDITION: r is in LEARNING state with an empty window.
+ */
+int base_robust_init(base_robust_t *r, void *mem, size_t mem_size,
+                     const base_robust_config_t *cfg);
+
+/**
+ * Execute one atomic step of the robust monitor.
+ *
+ * This function is total: it always returns a valid base_result_t.
+ *
+ * @param r Pointer to initialised monitor
+ * @param x Observation value (must be finite)
+ * @return  Result containing z-score and new state
+ *
+ * GUARANTEE: If fault detected, state → DEVIATION, fault flag set, n
+ *            and the window unchanged.
+ *
+ * UPDATE SEQUENCE:
+ *   1. deviation = xₜ - mₜ₋₁           (using median BEFORE update)
+ *   2. evict xₜ₋w, insert xₜ            (window slides)
+ *   3. mₜ, MADₜ of the window           (update median and MAD)
+ *   4. σ̂ₜ = 1.4826 · MADₜ              (update sigma)
+ *   5. z = |deviation| / σ̂ₜ            (using sigma AFTER update)
+ */
+base_result_t base_robust_step(base_robust_t *r, double x);
+
+/**
+ * Reset to initial state (re-enter LEARNING, empty window).
+ * Preserves configuration and memory, clears statistics and faults.
+ */
+void base_robust_reset(base_robust_t *r);
+
+/** Query current FSM state. */
+static inline base_state_t base_robust_state(const base_robust_t *r) {
+    return r->state;
+}
+
+/** Check if any fault has been detected. */
+static inline uint8_t base_robust_faulted(const base_robust_t *r) {
+    return r->fault_fp || r->fault_reentry;
+}
+
+/** Check if ready: (n >= n_min) && (σ̂² > epsilon). */
+static inline uint8_t base_robust_ready(const base_robust_t *r) {
+    return (r->n >= r->cfg.n_min) && (r->sigma * r->sigma > r->cfg.epsilon);
+}
+
+#endif /* BASELINE_ROBUST_H */
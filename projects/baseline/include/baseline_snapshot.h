@@ -0,0 +1,110 @@
+/**
+ * baseline_snapshot.h - Persistent Fleet Snapshots for Warm Restart
+ *
+ * A restarted monitor sits in LEARNING for n_min samples per stream,
+ * blind to anomalies. A snapshot carries every stream's closed state
+ * (μ, σ², σ, n, state, faults) across the restart, so the fleet
+ * resumes where it stopped.
+ *
+ * FORMAT (version 1, native byte order):
+ *
+ *   offset  size  field
+ *        0     4  magic "BSNP" (also detects foreign byte order)
+ *        4     2  version
+ *        6     1  value kind: 0 double, 1 float32, 2 Q16.16
+ *        7     1  sizeof(base_value_t)
+ *        8     8  n, number of streams
+ *       16    24  alpha, epsilon, k (double)
+ *       40     4  n_min
+ *       44     4  CRC-32C of the payload
+ *       48     8  payload bytes
+ *       56     4  CRC-32C of bytes 0..55
+ *       60     4  reserved, zero
+ *       64        payload: mu[n], variance[n], sigma[n], count[n],
+ *                 state[n], fault_fp[n], fault_reentry[n], packed
+ *
+ * The whole snapshot is one buffer: save into memory and hand it to a
+ * single write(2), or mmap(2) a file and load straight from the map.
+ *
+ * CONTRACTS:
+ *   1. ROUND TRIP:  load(save(f)) restores every stream bit for bit,
+ *                   sticky faults included.
+ *   2. INTEGRITY:   A truncated, corrupted, foreign or mismatched
+ *                   snapshot is rejected and the fleet left untouched.
+ *   3. INVARIANTS:  A snapshot whose streams break INV-1, INV-2, INV-3,
+ *                   INV-5 or INV-6 is rejected, even with a valid
+ *                   checksum. A quiet stream whose σ² has decayed
+ *                   below ε after leaving LEARNING is valid (INV-2).
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to the fleet (caller must ensure)
+ *   - Same architecture and column precision for save and load
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef BASELINE_SNAPSHOT_H
+#define BASELINE_SNAPSHOT_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "baseline_fleet.h"
+
+#define BASE_SNAPSHOT_MAGIC   0x504E5342u  /* "BSNP" in memory order */
+#define BASE_SNAPSHOT_VERSION 1u
+#define BASE_SNAPSHOT_HEADER  64u          /* Header bytes           */
+
+/**
+ * Snapshot error codes.
+ */
+typedef enum {
+    BASE_SNAP_OK         =  0,  /* Success                                */
+    BASE_SNAP_ERR_NULL   = -1,  /* NULL pointer passed                    */
+    BASE_SNAP_ERR_SIZE   = -2,  /* Buffer too small or truncated          */
+    BASE_SNAP_ERR_FORMAT = -3,  /* Bad magic, version, precision or order */
+    BASE_SNAP_ERR_CRC    = -4,  /* Checksum mismatch: corrupted           */
+    BASE_SNAP_ERR_CONFIG = -5,  /* Stream count or configuration differ   */
+    BASE_SNAP_ERR_STATE  = -6,  /* A stream breaks a state invariant      */
+    BASE_SNAP_ERR_BUSY   = -7   /* Fleet is mid-step                      */
+} base_snap_error_t;
+
+/**
+ * Bytes of a snapshot of n streams, header included.
+ *
+ * @return Required size in bytes (0 if n is 0 or the size overflows)
+ */
+size_t base_snapshot_bytes(size_t n);
+
+/**
+ * Write a snapshot of every stream of f into buf.
+ *
+ * @param f        Pointer to initialised fleet, not mid-step
+ * @param buf      Destination, at least base_snapshot_bytes(f->n)
+ * @param buf_size Size of buf in bytes
+ * @return         BASE_SNAP_OK, or an error with buf unspecified
+ */
+base_snap_error_t base_snapshot_save(const base_fleet_t *f, void *buf,
+                                     size_t buf_size);
+
+/**
+ * Restore every stream of f from a snapshot.
+ *
+ * f must have been initialised with the stream count and configuration
+ * the snapshot was taken with; its kernel choice is kept. The snapshot
+ * is checked in full before any stream is written.
+ *
+ * @param f    Pointer to initialised fleet, not mid-step
+ * @param buf  Snapshot, e.g. a file read or mapped into memory
+ * @param size Bytes available at buf
+ * @return     BASE_SNAP_OK, or an error with f unchanged
+ */
+base_snap_error_t base_snapshot_load(base_fleet_t *f, const void *buf,
+                                     size_t size);
+
+/**
+ * CRC-32C (Castagnoli) of len bytes, continuing from crc (0 to start).
+ */
+uint32_t base_crc32c(uint32_t crc, const void *data, size_t len);
+
+#endif /* BASELINE_SNAPSHOT_H */
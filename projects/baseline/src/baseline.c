@@ -14,6 +14,7 @@
 #include <math.h>
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 /*---------------------------------------------------------------------------
  * Helper Functions
@@ -25,6 +26,80 @@ static inline uint8_t is_finite(double x) { return isfinite(x) != 0; }
 /** Absolute value (avoid dependency on fabs for teaching clarity) */
 static inline double abs_d(double x) { return (x < 0.0) ? -x : x; }
 
+/** 2^(j/64), j = 0..63, correctly rounded */
+static const double exp2_table[64] = {
+  1.0, 1.0108892860517005, 1.0218971486541166, 1.0330248790212284,
+  1.0442737824274138, 1.0556451783605572, 1.0671404006768237, 1.0787607977571199,
+  1.0905077326652577, 1.1023825833078409, 1.1143867425958924, 1.1265216186082418,
+  1.1387886347566916, 1.1511892299529827, 1.1637248587775775, 1.1763969916502812,
+  1.189207115002721, 1.2021567314527031, 1.215247359980469, 1.22848053610687,
+  1.241857812073484, 1.2553807570246911, 1.2690509571917332, 1.2828700160787783,
+  1.2968395546510096, 1.3109612115247644, 1.3252366431597413, 1.3396675240533029,
+  1.3542555469368927, 1.3690024229745905, 1.383909881963832, 1.3989796725383112,
+  1.4142135623730951, 1.42961333839197, 1.4451808069770467, 1.460917794180647,
+  1.4768261459394993, 1.4929077282912648, 1.5091644275934228, 1.5255981507445384,
+  1.5422108254079407, 1.5590044002378369, 1.5759808451078865, 1.593142151342267,
+  1.6104903319492543, 1.6280274218573478, 1.6457554781539649, 1.6636765803267364,
+  1.681792830507429, 1.7001063537185235, 1.7186192981224779, 1.7373338352737062,
+  1.7562521603732995, 1.7753764925265212, 1.7947090750031072, 1.8142521755003989,
+  1.8340080864093424, 1.8539791250833855, 1.8741676341103, 1.8945759815869656,
+  1.9152065613971474, 1.9360617934922943, 1.9571441241754002, 1.9784560263879509
+};
+
+/** (ln 2)ⁱ / i!, i = 1..5: 2^r = 1 + r·(c₁ + r·(c₂ + …)) for |r| ≤ 1/128 */
+#define EXP2_C1 0.69314718055994529
+#define EXP2_C2 0.24022650695910072
+#define EXP2_C3 0.055504108664821583
+#define EXP2_C4 0.0096181291076284769
+#define EXP2_C5 0.0013333558146428443
+
+/** 1.5·2⁵²: adding it rounds s to an integer held in the low bits */
+#define EXP2_SHIFT 6755399441055744.0
+
+/**
+ * λ = 2^y for y = (dt/T)·log₂(1-α) ≤ 0, and 1 - λ without cancellation.
+ *
+ * y·64 = n + 64·r with integer n and |r| ≤ 1/128; n = 64·q + j with
+ * j ∈ [0, 64). Then 2^y = 2^(j/64) · 2^q · 2^r: a table entry, q added
+ * to its exponent bits, and a degree-5 polynomial whose truncation
+ * error is below 4e-17. No conversion between integer and double.
+ */
+static double decay(double y, double *weight) {
+  double s, kd, r, r2, p, scale;
+  uint64_t ki, bits;
+  unsigned j;
+
+  if (!(y > -1022.0)) {
+    *weight = 1.0; /* Older than the EMA can remember */
+    return 0.0;
+  }
+
+  s = y * 64.0;
+  kd = s + EXP2_SHIFT;
+  memcpy(&ki, &kd, sizeof(ki)); /* Low bits: n, two's complement */
+  kd -= EXP2_SHIFT;             /* n as a double                  */
+  r = (s - kd) * (1.0 / 64.0);
+
+  /* p = 2^r - 1, in Estrin's scheme: three short chains, not one long */
+  r2 = r * r;
+  p = r * (EXP2_C1 + r * EXP2_C2) +
+      (r2 * r) * (EXP2_C3 + r * EXP2_C4 + r2 * EXP2_C5);
+
+  if (kd == 0.0) {
+    *weight = -p;
+    return 1.0 + p;
+  }
+
+  /* 2^(j/64)·2^q: (n - j) << 46 is q << 52, the exponent field */
+  j = (unsigned)(ki & 63u);
+  memcpy(&bits, &exp2_table[j], sizeof(bits));
+  bits += (ki - j) << 46;
+  memcpy(&scale, &bits, sizeof(scale));
+  p = scale + scale * p;
+  *weight = 1.0 - p;
+  return p;
+}
+
 /*---------------------------------------------------------------------------
  * Public API
  *---------------------------------------------------------------------------*/
@@ -74,11 +149,21 @@ int base_init(base_fsm_t *b, const base_config_t *cfg) {
 
   /* Clear atomicity guard */
   b->in_step = 0;
+  b->sigma_stale = 0;
+
+  /* Timed steps: no observation yet */
+  b->t_last = 0;
+  b->log2_keep = log2(1.0 - cfg->alpha);
 
   return 0;
 }
 
-base_result_t base_step(base_fsm_t *b, double x) {
+/**
+ * base_step() with the weight of xₜ given: alpha = α, keep = 1 - α for
+ * a regular step, as computed by decay() for a timed one.
+ */
+static base_result_t step_weighted(base_fsm_t *b, double x, double alpha,
+                                   double keep) {
   base_result_t result = {0};
 
   /*-----------------------------------------------------------------------
@@ -122,17 +207,15 @@ base_result_t base_step(base_fsm_t *b, double x) {
    *-----------------------------------------------------------------------*/
 
   double mu_old = b->mu;
-  double alpha = b->cfg.alpha;
 
   /* Step 1: deviation using μₜ₋₁ */
   double deviation = x - mu_old;
 
   /* Step 2: update mean */
-  double mu_new = alpha * x + (1.0 - alpha) * mu_old;
+  double mu_new = alpha * x + keep * mu_old;
 
   /* Step 3: update variance */
-  double var_new =
-      alpha * (deviation * deviation) + (1.0 - alpha) * b->variance;
+  double var_new = alpha * (deviation * deviation) + keep * b->variance;
 
   /* Step 4: update sigma (cached √variance) */
   double sigma_new = sqrt(var_new);
@@ -151,6 +234,7 @@ base_result_t base_step(base_fsm_t *b, double x) {
   b->mu = mu_new;
   b->variance = var_new;
   b->sigma = sigma_new;
+  b->sigma_stale = 0;
   b->n += 1; /* INV-7: monotonic increment on success */
 
   /* Step 5: compute z-score */
@@ -209,13 +293,256 @@ base_result_t base_step(base_fsm_t *b, double x) {
   return result;
 }
 
+base_result_t base_step(base_fsm_t *b, double x) {
+  return step_weighted(b, x, b->cfg.alpha, 1.0 - b->cfg.alpha);
+}
+
+base_result_t base_step_at(base_fsm_t *b, double x, uint64_t t, uint64_t T) {
+  base_result_t result;
+  double alpha = b->cfg.alpha;
+  double keep = 1.0 - alpha;
+  uint32_t n_before = b->n;
+
+  /* Irregular spacing: first step, T == 0 and dt == T stay regular */
+  if (b->n != 0 && T != 0 && t - b->t_last != T) {
+    double periods = (t > b->t_last) ? (double)(t - b->t_last) / (double)T
+                                     : 0.0;
+    keep = decay(periods * b->log2_keep, &alpha);
+  }
+
+  result = step_weighted(b, x, alpha, keep);
+  if (b->n != n_before && (n_before == 0 || t > b->t_last)) {
+    b->t_last = t; /* Committed: INV-8; a late sample never winds it back */
+  }
+  return result;
+}
+
+size_t base_step_batch(base_fsm_t *b, const double *x, size_t n,
+                       double *z_out, uint8_t *state_out,
+                       uint64_t *dev_mask) {
+  /* Working copy of the closed state: stays in registers */
+  double mu = b->mu;
+  double variance = b->variance;
+  double sigma = b->sigma;
+  uint8_t sigma_stale = b->sigma_stale;
+  uint32_t count = b->n;
+  base_state_t state = b->state;
+  uint8_t fault_fp = b->fault_fp;
+
+  const double alpha = b->cfg.alpha;
+  const double keep = 1.0 - alpha;
+  const double epsilon = b->cfg.epsilon;
+  const double k = b->cfg.k;
+  const uint32_t n_min = b->cfg.n_min;
+
+  uint64_t word = 0;
+  size_t deviations = 0;
+  size_t i;
+
+  /* Reentrancy: every step of the loop would fault (INV-3, INV-4) */
+  if (b->in_step) {
+    b->fault_reentry = 1;
+    b->state = BASE_DEVIATION;
+    for (i = 0; i < n; i++) {
+      if (z_out) {
+        z_out[i] = 0.0;
+      }
+      if (state_out) {
+        state_out[i] = (uint8_t)BASE_DEVIATION;
+      }
+      if (dev_mask && (i & 63u) == 0) {
+        dev_mask[i >> 6] = (n - i >= 64u) ? ~0ULL : (1ULL << (n - i)) - 1u;
+      }
+    }
+    return n;
+  }
+  b->in_step = 1;
+
+  for (i = 0; i < n; i++) {
+    /*
+     * UPDATE SEQUENCE steps 1-5, the same operations as base_step().
+     * Straight-line on purpose: only μ and σ² carry from one step to
+     * the next, so √ and ÷ overlap with the following observation.
+     */
+    double xi = x[i];
+    double deviation = xi - mu;
+    double mu_new = alpha * xi + keep * mu;
+    double var_new = alpha * (deviation * deviation) + keep * variance;
+    double sigma_new = sqrt(var_new);
+    double z = fabs(deviation) / sigma_new;
+
+    /* Non-finite xₜ always makes μₜ non-finite; σ² ≥ 0 keeps σ finite */
+    if (!is_finite(mu_new) || !is_finite(var_new)) {
+      /* Fault: DEVIATION, statistics and n unchanged */
+      fault_fp = 1;
+      state = BASE_DEVIATION;
+      z = 0.0;
+    } else {
+      mu = mu_new;
+      variance = var_new;
+      sigma = sigma_new;
+      sigma_stale = 0;
+      count += 1;
+
+      /* Variance floor: no meaningful z-score */
+      if (variance <= epsilon) {
+        z = 0.0;
+      }
+
+      /* FSM transitions, as in base_step() */
+      if (state == BASE_LEARNING) {
+        if (count >= n_min && variance > epsilon) {
+          state = BASE_STABLE;
+        }
+      } else if (state == BASE_STABLE) {
+        if (z > k) {
+          state = BASE_DEVIATION;
+        }
+      } else if (state == BASE_DEVIATION) {
+        if (!fault_fp && !b->fault_reentry && z <= k) {
+          state = BASE_STABLE;
+        }
+      } else {
+        fault_fp = 1;
+        state = BASE_DEVIATION;
+      }
+    }
+
+    if (z_out) {
+      z_out[i] = z;
+    }
+    if (state_out) {
+      state_out[i] = (uint8_t)state;
+    }
+    if (state == BASE_DEVIATION) {
+      deviations++;
+      word |= 1ULL << (i & 63u);
+    }
+    if (dev_mask && ((i & 63u) == 63u || i + 1u == n)) {
+      dev_mask[i >> 6] = word;
+      word = 0;
+    }
+  }
+
+  /* Commit */
+  b->mu = mu;
+  b->variance = variance;
+  b->sigma = sigma;
+  b->sigma_stale = sigma_stale;
+  b->n = count;
+  b->state = state;
+  b->fault_fp = fault_fp;
+  b->in_step = 0;
+  return deviations;
+}
+
+base_result_t base_step_fast(base_fsm_t *b, double x) {
+  base_result_t result = {0};
+
+  result.z = NAN; /* Not computed: see base_zscore() */
+
+  /* Reentrancy check — CONTRACT enforcement (INV-4) */
+  if (b->in_step) {
+    b->fault_reentry = 1;
+    b->state = BASE_DEVIATION; /* INV-3: fault → DEVIATION */
+    result.state = b->state;
+    result.is_deviation = 1;
+    return result;
+  }
+  b->in_step = 1;
+
+  /* UPDATE SEQUENCE steps 1-3, as base_step(); steps 4-5 deferred */
+  double alpha = b->cfg.alpha;
+  double deviation = x - b->mu;
+  double mu_new = alpha * x + (1.0 - alpha) * b->mu;
+  double var_new =
+      alpha * (deviation * deviation) + (1.0 - alpha) * b->variance;
+
+  /*
+   * Non-finite xₜ always makes μₜ non-finite, and σ² ≥ 0 keeps √σ²
+   * finite, so this is base_step()'s input and numerical fault check.
+   */
+  if (!is_finite(mu_new) || !is_finite(var_new)) {
+    b->fault_fp = 1;
+    b->state = BASE_DEVIATION; /* INV-3: fault → DEVIATION */
+    result.state = b->state;
+    result.is_deviation = 1;
+    b->in_step = 0;
+    return result;
+  }
+
+  /* Commit; σ follows on demand (INV-6) */
+  b->mu = mu_new;
+  b->variance = var_new;
+  b->sigma_stale = 1;
+  b->n += 1; /* INV-7: monotonic increment on success */
+  result.deviation = deviation;
+
+  /*
+   * z > k ⇔ |deviation| / σ > k ⇔ deviation² > k²·σ²  (σ > 0, k > 0)
+   * Below the variance floor z is 0, never above k.
+   */
+  uint8_t above_k = (var_new > b->cfg.epsilon) &&
+                    (deviation * deviation > b->cfg.k * b->cfg.k * var_new);
+
+  /* FSM Transitions, as base_step() */
+  switch (b->state) {
+  case BASE_LEARNING:
+    if ((b->n >= b->cfg.n_min) && (b->variance > b->cfg.epsilon)) {
+      b->state = BASE_STABLE;
+    }
+    break;
+
+  case BASE_STABLE:
+    if (above_k) {
+      b->state = BASE_DEVIATION;
+    }
+    break;
+
+  case BASE_DEVIATION:
+    if (!base_faulted(b) && !above_k) {
+      b->state = BASE_STABLE;
+    }
+    break;
+
+  default:
+    b->fault_fp = 1;
+    b->state = BASE_DEVIATION;
+    break;
+  }
+
+  result.state = b->state;
+  result.is_deviation = (b->state == BASE_DEVIATION) ? 1 : 0;
+
+  b->in_step = 0;
+  return result;
+}
+
+double base_sigma(base_fsm_t *b) {
+  if (b->sigma_stale) {
+    b->sigma = sqrt(b->variance);
+    b->sigma_stale = 0;
+  }
+  return b->sigma;
+}
+
+double base_zscore(base_fsm_t *b, double deviation) {
+  /* Variance floor: cannot compute meaningful z-score */
+  if (b->variance <= b->cfg.epsilon) {
+    return 0.0;
+  }
+  return abs_d(deviation) / base_sigma(b);
+}
+
 void base_reset(base_fsm_t *b) {
   /* Preserve configuration */
   /* Clear statistics */
   b->mu = 0.0;
   b->variance = 0.0;
   b->sigma = 0.0;
+  b->sigma_stale = 0;
   b->n = 0;
+  b->t_last = 0;
 
   /* Reset state */
   b->state = BASE_LEARNING;
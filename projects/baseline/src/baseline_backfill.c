@@ -0,0 +1,344 @@
+/**
+ * baseline_backfill.c - Multi-Threaded Historical Backfill Implementation
+ *
+ * Three phases over T contiguous chunks:
+ *
+ *   1. summarise (parallel)  each chunk from g = its first sample:
+ *                            m, v₀, v₁, v₂, (1-α)ᴸ, committed count,
+ *                            first non-finite sample
+ *   2. scan (serial, O(T))   true μ₀, σ²₀ and n₀ of every chunk
+ *   3. replay (parallel)     each chunk from its start, exactly as
+ *                            base_step_batch() would, writing z and
+ *                            noting first ready step and z > k counts
+ *
+ * A final O(T) walk turns the per-chunk notes into the deviation count
+ * and the final state.
+ *
+ * Phase 1 runs five independent recurrences per sample, which overlap;
+ * each pass costs about one serial base_step_batch() pass, so T cores
+ * finish in roughly 2/T of the serial time.
+ *
+ * See: baseline_backfill.h for the algebra
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#define _POSIX_C_SOURCE 200809L /* For sysconf */
+
+#include "baseline_backfill.h"
+#include <float.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <unistd.h>
+
+#define MAX_CHUNKS 64
+
+/** (1-α)^t below which the start of a chunk no longer matters: 2⁻¹⁰⁴ */
+#define K_NEGLIGIBLE (DBL_EPSILON * DBL_EPSILON / 4.0)
+
+/** One thread's share of the series */
+typedef struct {
+  const base_config_t *cfg;
+  const double *x;
+  double *z_out;
+  size_t lo, hi;        /* Samples [lo, hi)                            */
+
+  /* Phase 1: summary, started from μ = g, σ² = 0 */
+  double g;             /* Start the chunk was summarised from         */
+  double m;             /* μ at the end                                */
+  double v0, v1, v2;    /* σ² at the end: v₀ + v₁·δ + v₂·δ²            */
+  double p;             /* (1-α)^count                                 */
+  uint32_t count;       /* Committed (finite) samples                  */
+  size_t first_fault;   /* First non-finite sample, or hi              */
+
+  /* Phase 2: true start */
+  double mu0, var0;
+  uint32_t n0;
+
+  /* Phase 3: replay */
+  double mu, var;       /* μ and σ² at the end                         */
+  size_t first_ready;   /* First ready step before first_fault, or hi  */
+  size_t zk_all;        /* Steps in [lo, first_fault) with z > k       */
+  size_t zk_ready;      /* Steps in (first_ready, first_fault), z > k  */
+  uint8_t zk_last;      /* z > k on the last step                      */
+  uint8_t overflow;     /* A finite sample overflowed μ or σ²          */
+} chunk_t;
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Check if value is finite (not NaN, not Inf) */
+static inline uint8_t is_finite(double x) { return isfinite(x) != 0; }
+
+/**
+ * Phase 1: summarise a chunk from μ = g, σ² = 0.
+ *
+ * With K = (1-α)^t and δ = μ₀ - g, the true deviation is d - K·δ, so
+ * its square splits into d², -2·d·K·δ and K²·δ²: one recurrence each.
+ *
+ * Once K < 2⁻¹⁰⁴ the δ terms are below the rounding of the others and
+ * are dropped. Otherwise K, v₁ and v₂ decay into subnormals, where
+ * (1-α)·x rounds back to x and every multiply takes the slow path.
+ */
+static void *summarise(void *arg) {
+  chunk_t *c = (chunk_t *)arg;
+  const double alpha = c->cfg->alpha;
+  const double keep = 1.0 - alpha;
+  double m, v0 = 0.0, v1 = 0.0, v2 = 0.0, k = 1.0;
+  uint32_t count = 0;
+  size_t i;
+
+  c->first_fault = c->hi;
+  c->g = 0.0;
+  for (i = c->lo; i < c->hi; i++) {
+    if (is_finite(c->x[i])) {
+      c->g = c->x[i];
+      break;
+    }
+  }
+
+  m = c->g;
+  for (i = c->lo; i < c->hi; i++) {
+    double xi = c->x[i];
+    double d;
+
+    /* Faulted samples leave μ, σ² and n unchanged: the identity map */
+    if (!is_finite(xi)) {
+      if (c->first_fault == c->hi) {
+        c->first_fault = i;
+      }
+      continue;
+    }
+
+    d = xi - m;
+    m = alpha * xi + keep * m;
+    v0 = alpha * (d * d) + keep * v0;
+    v1 = alpha * (-2.0 * d * k) + keep * v1;
+    v2 = alpha * (k * k) + keep * v2;
+    k *= keep;
+    if (k < K_NEGLIGIBLE) {
+      k = 0.0;
+      v1 = 0.0;
+      v2 = 0.0;
+    }
+    count++;
+  }
+
+  c->m = m;
+  c->v0 = v0;
+  c->v1 = v1;
+  c->v2 = v2;
+  c->p = pow(keep, (double)count);
+  c->count = count;
+  return NULL;
+}
+
+/**
+ * Phase 3: replay a chunk from its true start, as base_step_batch().
+ */
+static void *replay(void *arg) {
+  chunk_t *c = (chunk_t *)arg;
+  const double alpha = c->cfg->alpha;
+  const double keep = 1.0 - alpha;
+  const double epsilon = c->cfg->epsilon;
+  const double k = c->cfg->k;
+  const uint32_t n_min = c->cfg->n_min;
+  double mu = c->mu0;
+  double variance = c->var0;
+  uint32_t count = c->n0;
+  size_t i;
+
+  c->first_ready = c->hi;
+  c->zk_all = 0;
+  c->zk_ready = 0;
+  c->zk_last = 0;
+  c->overflow = 0;
+
+  for (i = c->lo; i < c->hi; i++) {
+    /* UPDATE SEQUENCE steps 1-5, the same operations as base_step() */
+    double xi = c->x[i];
+    double deviation = xi - mu;
+    double mu_new = alpha * xi + keep * mu;
+    double var_new = alpha * (deviation * deviation) + keep * variance;
+    double z = fabs(deviation) / sqrt(var_new);
+    uint8_t zk = 0;
+
+    if (!is_finite(mu_new) || !is_finite(var_new)) {
+      /* Fault: statistics and n unchanged */
+      c->overflow |= is_finite(xi);
+      z = 0.0;
+    } else {
+      mu = mu_new;
+      variance = var_new;
+      count += 1;
+
+      /* Variance floor: no meaningful z-score */
+      if (variance <= epsilon) {
+        z = 0.0;
+      }
+      zk = (z > k);
+
+      if (i < c->first_fault) {
+        c->zk_all += zk;
+        if (c->first_ready == c->hi) {
+          if (count >= n_min && variance > epsilon) {
+            c->first_ready = i;
+          }
+        } else {
+          c->zk_ready += zk;
+        }
+      }
+    }
+    c->zk_last = zk;
+
+    if (c->z_out) {
+      c->z_out[i] = z;
+    }
+  }
+
+  c->mu = mu;
+  c->var = variance;
+  return NULL;
+}
+
+/**
+ * Run fn on every chunk, chunk 0 on the calling thread. A chunk whose
+ * thread cannot be started runs on the calling thread instead.
+ */
+static void run_chunks(chunk_t *chunks, size_t t, void *(*fn)(void *)) {
+  pthread_t tid[MAX_CHUNKS];
+  uint8_t started[MAX_CHUNKS];
+  size_t c;
+
+  for (c = 1; c < t; c++) {
+    started[c] = pthread_create(&tid[c], NULL, fn, &chunks[c]) == 0;
+    if (!started[c]) {
+      fn(&chunks[c]);
+    }
+  }
+  fn(&chunks[0]);
+  for (c = 1; c < t; c++) {
+    if (started[c]) {
+      pthread_join(tid[c], NULL);
+    }
+  }
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t base_backfill(base_fsm_t *b, const double *x, size_t n,
+                     double *z_out, unsigned threads) {
+  chunk_t chunks[MAX_CHUNKS];
+  size_t t, c, deviations = 0;
+  uint8_t faulted, left_learning, fault_new = 0;
+  base_state_t state;
+
+  if (threads == 0) {
+    long online = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (online > 0) ? (unsigned)online : 1u;
+  }
+  t = n / BASE_BACKFILL_MIN_CHUNK;
+  if (t > threads) {
+    t = threads;
+  }
+  if (t > MAX_CHUNKS) {
+    t = MAX_CHUNKS;
+  }
+
+  /* FALLBACK: nothing to split, a reentrant call or an invalid state */
+  if (t <= 1 || b->in_step || (unsigned)b->state > (unsigned)BASE_DEVIATION) {
+    return base_step_batch(b, x, n, z_out, NULL, NULL);
+  }
+  b->in_step = 1;
+
+  for (c = 0; c < t; c++) {
+    chunks[c].cfg = &b->cfg;
+    chunks[c].x = x;
+    chunks[c].z_out = z_out;
+    chunks[c].lo = n / t * c;
+    chunks[c].hi = (c + 1 == t) ? n : n / t * (c + 1);
+  }
+
+  /* Phase 1 */
+  run_chunks(chunks, t, summarise);
+
+  /* Phase 2: each chunk's start is the previous chunk's end */
+  chunks[0].mu0 = b->mu;
+  chunks[0].var0 = b->variance;
+  chunks[0].n0 = b->n;
+  for (c = 0; c + 1 < t; c++) {
+    chunk_t *p = &chunks[c];
+    double delta = p->mu0 - p->g;
+    double var = p->v0 + p->v1 * delta + p->v2 * (delta * delta) +
+                 p->p * p->var0;
+
+    chunks[c + 1].mu0 = p->m + p->p * delta;
+    chunks[c + 1].var0 = (var > 0.0) ? var : 0.0; /* INV-5 */
+    chunks[c + 1].n0 = p->n0 + p->count;
+  }
+
+  /* Phase 3 */
+  run_chunks(chunks, t, replay);
+
+  /* FALLBACK: an overflow fault does not compose; replay serially */
+  for (c = 0; c < t; c++) {
+    if (chunks[c].overflow || !is_finite(chunks[c].mu0) ||
+        !is_finite(chunks[c].var0)) {
+      b->in_step = 0;
+      return base_step_batch(b, x, n, z_out, NULL, NULL);
+    }
+  }
+
+  /*
+   * FSM: from STABLE or DEVIATION the next state is z > k ? DEVIATION
+   * : STABLE; a fault makes every later state DEVIATION (INV-3); from
+   * LEARNING the first ready step goes to STABLE.
+   */
+  faulted = base_faulted(b);
+  left_learning = (b->state != BASE_LEARNING);
+  state = b->state;
+  for (c = 0; c < t; c++) {
+    chunk_t *p = &chunks[c];
+
+    if (faulted) {
+      deviations += p->hi - p->lo;
+      continue;
+    }
+    if (left_learning) {
+      deviations += p->zk_all;
+      state = p->zk_last ? BASE_DEVIATION : BASE_STABLE;
+    } else if (p->first_ready < p->first_fault) {
+      deviations += p->zk_ready;
+      state = (p->first_ready + 1u == p->hi || !p->zk_last) ? BASE_STABLE
+                                                           : BASE_DEVIATION;
+      left_learning = 1;
+    }
+    if (p->first_fault < p->hi) {
+      deviations += p->hi - p->first_fault;
+      faulted = 1;
+      fault_new = 1;
+      state = BASE_DEVIATION;
+    }
+  }
+
+  /* Commit; σ as cached by the last committed step, if any */
+  for (c = 0; c < t; c++) {
+    if (chunks[c].count != 0) {
+      b->mu = chunks[t - 1].mu;
+      b->variance = chunks[t - 1].var;
+      b->sigma = sqrt(b->variance);
+      b->sigma_stale = 0;
+      break;
+    }
+  }
+  b->n = chunks[t - 1].n0 + chunks[t - 1].count;
+  b->state = state;
+  b->fault_fp |= fault_new;
+  b->in_step = 0;
+  return deviations;
+}
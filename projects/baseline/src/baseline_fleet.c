@@ -0,0 +1,763 @@
+/**
+ * baseline_fleet.c - Structure-of-Arrays Fleet Implementation
+ *
+ * The scalar kernel is the body of base_step() applied to column i.
+ * The vector kernels compute the same update for 4 or 8 streams at
+ * once and replace the FSM switch with lane masks:
+ *
+ *   ok        μₜ and σₜ² finite          (else fault, nothing committed)
+ *   above     ok ∧ σₜ² > ε               (z-score defined)
+ *   z         above ? |dev| / σₜ : 0
+ *   ready     ok ∧ nₜ ≥ n_min ∧ above
+ *   → STABLE  ok ∧ valid ∧ ((LEARNING ∧ ready) ∨ (STABLE ∧ z ≤ k)
+ *                            ∨ (DEVIATION ∧ ¬faulted ∧ z ≤ k))
+ *   → DEVIATION  ¬ok ∨ invalid ∨ (STABLE ∧ z > k)
+ *                ∨ (DEVIATION ∧ ¬→STABLE)
+ *
+ * The arithmetic is the same sequence of correctly rounded IEEE
+ * operations as base_step() (sub, mul, add, sqrt, div; never fused),
+ * so every kernel reproduces it exactly.
+ *
+ * BASE_FLOAT32 runs that sequence in single precision, twice the
+ * lanes per vector. BASE_FIXED_POINT has its own scalar kernel:
+ * round-to-nearest Q16.16 products in 64-bit integers, with range
+ * checks standing in for the finiteness checks.
+ *
+ * See: baseline.c, baseline_fleet.h
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "baseline_fleet.h"
+#include <math.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__) && \
+    !defined(BASE_FIXED_POINT)
+#define BASE_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define BASE_KERNEL_X86 0
+#endif
+
+#if defined(BASE_FLOAT32)
+#define VALUE_SQRT sqrtf
+#define VALUE_FABS fabsf
+#else
+#define VALUE_SQRT sqrt
+#define VALUE_FABS fabs
+#endif
+
+/** Step streams [base, end) with observations x[i] */
+typedef void (*base_kernel_fn)(base_fleet_t *f, size_t base, size_t end,
+                               const double *x, double *z_out);
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Check if value is finite (not NaN, not Inf) */
+static inline uint8_t is_finite(double x) { return isfinite(x) != 0; }
+
+/** Round a column size up to a whole number of 64-byte cache lines */
+static inline size_t column_bytes(size_t n, size_t elem) {
+  return ((n * elem) + 63u) & ~(size_t)63u;
+}
+
+/**
+ * FSM step of stream i after its statistics were committed.
+ *
+ * @param ready nₜ ≥ n_min ∧ σₜ² > ε
+ * @param zk    z > k
+ */
+static inline void transition1(base_fleet_t *f, size_t i, uint8_t ready,
+                               uint8_t zk) {
+  switch ((base_state_t)f->state[i]) {
+  case BASE_LEARNING:
+    if (ready) {
+      f->state[i] = (uint8_t)BASE_STABLE;
+    }
+    break;
+
+  case BASE_STABLE:
+    if (zk) {
+      f->state[i] = (uint8_t)BASE_DEVIATION;
+    }
+    break;
+
+  case BASE_DEVIATION:
+    if (!f->fault_fp[i] && !f->fault_reentry[i] && !zk) {
+      f->state[i] = (uint8_t)BASE_STABLE;
+    }
+    break;
+
+  default:
+    f->fault_fp[i] = 1;
+    f->state[i] = (uint8_t)BASE_DEVIATION;
+    break;
+  }
+}
+
+/** Fault stream i: DEVIATION, statistics and n unchanged */
+static inline void fault1(base_fleet_t *f, size_t i, double *z_out) {
+  f->fault_fp[i] = 1;
+  f->state[i] = (uint8_t)BASE_DEVIATION;
+  if (z_out) {
+    z_out[i] = 0.0;
+  }
+}
+
+#if defined(BASE_FIXED_POINT)
+
+/*---------------------------------------------------------------------------
+ * Q16.16 Helpers
+ *---------------------------------------------------------------------------*/
+
+#define Q16_ONE  ((int64_t)BASE_VALUE_SCALE)
+#define Q16_HALF ((int64_t)(BASE_VALUE_SCALE / 2))
+
+/** Q32.32 product -> Q16.16, rounding to nearest (floor of v + ½) */
+static inline int64_t q16_round(int64_t v) {
+  v += Q16_HALF;
+  return (v >= 0) ? (v >> 16) : -((-v + (Q16_ONE - 1)) >> 16);
+}
+
+/** α as a Q16.16 fraction in [1, 2¹⁶ - 1] */
+static inline int64_t q16_alpha(const base_fleet_t *f) {
+  int64_t a = (int64_t)llrint(f->cfg.alpha * (double)Q16_ONE);
+  return (a < 1) ? 1 : (a > Q16_ONE - 1) ? Q16_ONE - 1 : a;
+}
+
+/** ⌊√v⌋ of a Q16.16 variance, as Q16.16 */
+static inline int32_t q16_sqrt(int64_t v) {
+  uint64_t wide = (uint64_t)v << 16;
+  uint64_t r = (uint64_t)sqrt((double)wide);
+
+  /* The double result is within one of the integer root */
+  while (r * r > wide) {
+    r--;
+  }
+  while ((r + 1u) * (r + 1u) <= wide) {
+    r++;
+  }
+  return (int32_t)r;
+}
+
+/*---------------------------------------------------------------------------
+ * Scalar Kernel — Q16.16
+ *---------------------------------------------------------------------------*/
+
+static void kernel_scalar(base_fleet_t *f, size_t base, size_t end,
+                          const double *x, double *z_out) {
+  const int64_t alpha = q16_alpha(f);
+  const int64_t keep = Q16_ONE - alpha;
+  /* Largest rounded deviation² whose α share still fits in σ² < 2¹⁵ */
+  const uint64_t dev2_max = ((uint64_t)1 << 47) / (uint64_t)alpha;
+  size_t i;
+
+  for (i = base; i < end; i++) {
+    int64_t xq, deviation, mu_new, var_new;
+    uint64_t adev, dev2;
+    double z = 0.0;
+
+    /* NaN, ±∞ and |x| ≥ 2¹⁵ are all outside Q16.16 */
+    if (!(fabs(x[i]) < 32768.0) ||
+        (xq = (int64_t)llrint(x[i] * (double)Q16_ONE)) > INT32_MAX ||
+        xq < INT32_MIN) {
+      fault1(f, i, z_out);
+      continue;
+    }
+
+    /* UPDATE SEQUENCE steps 1-3, as base_step(): |xq - μ| < 2³² */
+    deviation = xq - f->mu[i];
+    adev = (uint64_t)(deviation < 0 ? -deviation : deviation);
+    dev2 = (adev * adev + (uint64_t)Q16_HALF) >> 16;
+    if (dev2 > dev2_max) {
+      fault1(f, i, z_out);
+      continue;
+    }
+    mu_new = q16_round(alpha * xq + keep * f->mu[i]);
+    var_new = q16_round(alpha * (int64_t)dev2 + keep * f->variance[i]);
+    if (var_new > INT32_MAX) {
+      fault1(f, i, z_out);
+      continue;
+    }
+
+    /* Commit, steps 4-5 */
+    f->mu[i] = (int32_t)mu_new;
+    f->variance[i] = (int32_t)var_new;
+    f->sigma[i] = q16_sqrt(var_new);
+    f->count[i] += 1;
+    if (f->variance[i] > f->epsilon) {
+      z = (double)adev / (double)f->sigma[i];
+    }
+    if (z_out) {
+      z_out[i] = z;
+    }
+
+    transition1(f, i,
+                f->count[i] >= f->cfg.n_min && f->variance[i] > f->epsilon,
+                z > f->cfg.k);
+  }
+}
+
+#else /* double or float32 columns */
+
+/*---------------------------------------------------------------------------
+ * Scalar Kernel
+ *---------------------------------------------------------------------------*/
+
+static void kernel_scalar(base_fleet_t *f, size_t base, size_t end,
+                          const double *x, double *z_out) {
+  const base_value_t alpha = (base_value_t)f->cfg.alpha;
+  const base_value_t keep = (base_value_t)(1.0 - f->cfg.alpha);
+  const base_value_t epsilon = f->epsilon;
+  const base_value_t k = (base_value_t)f->cfg.k;
+  size_t i;
+
+  for (i = base; i < end; i++) {
+    /* UPDATE SEQUENCE steps 1-3, as base_step() */
+    base_value_t xi = (base_value_t)x[i];
+    base_value_t deviation = xi - f->mu[i];
+    base_value_t mu_new = alpha * xi + keep * f->mu[i];
+    base_value_t var_new =
+        alpha * (deviation * deviation) + keep * f->variance[i];
+    base_value_t z = 0;
+
+    /* Non-finite xₜ always makes μₜ non-finite; σ² ≥ 0 keeps σ finite */
+    if (!is_finite(mu_new) || !is_finite(var_new)) {
+      fault1(f, i, z_out);
+      continue;
+    }
+
+    /* Commit, steps 4-5 */
+    f->mu[i] = mu_new;
+    f->variance[i] = var_new;
+    f->sigma[i] = VALUE_SQRT(var_new);
+    f->count[i] += 1;
+    if (var_new > epsilon) {
+      z = VALUE_FABS(deviation) / f->sigma[i];
+    }
+    if (z_out) {
+      z_out[i] = (double)z;
+    }
+
+    transition1(f, i, f->count[i] >= f->cfg.n_min && var_new > epsilon,
+                z > k);
+  }
+}
+
+#endif /* BASE_FIXED_POINT */
+
+#if BASE_KERNEL_X86
+
+/*---------------------------------------------------------------------------
+ * Lane-Mask Transitions — eight streams, state bytes <-> 8-bit masks
+ *---------------------------------------------------------------------------*/
+
+/** Eight 0/1 bytes, byte j = bit j of m */
+static inline uint64_t lanes_to_bytes(unsigned m) {
+  uint64_t x = ((uint64_t)m * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+  return ((x + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+}
+
+/** 8-bit lane mask of eight 0/1 bytes, bit j = byte j */
+static inline unsigned bytes_to_lanes(uint64_t b) {
+  return (unsigned)((b * 0x0102040810204080ULL) >> 56);
+}
+
+/** 0/1 byte per byte of v: 1 where that byte is non-zero */
+static inline uint64_t nonzero_bytes(uint64_t v) {
+  uint64_t low7 = (v & 0x7F7F7F7F7F7F7F7FULL) + 0x7F7F7F7F7F7F7F7FULL;
+  return ((low7 | v) >> 7) & 0x0101010101010101ULL;
+}
+
+/**
+ * FSM step of streams i..i+7 as lane masks.
+ *
+ * @param ok    Lanes whose statistics were committed
+ * @param ready Lanes with nₜ ≥ n_min ∧ σₜ² > ε (subset of ok)
+ * @param zk    Lanes with z > k (subset of ok)
+ */
+static inline void transition8(base_fleet_t *f, size_t i, unsigned ok,
+                               unsigned ready, unsigned zk) {
+  const uint64_t ones = 0x0101010101010101ULL;
+  uint64_t st, ffp, fre;
+  unsigned invalid, stable, dev, learn, faulted, fault_new, to_stable, to_dev;
+
+  memcpy(&st, &f->state[i], sizeof(st));
+  memcpy(&ffp, &f->fault_fp[i], sizeof(ffp));
+  memcpy(&fre, &f->fault_reentry[i], sizeof(fre));
+
+  /* Decode: 0 LEARNING, 1 STABLE, 2 DEVIATION, anything else invalid */
+  invalid = bytes_to_lanes(nonzero_bytes(st & ~(ones * 3u)) |
+                           (st & (st >> 1) & ones));
+  stable = bytes_to_lanes(st & ones) & ~invalid;
+  dev = bytes_to_lanes((st >> 1) & ones) & ~invalid;
+  learn = 0xFFu & ~(stable | dev | invalid);
+  faulted = bytes_to_lanes(nonzero_bytes(ffp | fre));
+
+  fault_new = 0xFFu & (~ok | invalid);
+  to_stable = ok & ~invalid &
+              ((learn & ready) | ((stable | (dev & ~faulted)) & ~zk));
+  to_dev = fault_new | (stable & zk) | (dev & ~to_stable);
+
+  st = lanes_to_bytes(to_stable) * (uint64_t)BASE_STABLE +
+       lanes_to_bytes(to_dev) * (uint64_t)BASE_DEVIATION;
+  memcpy(&f->state[i], &st, sizeof(st));
+
+  if (fault_new) {
+    ffp |= lanes_to_bytes(fault_new);
+    memcpy(&f->fault_fp[i], &ffp, sizeof(ffp));
+  }
+}
+
+/**
+ * count += 1 on the ok lanes of eight streams; returns the lanes with
+ * count ≥ n_min afterwards (unsigned, wrapping as base_step's n += 1).
+ */
+__attribute__((target("avx2")))
+static inline unsigned avx2_count8(uint32_t *count, unsigned ok,
+                                   uint32_t n_min) {
+  const __m256i lane_bit = _mm256_setr_epi32(1, 2, 4, 8, 16, 32, 64, 128);
+  __m256i ok_v = _mm256_and_si256(_mm256_set1_epi32((int)ok), lane_bit);
+  __m256i c = _mm256_loadu_si256((const __m256i *)count);
+  __m256i min_v = _mm256_set1_epi32((int)n_min);
+
+  /* ok lanes are all-ones (-1): subtracting adds one */
+  c = _mm256_sub_epi32(c, _mm256_cmpeq_epi32(ok_v, lane_bit));
+  _mm256_storeu_si256((__m256i *)count, c);
+
+  return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(
+      _mm256_cmpeq_epi32(_mm256_max_epu32(c, min_v), c)));
+}
+
+#if defined(BASE_FLOAT32)
+
+/*---------------------------------------------------------------------------
+ * AVX2 Kernel — float32, 8 streams per 8-lane vector
+ *---------------------------------------------------------------------------*/
+
+/** Eight observations rounded to float, as (float)x[i] */
+__attribute__((target("avx2")))
+static inline __m256 avx2_load8f(const double *x) {
+  __m128 lo = _mm256_cvtpd_ps(_mm256_loadu_pd(x));
+  __m128 hi = _mm256_cvtpd_ps(_mm256_loadu_pd(x + 4));
+  return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+}
+
+__attribute__((target("avx2")))
+static void kernel_avx2(base_fleet_t *f, size_t base, size_t end,
+                        const double *x, double *z_out) {
+  const __m256 alpha = _mm256_set1_ps((float)f->cfg.alpha);
+  const __m256 keep = _mm256_set1_ps((float)(1.0 - f->cfg.alpha));
+  const __m256 eps = _mm256_set1_ps(f->epsilon);
+  const __m256 k = _mm256_set1_ps((float)f->cfg.k);
+  const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7FFFFFFF));
+  const __m256 inf = _mm256_set1_ps(INFINITY);
+  size_t i;
+
+  for (i = base; i + 8u <= end; i += 8u) {
+    __m256 xv = avx2_load8f(&x[i]);
+    __m256 mu = _mm256_loadu_ps(&f->mu[i]);
+    __m256 var = _mm256_loadu_ps(&f->variance[i]);
+
+    /* Steps 1-4, unfused, in base_step() order */
+    __m256 dev = _mm256_sub_ps(xv, mu);
+    __m256 mu_new =
+        _mm256_add_ps(_mm256_mul_ps(alpha, xv), _mm256_mul_ps(keep, mu));
+    __m256 var_new = _mm256_add_ps(_mm256_mul_ps(alpha, _mm256_mul_ps(dev, dev)),
+                                   _mm256_mul_ps(keep, var));
+    __m256 sig_new = _mm256_sqrt_ps(var_new);
+
+    /* Per-lane fault check: |v| < ∞ is false for ±∞ and NaN */
+    __m256 ok_v = _mm256_and_ps(
+        _mm256_cmp_ps(_mm256_and_ps(mu_new, abs_mask), inf, _CMP_LT_OQ),
+        _mm256_cmp_ps(_mm256_and_ps(var_new, abs_mask), inf, _CMP_LT_OQ));
+
+    _mm256_storeu_ps(&f->mu[i], _mm256_blendv_ps(mu, mu_new, ok_v));
+    _mm256_storeu_ps(&f->variance[i], _mm256_blendv_ps(var, var_new, ok_v));
+    _mm256_storeu_ps(&f->sigma[i], _mm256_blendv_ps(
+                                       _mm256_loadu_ps(&f->sigma[i]), sig_new, ok_v));
+
+    /* Step 5: z where the variance floor allows, 0.0 elsewhere */
+    __m256 above_v = _mm256_and_ps(ok_v, _mm256_cmp_ps(var_new, eps, _CMP_GT_OQ));
+    __m256 z = _mm256_and_ps(
+        above_v, _mm256_div_ps(_mm256_and_ps(dev, abs_mask), sig_new));
+    if (z_out) {
+      _mm256_storeu_pd(&z_out[i], _mm256_cvtps_pd(_mm256_castps256_ps128(z)));
+      _mm256_storeu_pd(&z_out[i + 4u],
+                       _mm256_cvtps_pd(_mm256_extractf128_ps(z, 1)));
+    }
+
+    unsigned ok = (unsigned)_mm256_movemask_ps(ok_v);
+    unsigned above = (unsigned)_mm256_movemask_ps(above_v);
+    unsigned zk = (unsigned)_mm256_movemask_ps(_mm256_cmp_ps(z, k, _CMP_GT_OQ));
+    unsigned at_min = avx2_count8(&f->count[i], ok, f->cfg.n_min);
+    transition8(f, i, ok, ok & at_min & above, zk);
+  }
+
+  /* Leave no dirty upper state for the SSE/scalar code that follows */
+  _mm256_zeroupper();
+
+  /* Tail */
+  kernel_scalar(f, i, end, x, z_out);
+}
+
+/*---------------------------------------------------------------------------
+ * AVX-512 Kernel — float32, 16 streams per iteration
+ *---------------------------------------------------------------------------*/
+
+__attribute__((target("avx512f")))
+static void kernel_avx512(base_fleet_t *f, size_t base, size_t end,
+                          const double *x, double *z_out) {
+  const __m512 alpha = _mm512_set1_ps((float)f->cfg.alpha);
+  const __m512 keep = _mm512_set1_ps((float)(1.0 - f->cfg.alpha));
+  const __m512 eps = _mm512_set1_ps(f->epsilon);
+  const __m512 k = _mm512_set1_ps((float)f->cfg.k);
+  const __m512 inf = _mm512_set1_ps(INFINITY);
+  size_t i;
+
+  for (i = base; i + 16u <= end; i += 16u) {
+    __m256 lo = _mm512_cvtpd_ps(_mm512_loadu_pd(&x[i]));
+    __m256 hi = _mm512_cvtpd_ps(_mm512_loadu_pd(&x[i + 8u]));
+    __m512 xv = _mm512_castpd_ps(_mm512_insertf64x4(
+        _mm512_castps_pd(_mm512_castps256_ps512(lo)), _mm256_castps_pd(hi), 1));
+    __m512 mu = _mm512_loadu_ps(&f->mu[i]);
+    __m512 var = _mm512_loadu_ps(&f->variance[i]);
+
+    /* Steps 1-4, unfused, in base_step() order */
+    __m512 dev = _mm512_sub_ps(xv, mu);
+    __m512 mu_new =
+        _mm512_add_ps(_mm512_mul_ps(alpha, xv), _mm512_mul_ps(keep, mu));
+    __m512 var_new = _mm512_add_ps(
+        _mm512_mul_ps(alpha, _mm512_mul_ps(dev, dev)), _mm512_mul_ps(keep, var));
+
+    /* Per-lane fault check: |v| < ∞ is false for ±∞ and NaN */
+    __mmask16 ok = _mm512_cmp_ps_mask(_mm512_abs_ps(mu_new), inf, _CMP_LT_OQ) &
+                   _mm512_cmp_ps_mask(_mm512_abs_ps(var_new), inf, _CMP_LT_OQ);
+    __m512 sig_new = _mm512_maskz_sqrt_ps(ok, var_new);
+
+    _mm512_mask_storeu_ps(&f->mu[i], ok, mu_new);
+    _mm512_mask_storeu_ps(&f->variance[i], ok, var_new);
+    _mm512_mask_storeu_ps(&f->sigma[i], ok, sig_new);
+
+    /* Step 5: z where the variance floor allows, 0.0 elsewhere */
+    __mmask16 above = ok & _mm512_cmp_ps_mask(var_new, eps, _CMP_GT_OQ);
+    __m512 z = _mm512_maskz_div_ps(above, _mm512_abs_ps(dev), sig_new);
+    if (z_out) {
+      _mm512_storeu_pd(&z_out[i], _mm512_cvtps_pd(_mm512_castps512_ps256(z)));
+      _mm512_storeu_pd(&z_out[i + 8u],
+                       _mm512_cvtps_pd(_mm256_castpd_ps(
+                           _mm512_extractf64x4_pd(_mm512_castps_pd(z), 1))));
+    }
+    __mmask16 zk = _mm512_cmp_ps_mask(z, k, _CMP_GT_OQ);
+
+    /* Two groups of eight for the count and state columns */
+    unsigned ready = ok & above;
+    unsigned at_min = avx2_count8(&f->count[i], ok & 0xFFu, f->cfg.n_min);
+    at_min |= avx2_count8(&f->count[i + 8u], (unsigned)ok >> 8, f->cfg.n_min)
+              << 8;
+    ready &= at_min;
+    transition8(f, i, ok & 0xFFu, ready & 0xFFu, zk & 0xFFu);
+    transition8(f, i + 8u, (unsigned)ok >> 8, ready >> 8, (unsigned)zk >> 8);
+  }
+
+  /* Leave no dirty upper state for the SSE/scalar code that follows */
+  _mm256_zeroupper();
+
+  /* Tail */
+  kernel_scalar(f, i, end, x, z_out);
+}
+
+#else /* double columns */
+
+/*---------------------------------------------------------------------------
+ * AVX2 Kernel — 8 streams per iteration, two 4-lane vectors
+ *---------------------------------------------------------------------------*/
+
+/**
+ * Statistics of four streams: returns the ok mask, sets *above (σ² > ε)
+ * and *zk (z > k). Commits mu, variance and sigma on ok lanes only.
+ */
+__attribute__((target("avx2")))
+static inline unsigned avx2_update4(base_fleet_t *f, size_t i,
+                                    const double *x, double *z_out,
+                                    __m256d alpha, __m256d keep,
+                                    __m256d eps, __m256d k,
+                                    unsigned *above, unsigned *zk) {
+  const __m256d abs_mask =
+      _mm256_castsi256_pd(_mm256_set1_epi64x(0x7FFFFFFFFFFFFFFFLL));
+  const __m256d inf = _mm256_set1_pd(INFINITY);
+
+  __m256d xv = _mm256_loadu_pd(&x[i]);
+  __m256d mu = _mm256_loadu_pd(&f->mu[i]);
+  __m256d var = _mm256_loadu_pd(&f->variance[i]);
+
+  /* Steps 1-4, unfused, in base_step() order */
+  __m256d dev = _mm256_sub_pd(xv, mu);
+  __m256d mu_new =
+      _mm256_add_pd(_mm256_mul_pd(alpha, xv), _mm256_mul_pd(keep, mu));
+  __m256d var_new = _mm256_add_pd(_mm256_mul_pd(alpha, _mm256_mul_pd(dev, dev)),
+                                  _mm256_mul_pd(keep, var));
+  __m256d sig_new = _mm256_sqrt_pd(var_new);
+
+  /* Per-lane fault check: |v| < ∞ is false for ±∞ and NaN */
+  __m256d ok = _mm256_and_pd(
+      _mm256_cmp_pd(_mm256_and_pd(mu_new, abs_mask), inf, _CMP_LT_OQ),
+      _mm256_cmp_pd(_mm256_and_pd(var_new, abs_mask), inf, _CMP_LT_OQ));
+
+  _mm256_storeu_pd(&f->mu[i], _mm256_blendv_pd(mu, mu_new, ok));
+  _mm256_storeu_pd(&f->variance[i], _mm256_blendv_pd(var, var_new, ok));
+  _mm256_storeu_pd(&f->sigma[i],
+                   _mm256_blendv_pd(_mm256_loadu_pd(&f->sigma[i]), sig_new, ok));
+
+  /* Step 5: z where the variance floor allows, 0.0 elsewhere */
+  __m256d above_v = _mm256_and_pd(ok, _mm256_cmp_pd(var_new, eps, _CMP_GT_OQ));
+  __m256d z = _mm256_and_pd(
+      above_v, _mm256_div_pd(_mm256_and_pd(dev, abs_mask), sig_new));
+  if (z_out) {
+    _mm256_storeu_pd(&z_out[i], z);
+  }
+
+  *above = (unsigned)_mm256_movemask_pd(above_v);
+  *zk = (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(z, k, _CMP_GT_OQ));
+  return (unsigned)_mm256_movemask_pd(ok);
+}
+
+__attribute__((target("avx2")))
+static void kernel_avx2(base_fleet_t *f, size_t base, size_t end,
+                        const double *x, double *z_out) {
+  const __m256d alpha = _mm256_set1_pd(f->cfg.alpha);
+  const __m256d keep = _mm256_set1_pd(1.0 - f->cfg.alpha);
+  const __m256d eps = _mm256_set1_pd(f->cfg.epsilon);
+  const __m256d k = _mm256_set1_pd(f->cfg.k);
+  size_t i;
+
+  for (i = base; i + 8u <= end; i += 8u) {
+    unsigned ok, above, above_hi, zk, zk_hi, at_min;
+
+    ok = avx2_update4(f, i, x, z_out, alpha, keep, eps, k, &above, &zk);
+    ok |= avx2_update4(f, i + 4u, x, z_out, alpha, keep, eps, k, &above_hi,
+                       &zk_hi) << 4;
+    above |= above_hi << 4;
+    zk |= zk_hi << 4;
+
+    at_min = avx2_count8(&f->count[i], ok, f->cfg.n_min);
+    transition8(f, i, ok, ok & at_min & above, zk);
+  }
+
+  /* Leave no dirty upper state for the SSE/scalar code that follows */
+  _mm256_zeroupper();
+
+  /* Tail */
+  kernel_scalar(f, i, end, x, z_out);
+}
+
+/*---------------------------------------------------------------------------
+ * AVX-512 Kernel — 8 streams per iteration
+ *---------------------------------------------------------------------------*/
+
+__attribute__((target("avx512f")))
+static void kernel_avx512(base_fleet_t *f, size_t base, size_t end,
+                          const double *x, double *z_out) {
+  const __m512d alpha = _mm512_set1_pd(f->cfg.alpha);
+  const __m512d keep = _mm512_set1_pd(1.0 - f->cfg.alpha);
+  const __m512d eps = _mm512_set1_pd(f->cfg.epsilon);
+  const __m512d k = _mm512_set1_pd(f->cfg.k);
+  const __m512d inf = _mm512_set1_pd(INFINITY);
+  size_t i;
+
+  for (i = base; i + 8u <= end; i += 8u) {
+    __m512d xv = _mm512_loadu_pd(&x[i]);
+    __m512d mu = _mm512_loadu_pd(&f->mu[i]);
+    __m512d var = _mm512_loadu_pd(&f->variance[i]);
+
+    /* Steps 1-4, unfused, in base_step() order */
+    __m512d dev = _mm512_sub_pd(xv, mu);
+    __m512d mu_new =
+        _mm512_add_pd(_mm512_mul_pd(alpha, xv), _mm512_mul_pd(keep, mu));
+    __m512d var_new = _mm512_add_pd(
+        _mm512_mul_pd(alpha, _mm512_mul_pd(dev, dev)), _mm512_mul_pd(keep, var));
+
+    /* Per-lane fault check: |v| < ∞ is false for ±∞ and NaN */
+    __mmask8 ok = _mm512_cmp_pd_mask(_mm512_abs_pd(mu_new), inf, _CMP_LT_OQ) &
+                  _mm512_cmp_pd_mask(_mm512_abs_pd(var_new), inf, _CMP_LT_OQ);
+    __m512d sig_new = _mm512_maskz_sqrt_pd(ok, var_new);
+
+    _mm512_mask_storeu_pd(&f->mu[i], ok, mu_new);
+    _mm512_mask_storeu_pd(&f->variance[i], ok, var_new);
+    _mm512_mask_storeu_pd(&f->sigma[i], ok, sig_new);
+
+    /* Step 5: z where the variance floor allows, 0.0 elsewhere */
+    __mmask8 above = ok & _mm512_cmp_pd_mask(var_new, eps, _CMP_GT_OQ);
+    __m512d z = _mm512_maskz_div_pd(above, _mm512_abs_pd(dev), sig_new);
+    if (z_out) {
+      _mm512_storeu_pd(&z_out[i], z);
+    }
+    __mmask8 zk = _mm512_cmp_pd_mask(z, k, _CMP_GT_OQ);
+
+    unsigned at_min = avx2_count8(&f->count[i], ok, f->cfg.n_min);
+    transition8(f, i, ok, ok & at_min & above, zk);
+  }
+
+  /* Leave no dirty upper state for the SSE/scalar code that follows */
+  _mm256_zeroupper();
+
+  /* Tail */
+  kernel_scalar(f, i, end, x, z_out);
+}
+
+#endif /* BASE_FLOAT32 */
+
+#endif /* BASE_KERNEL_X86 */
+
+/** Implementation of a kernel, or the scalar kernel if unsupported */
+static base_kernel_fn kernel_get(base_kernel_t k) {
+  if (!base_kernel_supported(k)) {
+    return kernel_scalar;
+  }
+  switch (k) {
+#if BASE_KERNEL_X86
+  case BASE_KERNEL_AVX2:
+    return kernel_avx2;
+  case BASE_KERNEL_AVX512:
+    return kernel_avx512;
+#endif
+  default:
+    return kernel_scalar;
+  }
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t base_fleet_bytes(size_t n) {
+  /* Largest n for which 3 value, 1 x 4-byte and 3 x 1-byte columns fit */
+  if (n == 0 ||
+      n > ((size_t)-1 - 7u * 63u) / (3u * sizeof(base_value_t) + 7u)) {
+    return 0;
+  }
+  return 3u * column_bytes(n, sizeof(base_value_t)) +
+         column_bytes(n, sizeof(uint32_t)) +
+         3u * column_bytes(n, sizeof(uint8_t));
+}
+
+int base_fleet_init(base_fleet_t *f, void *mem, size_t mem_size, size_t n,
+                    const base_config_t *cfg) {
+  size_t need = base_fleet_bytes(n);
+  unsigned char *p = (unsigned char *)mem;
+  base_fsm_t probe;
+  size_t i;
+
+  if (f == NULL || mem == NULL || need == 0 || mem_size < need) {
+    return -1;
+  }
+
+  /* Config constraints C1-C4, checked exactly as base_init() does */
+  if (base_init(&probe, cfg) != 0) {
+    return -1;
+  }
+
+  /* Value columns must be naturally aligned (count needs no more) */
+  if (((uintptr_t)mem & (sizeof(base_value_t) - 1u)) != 0) {
+    return -1;
+  }
+
+  /* Carve columns: wide columns first so alignment is preserved */
+  f->mu = (base_value_t *)(void *)p;
+  p += column_bytes(n, sizeof(base_value_t));
+  f->variance = (base_value_t *)(void *)p;
+  p += column_bytes(n, sizeof(base_value_t));
+  f->sigma = (base_value_t *)(void *)p;
+  p += column_bytes(n, sizeof(base_value_t));
+  f->count = (uint32_t *)(void *)p;
+  p += column_bytes(n, sizeof(uint32_t));
+  f->state = p;
+  p += column_bytes(n, sizeof(uint8_t));
+  f->fault_fp = p;
+  p += column_bytes(n, sizeof(uint8_t));
+  f->fault_reentry = p;
+
+  f->cfg = *cfg;
+#if defined(BASE_FIXED_POINT)
+  /* σ² > ε ⇔ σ²_q > ⌊ε·2¹⁶⌋ for integer σ²_q */
+  f->epsilon = (cfg->epsilon * (double)BASE_VALUE_SCALE >= (double)INT32_MAX)
+                   ? INT32_MAX
+                   : (int32_t)(cfg->epsilon * (double)BASE_VALUE_SCALE);
+#else
+  f->epsilon = (base_value_t)cfg->epsilon;
+#endif
+  f->n = n;
+  f->in_step = 0;
+  f->kernel = base_kernel_best();
+
+  /* Every stream as if by base_init(b, cfg) */
+  for (i = 0; i < n; i++) {
+    f->mu[i] = 0;
+    f->variance[i] = 0;
+    f->sigma[i] = 0;
+    f->count[i] = 0;
+    f->state[i] = (uint8_t)BASE_LEARNING;
+    f->fault_fp[i] = 0;
+    f->fault_reentry[i] = 0;
+  }
+
+  return 0;
+}
+
+void base_fleet_step(base_fleet_t *f, const double *x, double *z_out) {
+  size_t i;
+
+  /* Reentrancy check — CONTRACT enforcement, fleet-wide */
+  if (f->in_step) {
+    for (i = 0; i < f->n; i++) {
+      f->fault_reentry[i] = 1;
+      f->state[i] = (uint8_t)BASE_DEVIATION;
+      if (z_out) {
+        z_out[i] = 0.0;
+      }
+    }
+    return;
+  }
+  f->in_step = 1;
+
+  kernel_get(f->kernel)(f, 0, f->n, x, z_out);
+
+  f->in_step = 0;
+}
+
+int base_fleet_set_kernel(base_fleet_t *f, base_kernel_t k) {
+  if (!base_kernel_supported(k)) {
+    return -1;
+  }
+  f->kernel = k;
+  return 0;
+}
+
+uint8_t base_kernel_supported(base_kernel_t k) {
+  switch (k) {
+  case BASE_KERNEL_SCALAR:
+    return 1;
+#if BASE_KERNEL_X86
+  case BASE_KERNEL_AVX2:
+    return __builtin_cpu_supports("avx2") ? 1 : 0;
+  case BASE_KERNEL_AVX512:
+    return __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+  default:
+    return 0;
+  }
+}
+
+base_kernel_t base_kernel_best(void) {
+  if (base_kernel_supported(BASE_KERNEL_AVX512)) {
+    return BASE_KERNEL_AVX512;
+  }
+  if (base_kernel_supported(BASE_KERNEL_AVX2)) {
+    return BASE_KERNEL_AVX2;
+  }
+  return BASE_KERNEL_SCALAR;
+}
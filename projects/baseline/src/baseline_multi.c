@@ -0,0 +1,497 @@
+/**
+ * baseline_multi.c - Multivariate Normality Monitor Implementation
+ *
+ * A step is three vector passes, each a contiguous run of the same
+ * operation, then a score:
+ *
+ *   ema     δᵢ = xᵢ - μᵢ;  μ'ᵢ = α·xᵢ + (1-α)·μᵢ
+ *   square  σ²'ᵢ = α·(δᵢ·δᵢ) + (1-α)·σ²ᵢ                 (DIAG)
+ *   outer   Σ'ᵢⱼ = α·(δᵢ·δⱼ) + (1-α)·Σᵢⱼ, row by row     (FULL)
+ *   score   D² = Σ (|δᵢ| / σᵢ)²                          (DIAG)
+ *           D² = |L⁻¹δ|², LLᵀ = Σ', by Cholesky           (FULL)
+ *
+ * Every pass also reports whether any output is not finite, which is
+ * the fault check of base_step() for all d metrics at once.
+ *
+ * The AVX2 passes use the same unfused operations in the same order as
+ * the scalar ones, so both kernels give identical results.
+ *
+ * See: baseline_multi.h
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "baseline_multi.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BASE_MULTI_X86 1
+#include <immintrin.h>
+#else
+#define BASE_MULTI_X86 0
+#endif
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Check if value is finite (not NaN, not Inf) */
+static inline uint8_t is_finite(double x) { return isfinite(x) != 0; }
+
+/** Absolute value (avoid dependency on fabs for teaching clarity) */
+static inline double abs_d(double x) { return (x < 0.0) ? -x : x; }
+
+/** Doubles of covariance storage: σ² per metric, or the d × d matrix */
+static size_t cov_len(uint32_t d, base_multi_mode_t mode) {
+  return (mode == BASE_MULTI_FULL) ? (size_t)d * d : (size_t)d;
+}
+
+/*
+ * Scalar passes. Each returns nonzero if any output is not finite.
+ */
+
+static unsigned ema_scalar(const double *x, const double *mu, double *mu_next,
+                           double *dev, uint32_t d, double alpha,
+                           double keep) {
+  unsigned bad = 0;
+  uint32_t i;
+
+  for (i = 0; i < d; i++) {
+    dev[i] = x[i] - mu[i];
+    mu_next[i] = alpha * x[i] + keep * mu[i];
+    bad |= !is_finite(mu_next[i]);
+  }
+  return bad;
+}
+
+static unsigned square_scalar(const double *dev, const double *var,
+                              double *var_next, uint32_t d, double alpha,
+                              double keep) {
+  unsigned bad = 0;
+  uint32_t i;
+
+  for (i = 0; i < d; i++) {
+    var_next[i] = alpha * (dev[i] * dev[i]) + keep * var[i];
+    bad |= !is_finite(var_next[i]);
+  }
+  return bad;
+}
+
+static unsigned outer_scalar(double s, const double *dev, const double *row,
+                             double *row_next, uint32_t d, double alpha,
+                             double keep) {
+  unsigned bad = 0;
+  uint32_t j;
+
+  for (j = 0; j < d; j++) {
+    row_next[j] = alpha * (s * dev[j]) + keep * row[j];
+    bad |= !is_finite(row_next[j]);
+  }
+  return bad;
+}
+
+/** zᵢ² per metric, 0 at or below the variance floor */
+static void zsq_scalar(const double *dev, const double *var, double *zsq,
+                       uint32_t d, double epsilon) {
+  uint32_t i;
+
+  for (i = 0; i < d; i++) {
+    double z = (var[i] > epsilon) ? abs_d(dev[i]) / sqrt(var[i]) : 0.0;
+    zsq[i] = z * z;
+  }
+}
+
+#if BASE_MULTI_X86
+
+/*
+ * AVX2 passes: 4 doubles per instruction, scalar tail. v - v is NaN
+ * exactly when v is NaN or ±∞, so one unordered compare per vector
+ * accumulates the finiteness check.
+ */
+
+__attribute__((target("avx2")))
+static inline __m256d avx2_bad(__m256d acc, __m256d v) {
+  __m256d t = _mm256_sub_pd(v, v);
+  return _mm256_or_pd(acc, _mm256_cmp_pd(t, t, _CMP_UNORD_Q));
+}
+
+__attribute__((target("avx2")))
+static unsigned ema_avx2(const double *x, const double *mu, double *mu_next,
+                         double *dev, uint32_t d, double alpha, double keep) {
+  const __m256d av = _mm256_set1_pd(alpha);
+  const __m256d kv = _mm256_set1_pd(keep);
+  __m256d bad = _mm256_setzero_pd();
+  uint32_t i;
+
+  for (i = 0; i + 4u <= d; i += 4u) {
+    __m256d xv = _mm256_loadu_pd(&x[i]);
+    __m256d mv = _mm256_loadu_pd(&mu[i]);
+    __m256d mn = _mm256_add_pd(_mm256_mul_pd(av, xv), _mm256_mul_pd(kv, mv));
+    _mm256_storeu_pd(&dev[i], _mm256_sub_pd(xv, mv));
+    _mm256_storeu_pd(&mu_next[i], mn);
+    bad = avx2_bad(bad, mn);
+  }
+  unsigned vbad = (unsigned)_mm256_movemask_pd(bad);
+  _mm256_zeroupper();
+  return vbad | ema_scalar(x + i, mu + i, mu_next + i, dev + i, d - i,
+                           alpha, keep);
+}
+
+__attribute__((target("avx2")))
+static unsigned square_avx2(const double *dev, const double *var,
+                            double *var_next, uint32_t d, double alpha,
+                            double keep) {
+  const __m256d av = _mm256_set1_pd(alpha);
+  const __m256d kv = _mm256_set1_pd(keep);
+  __m256d bad = _mm256_setzero_pd();
+  uint32_t i;
+
+  for (i = 0; i + 4u <= d; i += 4u) {
+    __m256d dv = _mm256_loadu_pd(&dev[i]);
+    __m256d vn = _mm256_add_pd(_mm256_mul_pd(av, _mm256_mul_pd(dv, dv)),
+                               _mm256_mul_pd(kv, _mm256_loadu_pd(&var[i])));
+    _mm256_storeu_pd(&var_next[i], vn);
+    bad = avx2_bad(bad, vn);
+  }
+  unsigned vbad = (unsigned)_mm256_movemask_pd(bad);
+  _mm256_zeroupper();
+  return vbad | square_scalar(dev + i, var + i, var_next + i, d - i,
+                              alpha, keep);
+}
+
+__attribute__((target("avx2")))
+static unsigned outer_avx2(double s, const double *dev, const double *row,
+                           double *row_next, uint32_t d, double alpha,
+                           double keep) {
+  const __m256d av = _mm256_set1_pd(alpha);
+  const __m256d kv = _mm256_set1_pd(keep);
+  const __m256d sv = _mm256_set1_pd(s);
+  __m256d bad = _mm256_setzero_pd();
+  uint32_t j;
+
+  for (j = 0; j + 4u <= d; j += 4u) {
+    __m256d p = _mm256_mul_pd(sv, _mm256_loadu_pd(&dev[j]));
+    __m256d cn = _mm256_add_pd(_mm256_mul_pd(av, p),
+                               _mm256_mul_pd(kv, _mm256_loadu_pd(&row[j])));
+    _mm256_storeu_pd(&row_next[j], cn);
+    bad = avx2_bad(bad, cn);
+  }
+  unsigned vbad = (unsigned)_mm256_movemask_pd(bad);
+  _mm256_zeroupper();
+  return vbad | outer_scalar(s, dev + j, row + j, row_next + j, d - j,
+                             alpha, keep);
+}
+
+/* √ and ÷ are correctly rounded in both paths: zᵢ² is bit-identical */
+__attribute__((target("avx2")))
+static void zsq_avx2(const double *dev, const double *var, double *zsq,
+                     uint32_t d, double epsilon) {
+  const __m256d ev = _mm256_set1_pd(epsilon);
+  const __m256d sign = _mm256_set1_pd(-0.0);
+  uint32_t i;
+
+  for (i = 0; i + 4u <= d; i += 4u) {
+    __m256d vv = _mm256_loadu_pd(&var[i]);
+    __m256d mag = _mm256_andnot_pd(sign, _mm256_loadu_pd(&dev[i]));
+    __m256d z = _mm256_div_pd(mag, _mm256_sqrt_pd(vv));
+    z = _mm256_and_pd(z, _mm256_cmp_pd(vv, ev, _CMP_GT_OQ));
+    _mm256_storeu_pd(&zsq[i], _mm256_mul_pd(z, z));
+  }
+  _mm256_zeroupper();
+  zsq_scalar(dev + i, var + i, zsq + i, d - i, epsilon);
+}
+
+#endif /* BASE_MULTI_X86 */
+
+/** μₜ and Σₜ into the spare buffers; nonzero if any is not finite */
+static unsigned update(base_multi_t *m, const double *x) {
+  const double alpha = m->cfg.alpha;
+  const double keep = 1.0 - alpha;
+  const uint32_t d = m->d;
+  unsigned bad;
+  uint32_t i;
+
+#if BASE_MULTI_X86
+  if (m->kernel == BASE_KERNEL_AVX2) {
+    bad = ema_avx2(x, m->mu, m->mu_next, m->dev, d, alpha, keep);
+    if (m->mode == BASE_MULTI_DIAG) {
+      return bad | square_avx2(m->dev, m->cov, m->cov_next, d, alpha, keep);
+    }
+    for (i = 0; i < d; i++) {
+      bad |= outer_avx2(m->dev[i], m->dev, m->cov + (size_t)i * d,
+                        m->cov_next + (size_t)i * d, d, alpha, keep);
+    }
+    return bad;
+  }
+#endif
+
+  bad = ema_scalar(x, m->mu, m->mu_next, m->dev, d, alpha, keep);
+  if (m->mode == BASE_MULTI_DIAG) {
+    return bad | square_scalar(m->dev, m->cov, m->cov_next, d, alpha, keep);
+  }
+  for (i = 0; i < d; i++) {
+    bad |= outer_scalar(m->dev[i], m->dev, m->cov + (size_t)i * d,
+                        m->cov_next + (size_t)i * d, d, alpha, keep);
+  }
+  return bad;
+}
+
+/** σ²ᵢ of metric i */
+static inline double var_of(const base_multi_t *m, uint32_t i) {
+  return (m->mode == BASE_MULTI_FULL) ? m->cov[(size_t)i * m->d + i]
+                                      : m->cov[i];
+}
+
+/**
+ * D² with a diagonal Σ: Σ zᵢ² over metrics above the floor. The zᵢ²
+ * are formed in mu_next (free once the new μ is swapped in) and summed
+ * in metric order.
+ */
+static double score_diag(const base_multi_t *m) {
+  double *zsq = m->mu_next;
+  double d2 = 0.0;
+  uint32_t i;
+
+#if BASE_MULTI_X86
+  if (m->kernel == BASE_KERNEL_AVX2) {
+    zsq_avx2(m->dev, m->cov, zsq, m->d, m->cfg.epsilon);
+  } else
+#endif
+  {
+    zsq_scalar(m->dev, m->cov, zsq, m->d, m->cfg.epsilon);
+  }
+  for (i = 0; i < m->d; i++) {
+    d2 += zsq[i];
+  }
+  return d2;
+}
+
+/**
+ * D² with the full Σ: Cholesky LLᵀ = Σ column by column, solving
+ * Ly = δ alongside. A pivot (the variance of metric j given metrics
+ * 0..j-1) at or below ε drops metric j: its column of L is zero.
+ *
+ * y is kept in mu_next, free once the new μ has been swapped in.
+ */
+static double score_full(const base_multi_t *m) {
+  const uint32_t d = m->d;
+  const double *c = m->cov;
+  double *l = m->chol;
+  double *y = m->mu_next;
+  double d2 = 0.0;
+  uint32_t i, j, k;
+
+  for (j = 0; j < d; j++) {
+    double pivot = c[(size_t)j * d + j];
+    double r = m->dev[j];
+
+    for (k = 0; k < j; k++) {
+      double ljk = l[(size_t)j * d + k];
+      pivot -= ljk * ljk;
+      r -= ljk * y[k];
+    }
+
+    if (!(pivot > m->cfg.epsilon)) {
+      for (i = j; i < d; i++) {
+        l[(size_t)i * d + j] = 0.0;
+      }
+      y[j] = 0.0;
+      continue;
+    }
+
+    double ljj = sqrt(pivot);
+    l[(size_t)j * d + j] = ljj;
+    for (i = j + 1u; i < d; i++) {
+      double s = c[(size_t)i * d + j];
+      for (k = 0; k < j; k++) {
+        s -= l[(size_t)i * d + k] * l[(size_t)j * d + k];
+      }
+      l[(size_t)i * d + j] = s / ljj;
+    }
+    y[j] = r / ljj;
+    d2 += y[j] * y[j];
+  }
+  return d2;
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t base_multi_bytes(uint32_t d, base_multi_mode_t mode) {
+  size_t c;
+
+  if (d == 0 || (mode != BASE_MULTI_DIAG && mode != BASE_MULTI_FULL)) {
+    return 0;
+  }
+  c = cov_len(d, mode);
+
+  /* mu × 2, dev, cov × 2, chol (FULL) */
+  if (c > ((size_t)-1 / sizeof(double) - 3u * (size_t)d) / 3u) {
+    return 0;
+  }
+  return (3u * (size_t)d + 2u * c +
+          ((mode == BASE_MULTI_FULL) ? c : 0u)) * sizeof(double);
+}
+
+int base_multi_init(base_multi_t *m, void *mem, size_t mem_size, uint32_t d,
+                    base_multi_mode_t mode, const base_config_t *cfg) {
+  base_fsm_t probe;
+  size_t need = base_multi_bytes(d, mode);
+  size_t c = cov_len(d, mode);
+  double *p = (double *)mem;
+
+  if (m == NULL || mem == NULL || cfg == NULL || need == 0 ||
+      mem_size < need || ((uintptr_t)mem % sizeof(double)) != 0) {
+    return -1;
+  }
+
+  /* C1-C4, exactly as base_init() checks them */
+  if (base_init(&probe, cfg) != 0) {
+    return -1;
+  }
+
+  m->cfg = *cfg;
+  m->mode = mode;
+  m->d = d;
+  m->mu = p;
+  m->mu_next = p + d;
+  m->dev = p + 2u * (size_t)d;
+  m->cov = p + 3u * (size_t)d;
+  m->cov_next = m->cov + c;
+  m->chol = (mode == BASE_MULTI_FULL) ? m->cov_next + c : NULL;
+
+  m->kernel = BASE_KERNEL_SCALAR;
+  (void)base_multi_set_kernel(m, BASE_KERNEL_AVX2);
+
+  base_multi_reset(m);
+  return 0;
+}
+
+base_result_t base_multi_step(base_multi_t *m, const double *x) {
+  base_result_t result = {0};
+  double *swap;
+  uint8_t ready;
+  uint32_t i;
+
+  /* Reentrancy check — CONTRACT enforcement (INV-4) */
+  if (m->in_step) {
+    m->fault_reentry = 1;
+    m->state = BASE_DEVIATION; /* INV-3: fault → DEVIATION */
+    result.state = m->state;
+    result.is_deviation = 1;
+    return result;
+  }
+  m->in_step = 1;
+
+  /*
+   * Statistics update into the spare buffers. A non-finite xᵢ always
+   * makes μ'ᵢ non-finite, so this is also the input check.
+   */
+  if (update(m, x)) {
+    m->fault_fp = 1;
+    m->state = BASE_DEVIATION; /* INV-3: fault → DEVIATION */
+    /* n, μ and Σ unchanged on fault (INV-7) */
+    result.state = m->state;
+    result.is_deviation = 1;
+    m->in_step = 0;
+    return result;
+  }
+
+  /* Commit state updates: swap the buffers */
+  swap = m->mu;
+  m->mu = m->mu_next;
+  m->mu_next = swap;
+  swap = m->cov;
+  m->cov = m->cov_next;
+  m->cov_next = swap;
+  m->n += 1; /* INV-7: monotonic increment on success */
+
+  /* Score D against Σ AFTER update; metrics below the floor drop out */
+  double d2 = (m->mode == BASE_MULTI_FULL) ? score_full(m) : score_diag(m);
+  double dist = sqrt(d2);
+  result.z = dist;
+
+  /* FSM Transitions, as base_step() */
+  ready = (m->n >= m->cfg.n_min);
+  for (i = 0; i < m->d && ready; i++) {
+    ready = var_of(m, i) > m->cfg.epsilon;
+  }
+
+  switch (m->state) {
+  case BASE_LEARNING:
+    if (ready) {
+      m->state = BASE_STABLE;
+    }
+    break;
+
+  case BASE_STABLE:
+    if (dist > m->cfg.k) {
+      m->state = BASE_DEVIATION;
+    }
+    break;
+
+  case BASE_DEVIATION:
+    if (!base_multi_faulted(m) && dist <= m->cfg.k) {
+      m->state = BASE_STABLE;
+    }
+    break;
+
+  default:
+    m->fault_fp = 1;
+    m->state = BASE_DEVIATION;
+    break;
+  }
+
+  result.state = m->state;
+  result.is_deviation = (m->state == BASE_DEVIATION) ? 1 : 0;
+
+  m->in_step = 0;
+  return result;
+}
+
+int base_multi_set_kernel(base_multi_t *m, base_kernel_t k) {
+  switch (k) {
+  case BASE_KERNEL_SCALAR:
+    break;
+#if BASE_MULTI_X86
+  case BASE_KERNEL_AVX2:
+    if (!__builtin_cpu_supports("avx2")) {
+      return -1;
+    }
+    break;
+#endif
+  default:
+    return -1;
+  }
+  m->kernel = k;
+  return 0;
+}
+
+void base_multi_reset(base_multi_t *m) {
+  size_t c = cov_len(m->d, m->mode);
+  size_t i;
+
+  /* Preserve configuration and memory; zero statistics */
+  for (i = 0; i < m->d; i++) {
+    m->mu[i] = 0.0;
+    m->dev[i] = 0.0;
+  }
+  for (i = 0; i < c; i++) {
+    m->cov[i] = 0.0;
+  }
+  m->n = 0;
+
+  /* Reset state */
+  m->state = BASE_LEARNING;
+
+  /* Clear faults (sticky until reset) */
+  m->fault_fp = 0;
+  m->fault_reentry = 0;
+
+  /* Clear atomicity guard */
+  m->in_step = 0;
+}
@@ -0,0 +1,411 @@
+/**
+ * baseline_robust.c - Sliding-Window Robust Normality Monitor Implementation
+ *
+ * Node i + 1 holds value[i]; node 0 is the head, present on every
+ * level. Each node owns one link per level, entries id · levels + ℓ,
+ * of which only the first height[id] are in use. The height is drawn
+ * when the node is inserted, from a xorshift64* generator reseeded by
+ * base_robust_reset(): geometric with p = 1/4, independent of the
+ * value and of the slot, and the same for the same input sequence.
+ *
+ * width(x, ℓ) is rank(next(x, ℓ)) - rank(x), with the head at rank 0
+ * and the end of the list at rank fill + 1. Ties are ordered by node
+ * id, so every node has a distinct key and eviction finds it exactly.
+ *
+ * See: baseline_robust.h for the algorithm
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "baseline_robust.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define NEXT(r, id, l)  ((r)->next[(size_t)(id) * (r)->levels + (l)])
+#define WIDTH(r, id, l) ((r)->width[(size_t)(id) * (r)->levels + (l)])
+
+#define ROBUST_SEED 0x9E3779B97F4A7C15ULL  /* Any nonzero constant */
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Check if value is finite (not NaN, not Inf) */
+static inline uint8_t is_finite(double x) { return isfinite(x) != 0; }
+
+/** Absolute value (avoid dependency on fabs for teaching clarity) */
+static inline double abs_d(double x) { return (x < 0.0) ? -x : x; }
+
+/** Levels needed for a window of w: 1 + ⌊log₄ w⌋ */
+static uint32_t levels_for(uint32_t w) {
+  uint32_t l = 1;
+
+  while (l < BASE_ROBUST_MAX_LEVELS && (w >> (2u * l)) != 0) {
+    l++;
+  }
+  return l;
+}
+
+/** Link entries of all nodes, head included, for a window of w */
+static size_t links_for(uint32_t w) {
+  return ((size_t)w + 1u) * levels_for(w);
+}
+
+/** Height of a new node: 1 plus the zero bit pairs of a random word */
+static uint32_t draw_levels(base_robust_t *r) {
+  uint64_t bits;
+  uint32_t l = 1;
+
+  /* xorshift64* */
+  r->rng ^= r->rng >> 12;
+  r->rng ^= r->rng << 25;
+  r->rng ^= r->rng >> 27;
+  bits = (r->rng * 0x2545F4914F6CDD1DULL) >> 32;
+
+  while (l < r->levels && (bits & 3u) == 0) {
+    bits >>= 2;
+    l++;
+  }
+  return l;
+}
+
+/** Key order: value, then node id */
+static inline uint8_t key_less(const base_robust_t *r, uint32_t a,
+                               uint32_t b) {
+  double va = r->value[a - 1];
+  double vb = r->value[b - 1];
+  return va < vb || (va == vb && a < b);
+}
+
+/** Predecessor of id on every level, and its rank */
+static void find_path(const base_robust_t *r, uint32_t id,
+                      uint32_t *upd, uint32_t *rank) {
+  uint32_t x = 0, pos = 0, nx;
+  uint32_t l = r->levels;
+
+  while (l-- > 0) {
+    while ((nx = NEXT(r, x, l)) != 0 && key_less(r, nx, id)) {
+      pos += WIDTH(r, x, l);
+      x = nx;
+    }
+    upd[l] = x;
+    rank[l] = pos;
+  }
+}
+
+static void list_insert(base_robust_t *r, uint32_t id) {
+  uint32_t upd[BASE_ROBUST_MAX_LEVELS], rank[BASE_ROBUST_MAX_LEVELS];
+  uint32_t l, lv = draw_levels(r);
+
+  r->height[id] = (uint8_t)lv;
+  find_path(r, id, upd, rank);
+  for (l = 0; l < r->levels; l++) {
+    if (l < lv) {
+      uint32_t skipped = rank[0] - rank[l];
+      NEXT(r, id, l) = NEXT(r, upd[l], l);
+      WIDTH(r, id, l) = WIDTH(r, upd[l], l) - skipped;
+      NEXT(r, upd[l], l) = id;
+      WIDTH(r, upd[l], l) = skipped + 1u;
+    } else {
+      WIDTH(r, upd[l], l) += 1u;
+    }
+  }
+  r->fill++;
+}
+
+static void list_remove(base_robust_t *r, uint32_t id) {
+  uint32_t upd[BASE_ROBUST_MAX_LEVELS], rank[BASE_ROBUST_MAX_LEVELS];
+  uint32_t l, lv = r->height[id];
+
+  find_path(r, id, upd, rank);
+  for (l = 0; l < r->levels; l++) {
+    if (l < lv) {
+      WIDTH(r, upd[l], l) += WIDTH(r, id, l) - 1u;
+      NEXT(r, upd[l], l) = NEXT(r, id, l);
+    } else {
+      WIDTH(r, upd[l], l) -= 1u;
+    }
+  }
+  r->fill--;
+}
+
+/** Value of rank k, 1 ≤ k ≤ fill */
+static double list_select(const base_robust_t *r, uint32_t k) {
+  uint32_t x = 0, pos = 0, nx;
+  uint32_t l = r->levels;
+
+  while (l-- > 0) {
+    while ((nx = NEXT(r, x, l)) != 0 && pos + WIDTH(r, x, l) <= k) {
+      pos += WIDTH(r, x, l);
+      x = nx;
+    }
+  }
+  return r->value[x - 1];
+}
+
+/** Midpoint that cannot overflow */
+static inline double mid(double a, double b) { return 0.5 * a + 0.5 * b; }
+
+/*
+ * Deviations from m of ranks p, p-1, … 1 (A, ascending) and p+1 … fill
+ * (B, ascending), where p = ⌈fill/2⌉ and every value of rank ≤ p is
+ * ≤ m ≤ every value of rank > p. A₀ = B₀ = -∞; past the end, +∞.
+ */
+static inline double dev_a(const base_robust_t *r, double m, uint32_t p,
+                           uint32_t i) {
+  if (i == 0) {
+    return -INFINITY;
+  }
+  return (i > p) ? INFINITY : m - list_select(r, p + 1u - i);
+}
+
+static inline double dev_b(const base_robust_t *r, double m, uint32_t p,
+                           uint32_t j) {
+  if (j == 0) {
+    return -INFINITY;
+  }
+  return (j > r->fill - p) ? INFINITY : list_select(r, p + j) - m;
+}
+
+/**
+ * Median of |x - m| over the window: the k-th smallest of A ∪ B.
+ *
+ * The split i (i from A, k - i from B) is the smallest with
+ * A(i+1) ≥ B(k-i); the k-th is then max(A(i), B(k-i)) and the
+ * (k+1)-th min(A(i+1), B(k-i+1)).
+ */
+static double window_mad(const base_robust_t *r, double m) {
+  uint32_t c = r->fill;
+  uint32_t p = (c + 1u) / 2u;
+  uint32_t k = (c + 1u) / 2u;
+  uint32_t lo = (k > c - p) ? k - (c - p) : 0u;
+  uint32_t hi = (k < p) ? k : p;
+  double kth, a1, b1;
+
+  while (lo < hi) {
+    uint32_t i = lo + (hi - lo) / 2u;
+    if (dev_a(r, m, p, i + 1u) < dev_b(r, m, p, k - i)) {
+      lo = i + 1u;
+    } else {
+      hi = i;
+    }
+  }
+
+  a1 = dev_a(r, m, p, lo);
+  b1 = dev_b(r, m, p, k - lo);
+  kth = (a1 > b1) ? a1 : b1;
+  if (c & 1u) {
+    return kth;
+  }
+  a1 = dev_a(r, m, p, lo + 1u);
+  b1 = dev_b(r, m, p, k - lo + 1u);
+  return mid(kth, (a1 < b1) ? a1 : b1);
+}
+
+/** Window median */
+static double window_median(const base_robust_t *r) {
+  uint32_t c = r->fill;
+
+  if (c & 1u) {
+    return list_select(r, (c + 1u) / 2u);
+  }
+  return mid(list_select(r, c / 2u), list_select(r, c / 2u + 1u));
+}
+
+/** Empty list: head links to the end on every level */
+static void list_clear(base_robust_t *r) {
+  uint32_t l;
+
+  for (l = 0; l < r->levels; l++) {
+    NEXT(r, 0u, l) = 0;
+    WIDTH(r, 0u, l) = 1;
+  }
+  r->fill = 0;
+  r->slot = 0;
+  r->rng = ROBUST_SEED;
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t base_robust_bytes(uint32_t window) {
+  size_t links;
+
+  if (window < 3u) {
+    return 0;
+  }
+  links = links_for(window);
+  if (links > ((size_t)-1 - (size_t)window * (sizeof(double) + 1u) - 1u) /
+                  (2u * sizeof(uint32_t))) {
+    return 0;
+  }
+  /* value[w], next[links], width[links], height[w + 1] */
+  return (size_t)window * sizeof(double) + 2u * links * sizeof(uint32_t) +
+         (size_t)window + 1u;
+}
+
+int base_robust_init(base_robust_t *r, void *mem, size_t mem_size,
+                     const base_robust_config_t *cfg) {
+  size_t need, links;
+
+  if (r == NULL || mem == NULL || cfg == NULL) {
+    return -1;
+  }
+
+  /* R1: window >= 3; R4: n_min >= window */
+  need = base_robust_bytes(cfg->window);
+  if (need == 0 || mem_size < need || cfg->n_min < cfg->window) {
+    return -1;
+  }
+
+  /* R2: epsilon > 0; R3: k > 0 */
+  if (!(cfg->epsilon > 0.0) || !(cfg->k > 0.0)) {
+    return -1;
+  }
+  if (((uintptr_t)mem % sizeof(double)) != 0) {
+    return -1;
+  }
+
+  r->cfg = *cfg;
+  r->levels = levels_for(cfg->window);
+  links = links_for(cfg->window);
+  r->value = (double *)mem;
+  r->next = (uint32_t *)(r->value + cfg->window);
+  r->width = r->next + links;
+  r->height = (uint8_t *)(r->width + links);
+
+  base_robust_reset(r);
+  return 0;
+}
+
+base_result_t base_robust_step(base_robust_t *r, double x) {
+  base_result_t result = {0};
+  uint32_t id = r->slot + 1u;
+  uint8_t evicted = (r->fill == r->cfg.window);
+  double old = r->value[r->slot];
+
+  /* Reentrancy check — CONTRACT enforcement (INV-4) */
+  if (r->in_step) {
+    r->fault_reentry = 1;
+    r->state = BASE_DEVIATION; /* INV-3: fault → DEVIATION */
+    result.state = r->state;
+    result.is_deviation = 1;
+    return result;
+  }
+  r->in_step = 1;
+
+  /* Input validation — fault_fp on NaN/Inf, window unchanged */
+  if (!is_finite(x)) {
+    r->fault_fp = 1;
+    r->state = BASE_DEVIATION; /* INV-3: fault → DEVIATION */
+    result.state = r->state;
+    result.is_deviation = 1;
+    r->in_step = 0;
+    return result;
+  }
+
+  /* Step 1: deviation using mₜ₋₁ */
+  double deviation = x - r->median;
+
+  /* Step 2: slide the window */
+  if (evicted) {
+    list_remove(r, id);
+  }
+  r->value[r->slot] = x;
+  list_insert(r, id);
+
+  /* Steps 3-4: median, MAD and σ̂ of the new window */
+  double median = window_median(r);
+  double mad = window_mad(r, median);
+  double sigma = BASE_ROBUST_MAD_SCALE * mad;
+
+  /* A finite window can still overflow x - m: undo the slide */
+  if (!is_finite(deviation) || !is_finite(sigma)) {
+    list_remove(r, id);
+    r->value[r->slot] = old;
+    if (evicted) {
+      list_insert(r, id);
+    }
+    r->fault_fp = 1;
+    r->state = BASE_DEVIATION;
+    result.state = r->state;
+    result.is_deviation = 1;
+    r->in_step = 0;
+    return result;
+  }
+
+  /* Commit state updates */
+  r->slot = (r->slot + 1u == r->cfg.window) ? 0u : r->slot + 1u;
+  r->median = median;
+  r->mad = mad;
+  r->sigma = sigma;
+  r->n += 1; /* INV-7: monotonic increment on success */
+
+  /* Step 5: compute z-score */
+  double z;
+  if (sigma * sigma <= r->cfg.epsilon) {
+    /* σ̂² floor: over half the window is one value */
+    z = 0.0;
+  } else {
+    z = abs_d(deviation) / sigma;
+  }
+
+  result.deviation = deviation;
+  result.z = z;
+
+  /* FSM Transitions, as base_step() */
+  switch (r->state) {
+  case BASE_LEARNING:
+    if (base_robust_ready(r)) {
+      r->state = BASE_STABLE;
+    }
+    break;
+
+  case BASE_STABLE:
+    if (z > r->cfg.k) {
+      r->state = BASE_DEVIATION;
+    }
+    break;
+
+  case BASE_DEVIATION:
+    if (!base_robust_faulted(r) && z <= r->cfg.k) {
+      r->state = BASE_STABLE;
+    }
+    break;
+
+  default:
+    r->fault_fp = 1;
+    r->state = BASE_DEVIATION;
+    break;
+  }
+
+  result.state = r->state;
+  result.is_deviation = (r->state == BASE_DEVIATION) ? 1 : 0;
+
+  r->in_step = 0;
+  return result;
+}
+
+void base_robust_reset(base_robust_t *r) {
+  /* Preserve configuration and memory; empty the window */
+  list_clear(r);
+
+  /* Clear statistics */
+  r->median = 0.0;
+  r->mad = 0.0;
+  r->sigma = 0.0;
+  r->n = 0;
+
+  /* Reset state */
+  r->state = BASE_LEARNING;
+
+  /* Clear faults (sticky until reset) */
+  r->fault_fp = 0;
+  r->fault_reentry = 0;
+
+  /* Clear atomicity guard */
+  r->in_step = 0;
+}
@@ -0,0 +1,103 @@
+/**
+ * baseline_sketch.c - z-Score Distribution Sketch Implementation
+ *
+ * Recording is inline in baseline_sketch.h; this file holds the bulk
+ * recorders, merge and the quantile walk.
+ *
+ * See: baseline_sketch.h for the bucket layout
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "baseline_sketch.h"
+#include <math.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#define SUB_COUNT (1u << BASE_SKETCH_SUB_BITS)
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Midpoint of bucket i, which holds no z above max */
+static double bucket_value(uint32_t i, double max) {
+  double mid;
+
+  if (i == BASE_SKETCH_BUCKETS - 1) {
+    return max; /* Overflow: the exact maximum */
+  }
+  if (i == 0) {
+    mid = ldexp(1.0, BASE_SKETCH_MIN_EXP - 1);
+  } else {
+    uint32_t j = i - 1;
+    int e = BASE_SKETCH_MIN_EXP + (int)(j >> BASE_SKETCH_SUB_BITS);
+    double m = (double)(j & (SUB_COUNT - 1)) + 0.5;
+    mid = ldexp(1.0 + m / SUB_COUNT, e);
+  }
+  return (mid < max) ? mid : max;
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+void base_sketch_init(base_sketch_t *s) {
+  if (!s) return;
+  memset(s, 0, sizeof(*s));
+}
+
+void base_sketch_add_batch(base_sketch_t *s, const double *z, size_t n) {
+  size_t i;
+
+  if (!s || !z) return;
+  for (i = 0; i < n; i++) {
+    base_sketch_add(s, z[i]);
+  }
+}
+
+void base_sketch_add_each(base_sketch_t *s, const double *z, size_t n) {
+  size_t i;
+
+  if (!s || !z) return;
+  for (i = 0; i < n; i++) {
+    base_sketch_add(&s[i], z[i]);
+  }
+}
+
+void base_sketch_merge(base_sketch_t *dst, const base_sketch_t *src) {
+  uint32_t i;
+
+  if (!dst || !src) return;
+  for (i = 0; i < BASE_SKETCH_BUCKETS; i++) {
+    dst->bucket[i] += src->bucket[i];
+  }
+  if (src->count > 0 && (dst->count == 0 || src->max > dst->max)) {
+    dst->max = src->max;
+  }
+  dst->count += src->count;
+  dst->unscored += src->unscored;
+}
+
+double base_sketch_quantile(const base_sketch_t *s, double q) {
+  uint64_t rank, seen = 0;
+  uint32_t i;
+
+  if (!s || s->count == 0 || !(q >= 0.0 && q <= 1.0)) {
+    return NAN;
+  }
+
+  rank = (uint64_t)ceil(q * (double)s->count);
+  rank = (rank < 1) ? 1 : rank;
+  rank = (rank > s->count) ? s->count : rank;
+
+  for (i = 0; i < BASE_SKETCH_BUCKETS; i++) {
+    seen += s->bucket[i];
+    if (seen >= rank) {
+      return bucket_value(i, s->max);
+    }
+  }
+  return s->max; /* Unreachable while INV-1 holds */
+}
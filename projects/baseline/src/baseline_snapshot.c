@@ -0,0 +1,375 @@
+/**
+ * baseline_snapshot.c - Persistent Fleet Snapshots Implementation
+ *
+ * Save copies the seven columns into the payload back to back and
+ * checksums them; load checks the header, the checksum and every
+ * stream's invariants against the buffer, and only then copies the
+ * columns into the fleet. Columns are read from the buffer with
+ * memcpy, so a snapshot may sit at any alignment.
+ *
+ * CRC-32C uses the SSE4.2 crc32 instruction when the CPU has it,
+ * eight bytes per instruction; otherwise a byte-wise table.
+ *
+ * See: baseline_snapshot.h for the format
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "baseline_snapshot.h"
+#include <math.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BASE_CRC_X86 1
+#include <immintrin.h>
+#else
+#define BASE_CRC_X86 0
+#endif
+
+#if defined(BASE_FIXED_POINT)
+#define VALUE_KIND 2u
+#elif defined(BASE_FLOAT32)
+#define VALUE_KIND 1u
+#else
+#define VALUE_KIND 0u
+#endif
+
+/* Header field offsets (see baseline_snapshot.h) */
+#define OFF_MAGIC        0u
+#define OFF_VERSION      4u
+#define OFF_KIND         6u
+#define OFF_VALUE_SIZE   7u
+#define OFF_N            8u
+#define OFF_ALPHA       16u
+#define OFF_EPSILON     24u
+#define OFF_K           32u
+#define OFF_N_MIN       40u
+#define OFF_PAYLOAD_CRC 44u
+#define OFF_PAYLOAD     48u
+#define OFF_HEADER_CRC  56u
+
+/*---------------------------------------------------------------------------
+ * CRC-32C
+ *---------------------------------------------------------------------------*/
+
+/** Reflected Castagnoli polynomial 0x82F63B78, one byte per step */
+static const uint32_t crc_table[256] = {
+    0x00000000u, 0xF26B8303u, 0xE13B70F7u, 0x1350F3F4u,
+    0xC79A971Fu, 0x35F1141Cu, 0x26A1E7E8u, 0xD4CA64EBu,
+    0x8AD958CFu, 0x78B2DBCCu, 0x6BE22838u, 0x9989AB3Bu,
+    0x4D43CFD0u, 0xBF284CD3u, 0xAC78BF27u, 0x5E133C24u,
+    0x105EC76Fu, 0xE235446Cu, 0xF165B798u, 0x030E349Bu,
+    0xD7C45070u, 0x25AFD373u, 0x36FF2087u, 0xC494A384u,
+    0x9A879FA0u, 0x68EC1CA3u, 0x7BBCEF57u, 0x89D76C54u,
+    0x5D1D08BFu, 0xAF768BBCu, 0xBC267848u, 0x4E4DFB4Bu,
+    0x20BD8EDEu, 0xD2D60DDDu, 0xC186FE29u, 0x33ED7D2Au,
+    0xE72719C1u, 0x154C9AC2u, 0x061C6936u, 0xF477EA35u,
+    0xAA64D611u, 0x580F5512u, 0x4B5FA6E6u, 0xB93425E5u,
+    0x6DFE410Eu, 0x9F95C20Du, 0x8CC531F9u, 0x7EAEB2FAu,
+    0x30E349B1u, 0xC288CAB2u, 0xD1D83946u, 0x23B3BA45u,
+    0xF779DEAEu, 0x05125DADu, 0x1642AE59u, 0xE4292D5Au,
+    0xBA3A117Eu, 0x4851927Du, 0x5B016189u, 0xA96AE28Au,
+    0x7DA08661u, 0x8FCB0562u, 0x9C9BF696u, 0x6EF07595u,
+    0x417B1DBCu, 0xB3109EBFu, 0xA0406D4Bu, 0x522BEE48u,
+    0x86E18AA3u, 0x748A09A0u, 0x67DAFA54u, 0x95B17957u,
+    0xCBA24573u, 0x39C9C670u, 0x2A993584u, 0xD8F2B687u,
+    0x0C38D26Cu, 0xFE53516Fu, 0xED03A29Bu, 0x1F682198u,
+    0x5125DAD3u, 0xA34E59D0u, 0xB01EAA24u, 0x42752927u,
+    0x96BF4DCCu, 0x64D4CECFu, 0x77843D3Bu, 0x85EFBE38u,
+    0xDBFC821Cu, 0x2997011Fu, 0x3AC7F2EBu, 0xC8AC71E8u,
+    0x1C661503u, 0xEE0D9600u, 0xFD5D65F4u, 0x0F36E6F7u,
+    0x61C69362u, 0x93AD1061u, 0x80FDE395u, 0x72966096u,
+    0xA65C047Du, 0x5437877Eu, 0x4767748Au, 0xB50CF789u,
+    0xEB1FCBADu, 0x197448AEu, 0x0A24BB5Au, 0xF84F3859u,
+    0x2C855CB2u, 0xDEEEDFB1u, 0xCDBE2C45u, 0x3FD5AF46u,
+    0x7198540Du, 0x83F3D70Eu, 0x90A324FAu, 0x62C8A7F9u,
+    0xB602C312u, 0x44694011u, 0x5739B3E5u, 0xA55230E6u,
+    0xFB410CC2u, 0x092A8FC1u, 0x1A7A7C35u, 0xE811FF36u,
+    0x3CDB9BDDu, 0xCEB018DEu, 0xDDE0EB2Au, 0x2F8B6829u,
+    0x82F63B78u, 0x709DB87Bu, 0x63CD4B8Fu, 0x91A6C88Cu,
+    0x456CAC67u, 0xB7072F64u, 0xA457DC90u, 0x563C5F93u,
+    0x082F63B7u, 0xFA44E0B4u, 0xE9141340u, 0x1B7F9043u,
+    0xCFB5F4A8u, 0x3DDE77ABu, 0x2E8E845Fu, 0xDCE5075Cu,
+    0x92A8FC17u, 0x60C37F14u, 0x73938CE0u, 0x81F80FE3u,
+    0x55326B08u, 0xA759E80Bu, 0xB4091BFFu, 0x466298FCu,
+    0x1871A4D8u, 0xEA1A27DBu, 0xF94AD42Fu, 0x0B21572Cu,
+    0xDFEB33C7u, 0x2D80B0C4u, 0x3ED04330u, 0xCCBBC033u,
+    0xA24BB5A6u, 0x502036A5u, 0x4370C551u, 0xB11B4652u,
+    0x65D122B9u, 0x97BAA1BAu, 0x84EA524Eu, 0x7681D14Du,
+    0x2892ED69u, 0xDAF96E6Au, 0xC9A99D9Eu, 0x3BC21E9Du,
+    0xEF087A76u, 0x1D63F975u, 0x0E330A81u, 0xFC588982u,
+    0xB21572C9u, 0x407EF1CAu, 0x532E023Eu, 0xA145813Du,
+    0x758FE5D6u, 0x87E466D5u, 0x94B49521u, 0x66DF1622u,
+    0x38CC2A06u, 0xCAA7A905u, 0xD9F75AF1u, 0x2B9CD9F2u,
+    0xFF56BD19u, 0x0D3D3E1Au, 0x1E6DCDEEu, 0xEC064EEDu,
+    0xC38D26C4u, 0x31E6A5C7u, 0x22B65633u, 0xD0DDD530u,
+    0x0417B1DBu, 0xF67C32D8u, 0xE52CC12Cu, 0x1747422Fu,
+    0x49547E0Bu, 0xBB3FFD08u, 0xA86F0EFCu, 0x5A048DFFu,
+    0x8ECEE914u, 0x7CA56A17u, 0x6FF599E3u, 0x9D9E1AE0u,
+    0xD3D3E1ABu, 0x21B862A8u, 0x32E8915Cu, 0xC083125Fu,
+    0x144976B4u, 0xE622F5B7u, 0xF5720643u, 0x07198540u,
+    0x590AB964u, 0xAB613A67u, 0xB831C993u, 0x4A5A4A90u,
+    0x9E902E7Bu, 0x6CFBAD78u, 0x7FAB5E8Cu, 0x8DC0DD8Fu,
+    0xE330A81Au, 0x115B2B19u, 0x020BD8EDu, 0xF0605BEEu,
+    0x24AA3F05u, 0xD6C1BC06u, 0xC5914FF2u, 0x37FACCF1u,
+    0x69E9F0D5u, 0x9B8273D6u, 0x88D28022u, 0x7AB90321u,
+    0xAE7367CAu, 0x5C18E4C9u, 0x4F48173Du, 0xBD23943Eu,
+    0xF36E6F75u, 0x0105EC76u, 0x12551F82u, 0xE03E9C81u,
+    0x34F4F86Au, 0xC69F7B69u, 0xD5CF889Du, 0x27A40B9Eu,
+    0x79B737BAu, 0x8BDCB4B9u, 0x988C474Du, 0x6AE7C44Eu,
+    0xBE2DA0A5u, 0x4C4623A6u, 0x5F16D052u, 0xAD7D5351u
+};
+
+static uint32_t crc_table_update(uint32_t crc, const unsigned char *p,
+                                 size_t len) {
+  while (len--) {
+    crc = crc_table[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+  }
+  return crc;
+}
+
+#if BASE_CRC_X86 && defined(__x86_64__)
+
+__attribute__((target("sse4.2")))
+static uint32_t crc_sse42_update(uint32_t crc, const unsigned char *p,
+                                 size_t len) {
+  uint64_t c = crc;
+
+  while (len >= 8u) {
+    uint64_t word;
+    memcpy(&word, p, sizeof(word));
+    c = _mm_crc32_u64(c, word);
+    p += 8;
+    len -= 8u;
+  }
+  crc = (uint32_t)c;
+  while (len--) {
+    crc = _mm_crc32_u8(crc, *p++);
+  }
+  return crc;
+}
+
+#endif
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Layout of the payload of n streams */
+typedef struct {
+  size_t mu, variance, sigma, count, state, fault_fp, fault_reentry, end;
+} payload_layout_t;
+
+static payload_layout_t payload_layout(size_t n) {
+  payload_layout_t l;
+  l.mu = BASE_SNAPSHOT_HEADER;
+  l.variance = l.mu + n * sizeof(base_value_t);
+  l.sigma = l.variance + n * sizeof(base_value_t);
+  l.count = l.sigma + n * sizeof(base_value_t);
+  l.state = l.count + n * sizeof(uint32_t);
+  l.fault_fp = l.state + n;
+  l.fault_reentry = l.fault_fp + n;
+  l.end = l.fault_reentry + n;
+  return l;
+}
+
+static inline void put32(unsigned char *p, size_t off, uint32_t v) {
+  memcpy(p + off, &v, sizeof(v));
+}
+
+static inline void put64(unsigned char *p, size_t off, uint64_t v) {
+  memcpy(p + off, &v, sizeof(v));
+}
+
+static inline uint32_t get32(const unsigned char *p, size_t off) {
+  uint32_t v;
+  memcpy(&v, p + off, sizeof(v));
+  return v;
+}
+
+static inline uint64_t get64(const unsigned char *p, size_t off) {
+  uint64_t v;
+  memcpy(&v, p + off, sizeof(v));
+  return v;
+}
+
+static inline double get_double(const unsigned char *p, size_t off) {
+  double v;
+  memcpy(&v, p + off, sizeof(v));
+  return v;
+}
+
+static inline base_value_t get_value(const unsigned char *p, size_t off) {
+  base_value_t v;
+  memcpy(&v, p + off, sizeof(v));
+  return v;
+}
+
+/** INV-5 and INV-6 for one stream, in the column precision */
+static uint8_t stats_valid(base_value_t mu, base_value_t var,
+                           base_value_t sigma) {
+#if defined(BASE_FIXED_POINT)
+  /* σ = ⌊√σ²⌋ in Q16.16: σ² ≤ var·2¹⁶ < (σ+1)² */
+  uint64_t wide = (uint64_t)(int64_t)var << 16;
+  uint64_t s = (uint64_t)(int64_t)sigma;
+  (void)mu;
+  return var >= 0 && sigma >= 0 && s * s <= wide && (s + 1u) * (s + 1u) > wide;
+#elif defined(BASE_FLOAT32)
+  return isfinite(mu) && isfinite(var) && var >= 0.0f && sigma == sqrtf(var);
+#else
+  return isfinite(mu) && isfinite(var) && var >= 0.0 && sigma == sqrt(var);
+#endif
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+uint32_t base_crc32c(uint32_t crc, const void *data, size_t len) {
+  const unsigned char *p = (const unsigned char *)data;
+
+  crc = ~crc;
+#if BASE_CRC_X86 && defined(__x86_64__)
+  if (__builtin_cpu_supports("sse4.2")) {
+    return ~crc_sse42_update(crc, p, len);
+  }
+#endif
+  return ~crc_table_update(crc, p, len);
+}
+
+size_t base_snapshot_bytes(size_t n) {
+  size_t per = 3u * sizeof(base_value_t) + sizeof(uint32_t) + 3u;
+
+  if (n == 0 || n > ((size_t)-1 - BASE_SNAPSHOT_HEADER) / per) {
+    return 0;
+  }
+  return BASE_SNAPSHOT_HEADER + n * per;
+}
+
+base_snap_error_t base_snapshot_save(const base_fleet_t *f, void *buf,
+                                     size_t buf_size) {
+  unsigned char *p = (unsigned char *)buf;
+  size_t need;
+  payload_layout_t l;
+  uint16_t version = BASE_SNAPSHOT_VERSION;
+
+  if (f == NULL || buf == NULL) {
+    return BASE_SNAP_ERR_NULL;
+  }
+  if (f->in_step) {
+    return BASE_SNAP_ERR_BUSY;
+  }
+  need = base_snapshot_bytes(f->n);
+  if (need == 0 || buf_size < need) {
+    return BASE_SNAP_ERR_SIZE;
+  }
+  l = payload_layout(f->n);
+
+  /* Payload: the columns, back to back */
+  memcpy(p + l.mu, f->mu, f->n * sizeof(base_value_t));
+  memcpy(p + l.variance, f->variance, f->n * sizeof(base_value_t));
+  memcpy(p + l.sigma, f->sigma, f->n * sizeof(base_value_t));
+  memcpy(p + l.count, f->count, f->n * sizeof(uint32_t));
+  memcpy(p + l.state, f->state, f->n);
+  memcpy(p + l.fault_fp, f->fault_fp, f->n);
+  memcpy(p + l.fault_reentry, f->fault_reentry, f->n);
+
+  /* Header */
+  memset(p, 0, BASE_SNAPSHOT_HEADER);
+  put32(p, OFF_MAGIC, BASE_SNAPSHOT_MAGIC);
+  memcpy(p + OFF_VERSION, &version, sizeof(version));
+  p[OFF_KIND] = (unsigned char)VALUE_KIND;
+  p[OFF_VALUE_SIZE] = (unsigned char)sizeof(base_value_t);
+  put64(p, OFF_N, (uint64_t)f->n);
+  memcpy(p + OFF_ALPHA, &f->cfg.alpha, sizeof(double));
+  memcpy(p + OFF_EPSILON, &f->cfg.epsilon, sizeof(double));
+  memcpy(p + OFF_K, &f->cfg.k, sizeof(double));
+  put32(p, OFF_N_MIN, f->cfg.n_min);
+  put32(p, OFF_PAYLOAD_CRC,
+        base_crc32c(0, p + BASE_SNAPSHOT_HEADER, l.end - BASE_SNAPSHOT_HEADER));
+  put64(p, OFF_PAYLOAD, (uint64_t)(l.end - BASE_SNAPSHOT_HEADER));
+  put32(p, OFF_HEADER_CRC, base_crc32c(0, p, OFF_HEADER_CRC));
+
+  return BASE_SNAP_OK;
+}
+
+base_snap_error_t base_snapshot_load(base_fleet_t *f, const void *buf,
+                                     size_t size) {
+  const unsigned char *p = (const unsigned char *)buf;
+  payload_layout_t l;
+  uint16_t version;
+  size_t i;
+
+  if (f == NULL || buf == NULL) {
+    return BASE_SNAP_ERR_NULL;
+  }
+  if (f->in_step) {
+    return BASE_SNAP_ERR_BUSY;
+  }
+  if (size < BASE_SNAPSHOT_HEADER) {
+    return BASE_SNAP_ERR_SIZE;
+  }
+
+  /* Header: format first, then integrity, then compatibility */
+  memcpy(&version, p + OFF_VERSION, sizeof(version));
+  if (get32(p, OFF_MAGIC) != BASE_SNAPSHOT_MAGIC ||
+      version != BASE_SNAPSHOT_VERSION || p[OFF_KIND] != VALUE_KIND ||
+      p[OFF_VALUE_SIZE] != sizeof(base_value_t)) {
+    return BASE_SNAP_ERR_FORMAT;
+  }
+  if (get32(p, OFF_HEADER_CRC) != base_crc32c(0, p, OFF_HEADER_CRC)) {
+    return BASE_SNAP_ERR_CRC;
+  }
+  if (get64(p, OFF_N) != (uint64_t)f->n ||
+      get_double(p, OFF_ALPHA) != f->cfg.alpha ||
+      get_double(p, OFF_EPSILON) != f->cfg.epsilon ||
+      get_double(p, OFF_K) != f->cfg.k ||
+      get32(p, OFF_N_MIN) != f->cfg.n_min) {
+    return BASE_SNAP_ERR_CONFIG;
+  }
+  l = payload_layout(f->n);
+  if (get64(p, OFF_PAYLOAD) != (uint64_t)(l.end - BASE_SNAPSHOT_HEADER)) {
+    return BASE_SNAP_ERR_FORMAT;
+  }
+  if (size < l.end) {
+    return BASE_SNAP_ERR_SIZE;
+  }
+  if (get32(p, OFF_PAYLOAD_CRC) !=
+      base_crc32c(0, p + BASE_SNAPSHOT_HEADER, l.end - BASE_SNAPSHOT_HEADER)) {
+    return BASE_SNAP_ERR_CRC;
+  }
+
+  /* Every stream's invariants, before anything is written */
+  for (i = 0; i < f->n; i++) {
+    uint8_t st = p[l.state + i];
+    uint8_t ffp = p[l.fault_fp + i];
+    uint8_t fre = p[l.fault_reentry + i];
+    size_t off = i * sizeof(base_value_t);
+
+    if (st > (uint8_t)BASE_DEVIATION ||                        /* INV-1 */
+        ffp > 1u || fre > 1u ||
+        ((ffp || fre) && st != (uint8_t)BASE_DEVIATION) ||     /* INV-3 */
+        !stats_valid(get_value(p, l.mu + off),                  /* INV-5 */
+                     get_value(p, l.variance + off),            /* INV-6 */
+                     get_value(p, l.sigma + off))) {
+      return BASE_SNAP_ERR_STATE;
+    }
+    /* INV-2: out of LEARNING only with n_min observations behind it */
+    if (!ffp && !fre && st != (uint8_t)BASE_LEARNING &&
+        get32(p, l.count + i * sizeof(uint32_t)) < f->cfg.n_min) {
+      return BASE_SNAP_ERR_STATE;
+    }
+  }
+
+  /* Commit */
+  memcpy(f->mu, p + l.mu, f->n * sizeof(base_value_t));
+  memcpy(f->variance, p + l.variance, f->n * sizeof(base_value_t));
+  memcpy(f->sigma, p + l.sigma, f->n * sizeof(base_value_t));
+  memcpy(f->count, p + l.count, f->n * sizeof(uint32_t));
+  memcpy(f->state, p + l.state, f->n);
+  memcpy(f->fault_fp, p + l.fault_fp, f->n);
+  memcpy(f->fault_reentry, p + l.fault_reentry, f->n);
+
+  return BASE_SNAP_OK;
+}
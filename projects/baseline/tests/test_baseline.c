@@ -21,6 +21,43 @@
  *   Random streams
  *   NaN injection
  *   Edge cases
+ *
+ * Batch Tests:
+ *   base_step_batch equals a base_step loop
+ *
+ * Fast Path Tests:
+ *   base_step_fast decides as base_step, σ and z on demand
+ *
+ * Timed Tests:
+ *   base_step_at with regular timestamps equals base_step
+ *   Table decay matches pow; repeated timestamps carry no weight
+ *
+ * Robust Tests:
+ *   Skip-list median and MAD equal the re-sorted window
+ *   Outlier bursts ignored; faults leave the window intact
+ *   Periodic input keeps the skip list balanced
+ *
+ * Multivariate Tests:
+ *   Per-metric μ and σ² equal base_step; kernels agree
+ *   Full covariance catches a broken correlation
+ *
+ * Sketch Tests:
+ *   p50/p99/p999 within 2⁻⁵ of the sorted z
+ *   Merged streams equal one sketch; step unchanged
+ *
+ * Backfill Tests:
+ *   Parallel scan equals a base_step loop (to rounding)
+ *   Overflow, reentrancy and short series fall back exactly
+ *
+ * Fleet Tests:
+ *   Every kernel equals base_step per stream
+ *   Reduced-precision columns stay within their error bounds
+ *   Faults stay in their lane
+ *
+ * Snapshot Tests:
+ *   Save and load restore every stream bit for bit
+ *   Quiet streams with σ² below ε round-trip
+ *   Corrupt, foreign, mismatched and invalid snapshots are rejected
  * 
  * Copyright (c) 2025 William Murray
  * MIT License - https://github.com/williamofai/c-from-scratch
@@ -29,9 +66,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <float.h>
 #include <assert.h>
+#include <string.h>
 #include <time.h>
 #include "baseline.h"
+#include "baseline_fleet.h"
+#include "baseline_backfill.h"
+#include "baseline_snapshot.h"
+#include "baseline_robust.h"
+#include "baseline_multi.h"
+#include "baseline_sketch.h"
 
 /*===========================================================================
  * Test Counters
@@ -621,6 +666,1515 @@ static void test_edge_reset_clears_faults(void)
     TEST_PASS("Edge: Reset clears faults and state");
 }
 
+/*===========================================================================
+ * BATCH TESTS
+ *===========================================================================*/
+
+#define BATCH_N 5000
+
+/** Two FSMs must agree field for field */
+static int fsm_equal(const base_fsm_t *a, const base_fsm_t *b)
+{
+    return memcmp(&a->mu, &b->mu, sizeof(double)) == 0 &&
+           memcmp(&a->variance, &b->variance, sizeof(double)) == 0 &&
+           memcmp(&a->sigma, &b->sigma, sizeof(double)) == 0 &&
+           a->n == b->n && a->state == b->state &&
+           a->fault_fp == b->fault_fp &&
+           a->fault_reentry == b->fault_reentry &&
+           a->in_step == b->in_step &&
+           a->sigma_stale == b->sigma_stale;
+}
+
+/**
+ * Batch: Exact equivalence
+ *
+ * Random streams with level shifts, then NaN/Inf and overflowing values,
+ * fed in chunks of varying size: every z, state, mask bit and the
+ * final FSM (bit for bit) must equal a loop of base_step().
+ */
+static void test_batch_matches_step(void)
+{
+    static double x[BATCH_N];
+    static double z[BATCH_N];
+    static uint8_t st[BATCH_N];
+    static uint64_t mask[(BATCH_N + 63) / 64];
+    base_fsm_t ref, b;
+
+    base_init(&ref, &BASE_DEFAULT_CONFIG);
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+
+    for (int i = 0; i < BATCH_N; i++) {
+        int r = rand() % 1000;
+        double level = (i / 700) % 2 ? 500.0 : 100.0;
+        x[i] = level + (double)rand() / RAND_MAX * 10.0;
+        /* Faults are sticky: inject them only into the tail */
+        if (i > BATCH_N * 4 / 5) {
+            if (r < 3) x[i] = NAN;
+            if (r == 3) x[i] = -INFINITY;
+            if (r == 4) x[i] = 1e300;
+        }
+    }
+
+    for (size_t pos = 0, len = 1; pos < BATCH_N; pos += len, len = len * 3 + 1) {
+        size_t devs = 0;
+
+        if (len > BATCH_N - pos) {
+            len = BATCH_N - pos;
+        }
+        memset(mask, 0, sizeof(mask));
+        size_t got = base_step_batch(&b, &x[pos], len, z, st, mask);
+
+        for (size_t i = 0; i < len; i++) {
+            base_result_t r = base_step(&ref, x[pos + i]);
+            if (r.z != z[i] ||
+                r.state != (base_state_t)st[i] ||
+                r.is_deviation != ((mask[i / 64] >> (i % 64)) & 1u)) {
+                TEST_FAIL("Batch: Exact equivalence", "output differs");
+                return;
+            }
+            devs += r.is_deviation;
+        }
+        if (got != devs || !fsm_equal(&b, &ref)) {
+            TEST_FAIL("Batch: Exact equivalence", "state differs");
+            return;
+        }
+    }
+
+    TEST_PASS("Batch: Exact equivalence with base_step loop");
+}
+
+/**
+ * Batch: Optional outputs and reentrancy
+ */
+static void test_batch_outputs_and_reentry(void)
+{
+    double x[100];
+    uint64_t mask[2] = {0, 0};
+    uint8_t st[100];
+    base_fsm_t b;
+
+    for (int i = 0; i < 100; i++) {
+        x[i] = 100.0 + (i % 5);
+    }
+
+    /* No outputs at all is valid and still advances the FSM */
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+    base_step_batch(&b, x, 100, NULL, NULL, NULL);
+    if (b.n != 100 || b.state != BASE_STABLE) {
+        TEST_FAIL("Batch: Optional outputs", "FSM did not advance");
+        return;
+    }
+    if (base_step_batch(&b, x, 0, NULL, NULL, mask) != 0 || b.n != 100) {
+        TEST_FAIL("Batch: Optional outputs", "empty batch changed FSM");
+        return;
+    }
+
+    /* Reentrant call: every entry faults, mask covers exactly n bits */
+    b.in_step = 1;
+    if (base_step_batch(&b, x, 70, NULL, st, mask) != 70 ||
+        !b.fault_reentry || b.state != BASE_DEVIATION ||
+        mask[0] != ~0ULL || mask[1] != 0x3Fu ||
+        st[69] != BASE_DEVIATION) {
+        TEST_FAIL("Batch: Reentrancy", "entries not faulted");
+        return;
+    }
+
+    TEST_PASS("Batch: Optional outputs and reentrancy fault");
+}
+
+/*===========================================================================
+ * FAST PATH TESTS
+ *===========================================================================*/
+
+/**
+ * Fast path: Decision equivalence
+ *
+ * The stream of the batch tests through base_step() and
+ * base_step_fast() side by side: the same states and statistics at
+ * every step, σ stale until asked for, and base_zscore() of the
+ * returned deviation equal to base_step()'s z.
+ */
+static void test_fast_matches_step(void)
+{
+    base_fsm_t a, b;
+
+    base_init(&a, &BASE_DEFAULT_CONFIG);
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+
+    for (int i = 0; i < BATCH_N; i++) {
+        double x = 100.0 + (double)rand() / RAND_MAX * 2.0;
+        if (i >= 1000 && i < 1200) x = 140.0;           /* Level shift    */
+        if (i >= 2000 && i < 2300) x = 50.0;            /* Variance floor */
+        if (i == 4000) x = 1e300;                       /* Overflow fault */
+
+        base_result_t ra = base_step(&a, x);
+        base_result_t rb = base_step_fast(&b, x);
+
+        if (rb.state != ra.state || rb.is_deviation != ra.is_deviation ||
+            memcmp(&rb.deviation, &ra.deviation, sizeof(double)) != 0 ||
+            !isnan(rb.z)) {
+            TEST_FAIL("Fast: Decision equivalence", "result differs");
+            return;
+        }
+        if (!base_faulted(&b) && !b.sigma_stale) {
+            TEST_FAIL("Fast: Decision equivalence", "sigma refreshed eagerly");
+            return;
+        }
+        double z = base_zscore(&b, rb.deviation);
+        if (memcmp(&z, &ra.z, sizeof(double)) != 0) {
+            TEST_FAIL("Fast: Decision equivalence", "z differs");
+            return;
+        }
+        base_sigma(&b);
+        if (!fsm_equal(&a, &b)) {
+            TEST_FAIL("Fast: Decision equivalence", "state differs");
+            return;
+        }
+    }
+
+    TEST_PASS("Fast: base_step_fast decides exactly as base_step");
+}
+
+/*===========================================================================
+ * TIMED TESTS
+ *===========================================================================*/
+
+/**
+ * Timed: Regular timestamps
+ *
+ * base_step_at() with t advancing by exactly T must equal base_step()
+ * bit for bit, whatever the origin of t.
+ */
+static void test_timed_regular_matches_step(void)
+{
+    base_fsm_t a, b;
+
+    base_init(&a, &BASE_DEFAULT_CONFIG);
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+    for (int i = 0; i < 5000; i++) {
+        double x = 100.0 + 10.0 * sin(i * 0.05) + (double)(rand() % 100) / 50.0;
+        base_result_t ra = base_step(&a, x);
+        base_result_t rb = base_step_at(&b, x, 123456789u + 250u * (uint64_t)i, 250u);
+        if (memcmp(&ra.z, &rb.z, sizeof(double)) != 0 || ra.state != rb.state ||
+            memcmp(&a.mu, &b.mu, sizeof(double)) != 0 ||
+            memcmp(&a.variance, &b.variance, sizeof(double)) != 0 ||
+            a.n != b.n) {
+            TEST_FAIL("Timed: Regular timestamps", "differs from base_step");
+            return;
+        }
+    }
+
+    TEST_PASS("Timed: Regular timestamps equal base_step exactly");
+}
+
+/**
+ * Timed: Decay accuracy and irregular spacing
+ *
+ * From μ = 1, one step of x = 0 leaves μ = λ: λ must be within
+ * (1 + |log₂ λ|) · 2 ulps of pow(1-α, dt/T) for gaps from a tick to
+ * thousands of periods. A
+ * repeated or late timestamp carries no weight and leaves t_last, so
+ * the next regular sample steps as if it never came; a fault leaves
+ * t_last alone.
+ */
+static void test_timed_decay(void)
+{
+    static const double alphas[] = {0.1, 0.5, 1e-3};
+    base_config_t cfg = BASE_DEFAULT_CONFIG;
+    base_fsm_t b;
+
+    for (size_t a = 0; a < sizeof(alphas) / sizeof(alphas[0]); a++) {
+        cfg.alpha = alphas[a];
+        cfg.n_min = (uint32_t)ceil(2.0 / cfg.alpha);
+        base_init(&b, &cfg);
+        base_step_at(&b, 0.0, 0u, 1000u);
+
+        for (uint64_t dt = 1; dt < 50000000u; dt = dt * 3u + 1u) {
+            double ref = pow(1.0 - cfg.alpha, (double)dt / 1000.0);
+            b.mu = 1.0;
+            b.variance = 0.0;
+            b.t_last = 7u;
+            base_step_at(&b, 0.0, 7u + dt, 1000u);
+            if (fabs(b.mu - ref) >
+                2.0 * DBL_EPSILON * ref * (1.0 + fabs(log2(ref)))) {
+                TEST_FAIL("Timed: Decay", "lambda outside its bound");
+                return;
+            }
+        }
+    }
+
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+    for (uint64_t i = 0; i < 100; i++) {
+        base_step_at(&b, 50.0 + (double)(i % 3), 1000u * i, 1000u);
+    }
+    double mu = b.mu, var = b.variance;
+    base_step_at(&b, 1e6, 99000u, 1000u);      /* Same timestamp */
+    if (b.mu != mu || b.variance != var || b.n != 101u) {
+        TEST_FAIL("Timed: Decay", "repeated timestamp carried weight");
+        return;
+    }
+    base_fsm_t ref = b;
+    base_step_at(&b, 1e6, 40000u, 1000u);      /* Late */
+    if (b.mu != mu || b.variance != var || b.t_last != 99000u) {
+        TEST_FAIL("Timed: Decay", "late timestamp moved the clock");
+        return;
+    }
+    base_step_at(&b, 51.0, 100000u, 1000u);
+    base_step_at(&ref, 51.0, 100000u, 1000u);
+    if (b.mu != ref.mu || b.variance != ref.variance ||
+        b.t_last != 100000u || b.state != ref.state) {
+        TEST_FAIL("Timed: Decay", "regular sample after a late one");
+        return;
+    }
+    base_step_at(&b, NAN, 150000u, 1000u);
+    if (!b.fault_fp || b.t_last != 100000u || b.n != 103u) {
+        TEST_FAIL("Timed: Decay", "fault moved t_last");
+        return;
+    }
+
+    TEST_PASS("Timed: Table decay matches pow to rounding");
+}
+
+/*===========================================================================
+ * ROBUST TESTS
+ *===========================================================================*/
+
+static double robust_mem[4096];
+
+static int cmp_double(const void *a, const void *b)
+{
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+/** Median of sorted v[0..c), as baseline_robust.c forms it */
+static double sorted_median(const double *v, uint32_t c)
+{
+    if (c & 1u) {
+        return v[c / 2];
+    }
+    return 0.5 * v[c / 2 - 1] + 0.5 * v[c / 2];
+}
+
+/**
+ * Robust: Exact order statistics
+ *
+ * Heavy-tailed, quantised streams (many ties) through windows of odd,
+ * even and multi-level sizes: after every step median, MAD, σ̂ and z
+ * must equal those of the re-sorted window exactly.
+ */
+static void test_robust_matches_sort(void)
+{
+    static const uint32_t windows[] = {3, 4, 17, 64, 257};
+    double ring[257], sorted[257], dev[257];
+
+    for (size_t w = 0; w < sizeof(windows) / sizeof(windows[0]); w++) {
+        base_robust_config_t cfg = BASE_ROBUST_DEFAULT_CONFIG;
+        base_robust_t r;
+        uint32_t fill = 0;
+        double m_prev = 0.0;
+
+        cfg.window = windows[w];
+        cfg.n_min = windows[w];
+        if (base_robust_bytes(cfg.window) > sizeof(robust_mem) ||
+            base_robust_init(&r, robust_mem, sizeof(robust_mem), &cfg) != 0) {
+            TEST_FAIL("Robust: Exact order statistics", "init failed");
+            return;
+        }
+
+        for (int step = 0; step < 3000; step++) {
+            double u = ((double)rand() + 1.0) / ((double)RAND_MAX + 2.0);
+            double x = floor(10.0 * (1.0 / (u * u) - 1.0)) / 4.0; /* Pareto */
+            if (step % 97 == 0) x = -x;
+
+            base_result_t res = base_robust_step(&r, x);
+
+            ring[(uint32_t)step % cfg.window] = x;
+            if (fill < cfg.window) fill++;
+            memcpy(sorted, ring, fill * sizeof(double));
+            qsort(sorted, fill, sizeof(double), cmp_double);
+            double m = sorted_median(sorted, fill);
+            for (uint32_t i = 0; i < fill; i++) {
+                dev[i] = fabs(sorted[i] - m);
+            }
+            qsort(dev, fill, sizeof(double), cmp_double);
+            double mad = sorted_median(dev, fill);
+            double sigma = BASE_ROBUST_MAD_SCALE * mad;
+            double z = (sigma * sigma <= cfg.epsilon) ? 0.0
+                                                      : fabs(x - m_prev) / sigma;
+            m_prev = m;
+
+            if (r.median != m || r.mad != mad || r.sigma != sigma ||
+                res.z != z || r.fill != fill || r.n != (uint32_t)step + 1u ||
+                base_robust_faulted(&r)) {
+                TEST_FAIL("Robust: Exact order statistics", "differs from sort");
+                return;
+            }
+            if (res.state > BASE_DEVIATION ||
+                (res.state != BASE_LEARNING && r.n < cfg.n_min)) {
+                TEST_FAIL("Robust: Exact order statistics", "bad state");
+                return;
+            }
+        }
+    }
+
+    TEST_PASS("Robust: Median and MAD equal the sorted window");
+}
+
+/**
+ * Robust: Spike resistance and faults
+ *
+ * A burst of huge outliers shorter than w/2 leaves σ̂ inside the
+ * clean data's range: the next clean sample is STABLE and a real shift
+ * right after is caught, where the inflated EWMA σ masks it. NaN,
+ * overflow and reentrancy fault without touching the window.
+ */
+static void test_robust_spikes_and_faults(void)
+{
+    base_robust_config_t cfg = BASE_ROBUST_DEFAULT_CONFIG;
+    base_robust_t r;
+    base_fsm_t b;
+    double median, mad;
+    uint32_t n, fill;
+
+    if (base_robust_bytes(2) != 0 ||
+        base_robust_init(&r, robust_mem, 16, &cfg) != -1 ||
+        base_robust_init(&r, (char *)robust_mem + 4, sizeof(robust_mem) - 4,
+                         &cfg) != -1) {
+        TEST_FAIL("Robust: Spikes and faults", "bad init accepted");
+        return;
+    }
+    cfg.n_min = cfg.window - 1;
+    if (base_robust_init(&r, robust_mem, sizeof(robust_mem), &cfg) != -1) {
+        TEST_FAIL("Robust: Spikes and faults", "R4 not enforced");
+        return;
+    }
+    cfg = BASE_ROBUST_DEFAULT_CONFIG;
+    base_robust_init(&r, robust_mem, sizeof(robust_mem), &cfg);
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+
+    for (int i = 0; i < 200; i++) {
+        double x = 100.0 + (double)(i % 5);
+        base_robust_step(&r, x);
+        base_step(&b, x);
+    }
+    for (int i = 0; i < 5; i++) {
+        base_robust_step(&r, 1e9);
+        base_step(&b, 1e9);
+    }
+    if (r.sigma > 10.0) {
+        TEST_FAIL("Robust: Spikes and faults", "outliers inflated sigma");
+        return;
+    }
+    if (base_robust_step(&r, 102.0).state != BASE_STABLE) {
+        TEST_FAIL("Robust: Spikes and faults", "burst outlasted itself");
+        return;
+    }
+    base_step(&b, 102.0);
+
+    /* A real 20σ shift right after: the EWMA σ still masks it */
+    if (base_robust_step(&r, 130.0).state != BASE_DEVIATION ||
+        base_step(&b, 130.0).state == BASE_DEVIATION) {
+        TEST_FAIL("Robust: Spikes and faults", "not robust to the burst");
+        return;
+    }
+
+    /* NaN: window untouched */
+    median = r.median;
+    mad = r.mad;
+    n = r.n;
+    fill = r.fill;
+    base_robust_step(&r, NAN);
+    if (!r.fault_fp || r.state != BASE_DEVIATION || r.n != n ||
+        r.fill != fill || r.median != median || r.mad != mad) {
+        TEST_FAIL("Robust: Spikes and faults", "fault changed the window");
+        return;
+    }
+    base_robust_step(&r, 102.0);
+    if (r.state != BASE_DEVIATION || r.n != n + 1u) {
+        TEST_FAIL("Robust: Spikes and faults", "fault not sticky");
+        return;
+    }
+
+    r.in_step = 1;
+    base_robust_step(&r, 102.0);
+    if (!r.fault_reentry || r.n != n + 1u) {
+        TEST_FAIL("Robust: Spikes and faults", "reentry not faulted");
+        return;
+    }
+
+    base_robust_reset(&r);
+    if (r.state != BASE_LEARNING || base_robust_faulted(&r) || r.fill != 0 ||
+        r.n != 0) {
+        TEST_FAIL("Robust: Spikes and faults", "reset incomplete");
+        return;
+    }
+
+    /* x - m overflows: the slide is undone */
+    cfg.window = 3;
+    cfg.n_min = 3;
+    base_robust_init(&r, robust_mem, sizeof(robust_mem), &cfg);
+    base_robust_step(&r, 1.7e308);
+    base_robust_step(&r, 1.6e308);
+    base_robust_step(&r, 1.5e308);
+    base_robust_step(&r, -1.7e308);
+    base_robust_step(&r, 1.4e308);  /* Evicts 1.7e308 */
+    if (!r.fault_fp || r.n != 4 || r.fill != 3 || r.median != 1.5e308 ||
+        !(r.mad > 0.09e308 && r.mad < 0.11e308)) {
+        TEST_FAIL("Robust: Spikes and faults", "overflow changed the window");
+        return;
+    }
+
+    TEST_PASS("Robust: Outlier burst ignored, faults leave window intact");
+}
+
+/**
+ * Robust: Periodic input
+ *
+ * Every fourth sample low, the rest high: with heights tied to the
+ * window slot, every tall node held a low value and a search walked
+ * the high three quarters on level 0. Heights drawn independently of
+ * the values keep each level-1 link short, and the median exact.
+ */
+static void test_robust_periodic(void)
+{
+    static double mem[16384];
+    double sorted[1024];
+    base_robust_config_t cfg = BASE_ROBUST_DEFAULT_CONFIG;
+    base_robust_t r;
+    uint32_t x = 0, widest = 0;
+
+    cfg.window = 1024;
+    cfg.n_min = 1024;
+    if (base_robust_bytes(cfg.window) > sizeof(mem) ||
+        base_robust_init(&r, mem, sizeof(mem), &cfg) != 0) {
+        TEST_FAIL("Robust: Periodic input", "init failed");
+        return;
+    }
+    for (int i = 0; i < 3000; i++) {
+        double v = (i % 4 == 3) ? 1.0 + (double)(i % 7)
+                                : 1000.0 + (double)(i % 11);
+        base_robust_step(&r, v);
+        if (i >= 3000 - 1024) {
+            sorted[i - (3000 - 1024)] = v;
+        }
+    }
+
+    /* Ranks skipped by each level-1 link: expected 4, never near w */
+    do {
+        uint32_t w = r.width[(size_t)x * r.levels + 1];
+        widest = (w > widest) ? w : widest;
+        x = r.next[(size_t)x * r.levels + 1];
+    } while (x != 0);
+    if (r.levels < 2 || widest > 64) {
+        TEST_FAIL("Robust: Periodic input", "level 1 degenerated to a list");
+        return;
+    }
+
+    qsort(sorted, 1024, sizeof(double), cmp_double);
+    if (r.median != sorted_median(sorted, 1024) || base_robust_faulted(&r)) {
+        TEST_FAIL("Robust: Periodic input", "wrong median");
+        return;
+    }
+
+    TEST_PASS("Robust: Periodic input keeps the skip list balanced");
+}
+
+/*===========================================================================
+ * MULTIVARIATE TESTS
+ *===========================================================================*/
+
+#define MULTI_D 7  /* Not a multiple of 4: exercises the scalar tail */
+
+static double multi_mem[2][3 * MULTI_D + 3 * MULTI_D * MULTI_D];
+
+/**
+ * Multivariate: Equivalence with base_step
+ *
+ * In DIAG mode every μᵢ and σ²ᵢ equals an independent base_fsm_t's
+ * for metric i, and with d = 1 D equals z; FULL mode has the same
+ * diagonal. Both kernels agree bit for bit, and a NaN in one metric
+ * faults the step without touching μ or Σ.
+ */
+static void test_multi_matches_step(void)
+{
+    base_fsm_t ref[MULTI_D];
+    base_multi_t m[2];
+    double x[MULTI_D];
+
+    for (int k = BASE_KERNEL_SCALAR; k <= BASE_KERNEL_AVX2; k++) {
+        if (base_multi_init(&m[0], multi_mem[0], sizeof(multi_mem[0]), MULTI_D,
+                            BASE_MULTI_DIAG, &BASE_DEFAULT_CONFIG) != 0 ||
+            base_multi_init(&m[1], multi_mem[1], sizeof(multi_mem[1]), MULTI_D,
+                            BASE_MULTI_FULL, &BASE_DEFAULT_CONFIG) != 0) {
+            TEST_FAIL("Multivariate: Equivalence", "init failed");
+            return;
+        }
+        if (base_multi_set_kernel(&m[0], (base_kernel_t)k) != 0 ||
+            base_multi_set_kernel(&m[1], (base_kernel_t)k) != 0) {
+            continue;  /* AVX2 not available */
+        }
+        for (int i = 0; i < MULTI_D; i++) {
+            base_init(&ref[i], &BASE_DEFAULT_CONFIG);
+        }
+
+        for (int step = 0; step < 1000; step++) {
+            for (int i = 0; i < MULTI_D; i++) {
+                x[i] = 10.0 * i + (double)rand() / RAND_MAX * (1.0 + i);
+            }
+            if (step == 500) x[3] = NAN;
+
+            base_multi_step(&m[0], x);
+            base_multi_step(&m[1], x);
+            if (step == 500) {
+                if (!m[0].fault_fp || !m[1].fault_fp || m[0].n != 500u) {
+                    TEST_FAIL("Multivariate: Equivalence", "NaN not faulted");
+                    return;
+                }
+                continue;
+            }
+            for (int i = 0; i < MULTI_D; i++) {
+                base_step(&ref[i], x[i]);
+                if (m[0].mu[i] != ref[i].mu || m[0].cov[i] != ref[i].variance ||
+                    m[1].mu[i] != ref[i].mu ||
+                    m[1].cov[i * MULTI_D + i] != ref[i].variance) {
+                    TEST_FAIL("Multivariate: Equivalence", "differs from base_step");
+                    return;
+                }
+            }
+        }
+    }
+
+    /* Scalar and AVX2 kernels give the same Σ and D, in both modes */
+    for (int mode = BASE_MULTI_DIAG;
+         mode <= BASE_MULTI_FULL && base_kernel_supported(BASE_KERNEL_AVX2);
+         mode++) {
+        size_t c = (mode == BASE_MULTI_FULL) ? MULTI_D * MULTI_D : MULTI_D;
+        base_multi_init(&m[0], multi_mem[0], sizeof(multi_mem[0]), MULTI_D,
+                        (base_multi_mode_t)mode, &BASE_DEFAULT_CONFIG);
+        base_multi_init(&m[1], multi_mem[1], sizeof(multi_mem[1]), MULTI_D,
+                        (base_multi_mode_t)mode, &BASE_DEFAULT_CONFIG);
+        base_multi_set_kernel(&m[0], BASE_KERNEL_SCALAR);
+        base_multi_set_kernel(&m[1], BASE_KERNEL_AVX2);
+        for (int step = 0; step < 200; step++) {
+            for (int i = 0; i < MULTI_D; i++) {
+                x[i] = (double)rand() / RAND_MAX * (i + 1) + (i == 2 ? x[0] : 0.0);
+            }
+            base_result_t r0 = base_multi_step(&m[0], x);
+            base_result_t r1 = base_multi_step(&m[1], x);
+            if (memcmp(&r0.z, &r1.z, sizeof(double)) != 0 ||
+                memcmp(m[0].cov, m[1].cov, c * sizeof(double)) != 0) {
+                TEST_FAIL("Multivariate: Equivalence", "kernels differ");
+                return;
+            }
+        }
+    }
+
+    /* d = 1: D is z */
+    base_init(&ref[0], &BASE_DEFAULT_CONFIG);
+    base_multi_init(&m[0], multi_mem[0], sizeof(multi_mem[0]), 1,
+                    BASE_MULTI_DIAG, &BASE_DEFAULT_CONFIG);
+    for (int step = 0; step < 500; step++) {
+        x[0] = 50.0 + (double)rand() / RAND_MAX + (step % 100 == 99 ? 20.0 : 0.0);
+        base_result_t rm = base_multi_step(&m[0], x);
+        base_result_t rb = base_step(&ref[0], x[0]);
+        if (rm.z != rb.z || rm.state != rb.state) {
+            TEST_FAIL("Multivariate: Equivalence", "d = 1 differs from z");
+            return;
+        }
+    }
+
+    TEST_PASS("Multivariate: Per-metric statistics equal base_step");
+}
+
+/**
+ * Multivariate: Correlated anomaly
+ *
+ * Latency tracks CPU. A step where CPU rises and latency falls, each
+ * by 1.5 σ, is within k for every metric and for the diagonal D, but
+ * the full covariance sees it breaks the correlation. An exact copy
+ * of a metric is dropped, not inverted; faults, reset and bad init
+ * behave as base_step's.
+ */
+static void test_multi_correlated(void)
+{
+    base_config_t cfg = BASE_DEFAULT_CONFIG;
+    base_multi_t diag, full;
+    double x[2];
+
+    cfg.alpha = 0.02;  /* D is scored after update: D < 1/√α */
+    cfg.k     = 3.44;  /* P = 0.27% for d = 2 */
+    cfg.n_min = 100;
+    if (base_multi_init(&diag, multi_mem[0], sizeof(multi_mem[0]), 2,
+                        BASE_MULTI_DIAG, &cfg) != 0 ||
+        base_multi_init(&full, multi_mem[1], sizeof(multi_mem[1]), 2,
+                        BASE_MULTI_FULL, &cfg) != 0) {
+        TEST_FAIL("Multivariate: Correlated", "init failed");
+        return;
+    }
+
+    for (int step = 0; step < 400; step++) {
+        double load = (double)rand() / RAND_MAX;
+        x[0] = 40.0 + 10.0 * load;
+        x[1] = 5.0 + 2.0 * load + 0.05 * (double)rand() / RAND_MAX;
+        base_multi_step(&diag, x);
+        base_multi_step(&full, x);
+    }
+    if (diag.state != BASE_STABLE || full.state != BASE_STABLE) {
+        TEST_FAIL("Multivariate: Correlated", "not stable on normal data");
+        return;
+    }
+
+    x[0] = diag.mu[0] + 1.5 * sqrt(diag.cov[0]);
+    x[1] = diag.mu[1] - 1.5 * sqrt(diag.cov[1]);
+    base_result_t rd = base_multi_step(&diag, x);
+    base_result_t rf = base_multi_step(&full, x);
+    if (rd.state != BASE_STABLE || rf.state != BASE_DEVIATION || rf.z < 5.0) {
+        TEST_FAIL("Multivariate: Correlated", "broken correlation missed");
+        return;
+    }
+
+    /* Duplicate metric: Σ singular, D equals the one-metric z */
+    base_fsm_t ref;
+    base_init(&ref, &BASE_DEFAULT_CONFIG);
+    base_multi_init(&full, multi_mem[1], sizeof(multi_mem[1]), 2,
+                    BASE_MULTI_FULL, &BASE_DEFAULT_CONFIG);
+    for (int step = 0; step < 300; step++) {
+        x[0] = x[1] = 7.0 + (double)rand() / RAND_MAX;
+        base_result_t rm = base_multi_step(&full, x);
+        base_result_t rb = base_step(&ref, x[0]);
+        if (rm.z != rb.z) {
+            TEST_FAIL("Multivariate: Correlated", "duplicate metric not dropped");
+            return;
+        }
+    }
+
+    /* Overflow and reentrancy fault without touching μ, Σ or n */
+    double mu0 = full.mu[0], cov0 = full.cov[1];
+    uint32_t n0 = full.n;
+    x[0] = 1e300;
+    x[1] = 0.0;
+    base_multi_step(&full, x);
+    if (!full.fault_fp || full.state != BASE_DEVIATION || full.n != n0 ||
+        full.mu[0] != mu0 || full.cov[1] != cov0) {
+        TEST_FAIL("Multivariate: Correlated", "overflow changed state");
+        return;
+    }
+    base_multi_reset(&full);
+    full.in_step = 1;
+    base_multi_step(&full, x);
+    if (!full.fault_reentry || !base_multi_faulted(&full)) {
+        TEST_FAIL("Multivariate: Correlated", "reentry not detected");
+        return;
+    }
+    base_multi_reset(&full);
+    if (base_multi_faulted(&full) || full.n != 0 ||
+        base_multi_state(&full) != BASE_LEARNING) {
+        TEST_FAIL("Multivariate: Correlated", "reset incomplete");
+        return;
+    }
+
+    cfg.n_min = 10;  /* Breaks C4 */
+    if (base_multi_init(&full, multi_mem[1], sizeof(multi_mem[1]), 0,
+                        BASE_MULTI_FULL, &BASE_DEFAULT_CONFIG) != -1 ||
+        base_multi_init(&full, multi_mem[1],
+                        base_multi_bytes(4, BASE_MULTI_FULL) - 1, 4,
+                        BASE_MULTI_FULL, &BASE_DEFAULT_CONFIG) != -1 ||
+        base_multi_init(&full, multi_mem[1], sizeof(multi_mem[1]), 2,
+                        BASE_MULTI_FULL, &cfg) != -1) {
+        TEST_FAIL("Multivariate: Correlated", "bad init accepted");
+        return;
+    }
+
+    TEST_PASS("Multivariate: Full covariance catches a broken correlation");
+}
+
+/*===========================================================================
+ * SKETCH TESTS
+ *===========================================================================*/
+
+#define SKETCH_N 20000
+
+/**
+ * Sketch: Quantile accuracy
+ *
+ * p50, p99 and p999 of the z-scores of a real stream, from the sketch,
+ * are within 2⁻⁵ (relative, or absolute below 2⁻⁴) of the sorted
+ * nearest-rank values. Bucket edges, 0, -0, ∞ and NaN land where the
+ * header says.
+ */
+static void test_sketch_quantiles(void)
+{
+    static double zs[SKETCH_N];
+    static base_sketch_t s;
+    const double qs[] = { 0.0, 0.5, 0.9, 0.99, 0.999, 1.0 };
+    base_fsm_t b;
+    size_t n = 0;
+
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+    base_sketch_init(&s);
+    for (int i = 0; i < SKETCH_N; i++) {
+        double u = (double)rand() / RAND_MAX;
+        double x = 100.0 + 4.0 * (u - 0.5) + (i % 997 == 0 ? 30.0 : 0.0);
+        base_result_t r = base_step_sketch(&b, &s, x);
+        zs[n++] = r.z;
+    }
+    qsort(zs, n, sizeof(double), cmp_double);
+
+    if (s.count != n || s.unscored != 0 || s.max != zs[n - 1]) {
+        TEST_FAIL("Sketch: Quantiles", "counts or max wrong");
+        return;
+    }
+    for (size_t i = 0; i < sizeof(qs) / sizeof(qs[0]); i++) {
+        size_t rank = (size_t)ceil(qs[i] * (double)n);
+        double exact = zs[(rank < 1 ? 1 : rank) - 1];
+        double est = base_sketch_quantile(&s, qs[i]);
+        double tol = (exact < 0.0625) ? 1.0 / 32.0 : exact / 32.0;
+        if (fabs(est - exact) > tol) {
+            TEST_FAIL("Sketch: Quantiles", "estimate outside 2^-5");
+            return;
+        }
+    }
+
+    /* Bucket layout */
+    uint32_t last = BASE_SKETCH_BUCKETS - 1;
+    if (base_sketch_bucket(0.0) != 0 || base_sketch_bucket(-0.0) != 0 ||
+        base_sketch_bucket(0.0624) != 0 || base_sketch_bucket(0.0625) != 1 ||
+        base_sketch_bucket(0.0625 * (1.0 + 1.0 / 16)) != 2 ||
+        base_sketch_bucket(1.0) != 1 + 4 * 16 ||
+        base_sketch_bucket(-1.0) != 1 + 4 * 16 ||
+        base_sketch_bucket(63.99) != last - 1 ||
+        base_sketch_bucket(64.0) != last ||
+        base_sketch_bucket(INFINITY) != last ||
+        base_sketch_bucket(DBL_MIN / 2) != 0) {
+        TEST_FAIL("Sketch: Quantiles", "bucket layout wrong");
+        return;
+    }
+    base_sketch_init(&s);
+    base_sketch_add(&s, NAN);
+    if (s.unscored != 1 || s.count != 0 ||
+        !isnan(base_sketch_quantile(&s, 0.5))) {
+        TEST_FAIL("Sketch: Quantiles", "NaN recorded");
+        return;
+    }
+    base_sketch_add(&s, 100.0);
+    if (base_sketch_quantile(&s, 0.5) != 100.0 ||
+        !isnan(base_sketch_quantile(&s, 1.5))) {
+        TEST_FAIL("Sketch: Quantiles", "overflow not the maximum");
+        return;
+    }
+
+    TEST_PASS("Sketch: p50/p99/p999 within 2^-5 of the sorted z");
+}
+
+/**
+ * Sketch: Merge and transparency
+ *
+ * Per-stream sketches of a fleet, merged, equal one sketch of every
+ * sample. base_step_sketch() leaves the monitor as base_step() does,
+ * faulted or fast-path steps are counted as unscored, and the steps
+ * after a fault are recorded again.
+ */
+static void test_sketch_merge(void)
+{
+    enum { STREAMS = 8 };
+    static base_sketch_t per[STREAMS], all, merged;
+    base_fsm_t a, b;
+    double z[STREAMS];
+
+    for (int i = 0; i < STREAMS; i++) base_sketch_init(&per[i]);
+    base_sketch_init(&all);
+    base_sketch_init(&merged);
+    for (int step = 0; step < 1000; step++) {
+        for (int i = 0; i < STREAMS; i++) {
+            z[i] = (double)rand() / RAND_MAX * (1 << i) * 0.1;
+        }
+        base_sketch_add_each(per, z, STREAMS);
+        base_sketch_add_batch(&all, z, STREAMS);
+    }
+    for (int i = 0; i < STREAMS; i++) base_sketch_merge(&merged, &per[i]);
+    if (memcmp(&merged, &all, sizeof(all)) != 0) {
+        TEST_FAIL("Sketch: Merge", "merged differs from combined");
+        return;
+    }
+
+    base_init(&a, &BASE_DEFAULT_CONFIG);
+    base_init(&b, &BASE_DEFAULT_CONFIG);
+    base_sketch_init(&all);
+    for (int step = 0; step < 500; step++) {
+        double x = 10.0 + (double)rand() / RAND_MAX;
+        base_result_t ra = base_step(&a, x);
+        base_result_t rb = base_step_sketch(&b, &all, x);
+        if (memcmp(&ra.z, &rb.z, sizeof(double)) != 0 ||
+            ra.state != rb.state || a.mu != b.mu ||
+            a.variance != b.variance || a.n != b.n) {
+            TEST_FAIL("Sketch: Merge", "base_step_sketch changed the step");
+            return;
+        }
+    }
+    base_step_sketch(&b, &all, NAN);
+    base_sketch_add(&all, base_step_fast(&a, 10.5).z);
+    if (all.count != 500 || all.unscored != 2) {
+        TEST_FAIL("Sketch: Merge", "unscored steps recorded");
+        return;
+    }
+    for (int step = 0; step < 50; step++) {
+        base_step_sketch(&b, &all, 10.0 + (double)rand() / RAND_MAX);
+    }
+    if (all.count != 550 || all.unscored != 2) {
+        TEST_FAIL("Sketch: Merge", "steps after a fault not recorded");
+        return;
+    }
+
+    TEST_PASS("Sketch: Merged streams equal one sketch; step unchanged");
+}
+
+/*===========================================================================
+ * BACKFILL TESTS
+ *===========================================================================*/
+
+#define BACKFILL_N (4 * BASE_BACKFILL_MIN_CHUNK + 123)
+
+static double backfill_x[BACKFILL_N];
+static double backfill_z[BACKFILL_N];
+static double backfill_ref[BACKFILL_N];
+
+/** |a - b| within rel of the larger magnitude (or of 1) */
+static int close_to(double a, double b, double rel)
+{
+    double scale = fmax(1.0, fmax(fabs(a), fabs(b)));
+    return fabs(a - b) <= rel * scale;
+}
+
+/**
+ * Backfill: Scan equivalence
+ *
+ * A series with level shifts, a constant stretch and NaNs, split over
+ * four threads; then the same far from zero, continuing a monitor
+ * with an EMA slow enough that every chunk depends on the scan. n,
+ * state, faults and the deviation count exactly, μ, σ² and every z to
+ * rounding, against base_step_batch().
+ */
+static void test_backfill_matches_step(void)
+{
+    /* Slow EMA: a chunk's start still weighs (1-α)ᴸ ≈ 0.5 at its end */
+    const base_config_t slow = { .alpha = 1e-5, .epsilon = 1e-9, .k = 3.0,
+                                 .n_min = 200000 };
+
+    for (int run = 0; run < 2; run++) {
+        double offset = run ? 1e6 : 0.0;
+        base_fsm_t a, b;
+        size_t da, db;
+
+        for (size_t i = 0; i < BACKFILL_N; i++) {
+            backfill_x[i] = offset + 100.0 + (double)rand() / RAND_MAX * 2.0;
+            if ((i / 50000) % 3 == 1) backfill_x[i] += 40.0;    /* Shifts   */
+            if (i >= 120000 && i < 121000) backfill_x[i] = 7.0; /* Constant */
+            if (run == 0 && i % 97001 == 500) backfill_x[i] = NAN;
+        }
+
+        base_init(&a, run ? &slow : &BASE_DEFAULT_CONFIG);
+        if (run) {
+            for (int i = 0; i < 100; i++) {
+                base_step(&a, offset + 101.0 + (i % 2));
+            }
+        }
+        b = a;
+
+        da = base_step_batch(&a, backfill_x, BACKFILL_N, backfill_ref,
+                             NULL, NULL);
+        db = base_backfill(&b, backfill_x, BACKFILL_N, backfill_z, 4);
+
+        if (da != db || a.n != b.n || a.state != b.state ||
+            a.fault_fp != b.fault_fp || b.in_step ||
+            !close_to(a.mu, b.mu, 1e-12) ||
+            !close_to(a.variance, b.variance, 1e-9) ||
+            !close_to(a.sigma, b.sigma, 1e-9)) {
+            TEST_FAIL("Backfill: Scan equivalence", "final state differs");
+            return;
+        }
+        for (size_t i = 0; i < BACKFILL_N; i++) {
+            if (!close_to(backfill_z[i], backfill_ref[i], 1e-9)) {
+                TEST_FAIL("Backfill: Scan equivalence", "z differs");
+                return;
+            }
+        }
+    }
+
+    TEST_PASS("Backfill: Parallel scan equals base_step loop");
+}
+
+/**
+ * Backfill: Exact fallbacks
+ *
+ * An overflowing sample, a short series or a reentrant call are not
+ * split: the result is base_step_batch()'s, bit for bit.
+ */
+static void test_backfill_fallback(void)
+{
+    base_fsm_t a, b;
+
+    for (size_t i = 0; i < BACKFILL_N; i++) {
+        backfill_x[i] = 100.0 + (double)rand() / RAND_MAX;
+    }
+    backfill_x[200000] = -1e300;  /* Finite, overflows σ² */
+
+    for (int run = 0; run < 2; run++) {
+        size_t n = run ? 1000 : BACKFILL_N;
+
+        base_init(&a, &BASE_DEFAULT_CONFIG);
+        b = a;
+        if (base_step_batch(&a, backfill_x, n, backfill_ref, NULL, NULL) !=
+                base_backfill(&b, backfill_x, n, backfill_z, 4) ||
+            !fsm_equal(&a, &b) ||
+            memcmp(backfill_z, backfill_ref, n * sizeof(double)) != 0) {
+            TEST_FAIL("Backfill: Fallback", "not exact");
+            return;
+        }
+        if (run == 0 && !a.fault_fp) {
+            TEST_FAIL("Backfill: Fallback", "overflow not faulted");
+            return;
+        }
+    }
+
+    b.in_step = 1;
+    if (base_backfill(&b, backfill_x, BACKFILL_N, NULL, 4) != BACKFILL_N ||
+        !b.fault_reentry) {
+        TEST_FAIL("Backfill: Fallback", "reentry not faulted");
+        return;
+    }
+
+    TEST_PASS("Backfill: Overflow, short and reentrant calls exact");
+}
+
+/*===========================================================================
+ * FLEET TESTS
+ *===========================================================================*/
+
+#define FLEET_N 203  /* Not a multiple of 8: exercises the scalar tail */
+
+static double fleet_mem[8 * FLEET_N];
+static double fleet_mem2[8 * FLEET_N];
+
+#if !defined(BASE_FLOAT32) && !defined(BASE_FIXED_POINT)
+
+/** Stream i of the fleet must equal the reference base_fsm_t exactly */
+static int fleet_matches(const base_fleet_t *f, const base_fsm_t *ref)
+{
+    for (size_t i = 0; i < f->n; i++) {
+        if (memcmp(&f->mu[i], &ref[i].mu, sizeof(double)) != 0 ||
+            memcmp(&f->variance[i], &ref[i].variance, sizeof(double)) != 0 ||
+            memcmp(&f->sigma[i], &ref[i].sigma, sizeof(double)) != 0 ||
+            f->count[i] != ref[i].n ||
+            f->state[i] != (uint8_t)ref[i].state ||
+            f->fault_fp[i] != ref[i].fault_fp ||
+            f->fault_reentry[i] != ref[i].fault_reentry) {
+            return 0;
+        }
+    }
+    return f->in_step == 0;
+}
+
+/**
+ * Fleet: Kernel equivalence
+ *
+ * Streams with different levels, level shifts and occasional NaN, Inf
+ * or overflowing values, stepped by every supported kernel: each
+ * stream and each z must equal an independent base_fsm_t.
+ */
+static void test_fleet_kernels_match_step(void)
+{
+    static base_fsm_t ref[FLEET_N];
+    double x[FLEET_N];
+    double z[FLEET_N];
+    base_fleet_t f;
+
+    if (base_fleet_bytes(0) != 0 ||
+        base_fleet_bytes(FLEET_N) > sizeof(fleet_mem) ||
+        base_fleet_init(&f, fleet_mem, sizeof(fleet_mem), 0,
+                        &BASE_DEFAULT_CONFIG) != -1 ||
+        base_fleet_init(&f, (char *)fleet_mem + 2, sizeof(fleet_mem) - 2,
+                        FLEET_N, &BASE_DEFAULT_CONFIG) != -1) {
+        TEST_FAIL("Fleet: Kernel equivalence", "bad init accepted");
+        return;
+    }
+
+    for (int k = BASE_KERNEL_SCALAR; k <= BASE_KERNEL_AVX512; k++) {
+        if (!base_kernel_supported((base_kernel_t)k)) {
+            continue;
+        }
+
+        base_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N,
+                        &BASE_DEFAULT_CONFIG);
+        if (base_fleet_set_kernel(&f, (base_kernel_t)k) != 0) {
+            TEST_FAIL("Fleet: Kernel equivalence", "set_kernel failed");
+            return;
+        }
+        for (size_t i = 0; i < FLEET_N; i++) {
+            base_init(&ref[i], &BASE_DEFAULT_CONFIG);
+        }
+
+        for (int step = 0; step < 2000; step++) {
+            for (size_t i = 0; i < FLEET_N; i++) {
+                int r = rand() % 20000;
+                double level = (double)(i % 7) * 50.0 +
+                               ((step / 300 + (int)i) % 3 == 0 ? 200.0 : 0.0);
+                x[i] = level + (double)rand() / RAND_MAX * (1.0 + (double)(i % 5));
+                if (r == 0) x[i] = NAN;
+                if (r == 1) x[i] = INFINITY;
+                if (r == 2) x[i] = -1e300;
+                if (i % 11 == 0) x[i] = 42.0;  /* Constant: variance floor */
+            }
+
+            base_fleet_step(&f, x, z);
+            for (size_t i = 0; i < FLEET_N; i++) {
+                base_result_t r = base_step(&ref[i], x[i]);
+                if (r.z != z[i]) {
+                    TEST_FAIL("Fleet: Kernel equivalence", "z differs");
+                    return;
+                }
+            }
+            if (!fleet_matches(&f, ref)) {
+                TEST_FAIL("Fleet: Kernel equivalence", "state differs");
+                return;
+            }
+        }
+    }
+
+    TEST_PASS("Fleet: Every kernel equals base_step per stream");
+}
+
+#endif /* double columns */
+
+/** Error bounds of baseline_fleet.h for the default configuration */
+typedef struct {
+    double mu, var, sigma, z;
+} fleet_err_t;
+
+static fleet_err_t fleet_bounds(double M, double D, double sigma, double z)
+{
+    fleet_err_t e = {0.0, 0.0, 0.0, 0.0};
+#if defined(BASE_FLOAT32)
+    const double a = BASE_DEFAULT_CONFIG.alpha;
+    const double u = ldexp(1.0, -24);
+    double ed;
+
+    e.mu = 4.0 * u * M / a;
+    ed = e.mu + 2.0 * u * M;
+    e.var = 2.0 * D * ed + 4.0 * u * D * D / a;
+    e.sigma = e.var / (2.0 * sigma) + u * sigma;
+    e.z = (ed + z * e.sigma) / sigma + 2.0 * u * z;
+#elif defined(BASE_FIXED_POINT)
+    const double a = BASE_DEFAULT_CONFIG.alpha;
+    const double q = ldexp(1.0, -17);
+    double ed;
+
+    (void)M;
+    e.mu = (1.0 + 1.0 / a) * q + (q / a) * D;
+    ed = e.mu + q;
+    e.var = 2.0 * D * ed + ed * ed + (q / a) * D * D + (1.0 + 1.0 / a) * q;
+    e.sigma = e.var / (2.0 * sigma) + 2.0 * q;
+    e.z = (ed + z * e.sigma) / sigma;
+#else
+    (void)M; (void)D; (void)sigma; (void)z;
+#endif
+    return e;
+}
+
+/**
+ * Fleet: Precision bounds
+ *
+ * Stationary streams at several levels and noise amplitudes, with a
+ * level shift and rare NaNs. After warm-up every stream's μ, σ², σ
+ * and z stay within the documented bounds of base_step() (zero in a
+ * double build), faults and counts match exactly, and every kernel
+ * matches the scalar kernel bit for bit.
+ */
+static void test_fleet_precision_bounds(void)
+{
+    static const double levels[] = { 0.0, 50.0, -200.0, 300.0 };
+    static const double noise[] = { 0.5, 2.0, 8.0 };
+    static base_fsm_t ref[FLEET_N];
+    static double M[FLEET_N], D[FLEET_N];
+    double x[FLEET_N], z[FLEET_N], zs[FLEET_N];
+    size_t bytes = base_fleet_bytes(FLEET_N);
+    base_fleet_t f, g;
+
+    for (int k = BASE_KERNEL_SCALAR; k <= BASE_KERNEL_AVX512; k++) {
+        if (!base_kernel_supported((base_kernel_t)k)) {
+            continue;
+        }
+
+        base_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N,
+                        &BASE_DEFAULT_CONFIG);
+        base_fleet_init(&g, fleet_mem2, sizeof(fleet_mem2), FLEET_N,
+                        &BASE_DEFAULT_CONFIG);
+        base_fleet_set_kernel(&f, (base_kernel_t)k);
+        base_fleet_set_kernel(&g, BASE_KERNEL_SCALAR);
+        for (size_t i = 0; i < FLEET_N; i++) {
+            base_init(&ref[i], &BASE_DEFAULT_CONFIG);
+            M[i] = 0.0;
+            D[i] = 0.0;
+        }
+
+        for (int step = 0; step < 3000; step++) {
+            for (size_t i = 0; i < FLEET_N; i++) {
+                double a = noise[i % 3];
+                x[i] = levels[(i / 3) % 4] + (step >= 1500 ? 5.0 * a : 0.0) +
+                       a * ((double)rand() / RAND_MAX - 0.5);
+                if (rand() % 50000 == 0) x[i] = NAN;
+            }
+
+            base_fleet_step(&f, x, z);
+            base_fleet_step(&g, x, zs);
+            if (memcmp(z, zs, sizeof(z)) != 0 ||
+                memcmp(fleet_mem, fleet_mem2, bytes) != 0) {
+                TEST_FAIL("Fleet: Precision bounds", "kernels differ");
+                return;
+            }
+
+            for (size_t i = 0; i < FLEET_N; i++) {
+                double mu_prev = ref[i].mu;
+                base_result_t r = base_step(&ref[i], x[i]);
+                fleet_err_t e;
+
+                if (f.count[i] != ref[i].n ||
+                    base_fleet_faulted(&f, i) != base_faulted(&ref[i])) {
+                    TEST_FAIL("Fleet: Precision bounds", "fault or count differs");
+                    return;
+                }
+                if (!isfinite(x[i]) || base_faulted(&ref[i])) {
+                    continue;
+                }
+                if (fabs(x[i]) > M[i]) M[i] = fabs(x[i]);
+                if (step >= 200 && fabs(x[i] - mu_prev) > D[i]) {
+                    D[i] = fabs(x[i] - mu_prev);
+                }
+                if (step < 400) {
+                    continue;
+                }
+
+                e = fleet_bounds(M[i], D[i], ref[i].sigma, r.z);
+                if (fabs(BASE_TO_DOUBLE(f.mu[i]) - ref[i].mu) > e.mu ||
+                    fabs(BASE_TO_DOUBLE(f.variance[i]) - ref[i].variance) > e.var ||
+                    fabs(BASE_TO_DOUBLE(f.sigma[i]) - ref[i].sigma) > e.sigma ||
+                    fabs(z[i] - r.z) > e.z) {
+                    TEST_FAIL("Fleet: Precision bounds", "error above bound");
+                    return;
+                }
+            }
+        }
+    }
+
+    TEST_PASS("Fleet: Column precision within documented bounds");
+}
+
+/**
+ * Fleet: Fault isolation
+ *
+ * One NaN stream in the middle of a vector faults that stream only;
+ * a reentrant step faults every stream.
+ */
+static void test_fleet_fault_isolation(void)
+{
+    double x[16];
+    base_fleet_t f;
+
+    for (int k = BASE_KERNEL_SCALAR; k <= BASE_KERNEL_AVX512; k++) {
+        if (!base_kernel_supported((base_kernel_t)k)) {
+            continue;
+        }
+        base_fleet_init(&f, fleet_mem, sizeof(fleet_mem), 16,
+                        &BASE_DEFAULT_CONFIG);
+        base_fleet_set_kernel(&f, (base_kernel_t)k);
+
+        for (int step = 0; step < 50; step++) {
+            for (int i = 0; i < 16; i++) {
+                x[i] = 100.0 + (double)((step + i) % 3);
+            }
+            if (step == 40) {
+                x[5] = NAN;
+            }
+            base_fleet_step(&f, x, NULL);
+        }
+
+        for (size_t i = 0; i < 16; i++) {
+            int poisoned = (i == 5);
+            if (base_fleet_faulted(&f, i) != poisoned ||
+                (base_fleet_state(&f, i) == BASE_DEVIATION) != poisoned ||
+                f.count[i] != (poisoned ? 49u : 50u) ||
+                !isfinite(BASE_TO_DOUBLE(f.mu[i]))) {
+                TEST_FAIL("Fleet: Fault isolation", "NaN leaked across lanes");
+                return;
+            }
+        }
+    }
+
+    f.in_step = 1;
+    base_fleet_step(&f, x, NULL);
+    for (size_t i = 0; i < 16; i++) {
+        if (!f.fault_reentry[i] || base_fleet_state(&f, i) != BASE_DEVIATION) {
+            TEST_FAIL("Fleet: Fault isolation", "reentry not faulted");
+            return;
+        }
+    }
+
+    TEST_PASS("Fleet: NaN faults its own stream only");
+}
+
+/*===========================================================================
+ * SNAPSHOT TESTS
+ *===========================================================================*/
+
+static unsigned char snap_buf[8192];
+
+/** Every column of two fleets of the same size is bit-identical */
+static int fleets_equal(const base_fleet_t *a, const base_fleet_t *b)
+{
+    size_t vb = a->n * sizeof(base_value_t);
+
+    return a->n == b->n &&
+           memcmp(a->mu, b->mu, vb) == 0 &&
+           memcmp(a->variance, b->variance, vb) == 0 &&
+           memcmp(a->sigma, b->sigma, vb) == 0 &&
+           memcmp(a->count, b->count, a->n * sizeof(uint32_t)) == 0 &&
+           memcmp(a->state, b->state, a->n) == 0 &&
+           memcmp(a->fault_fp, b->fault_fp, a->n) == 0 &&
+           memcmp(a->fault_reentry, b->fault_reentry, a->n) == 0;
+}
+
+/** Recompute both checksums after a test has edited the payload */
+static void snap_reseal(unsigned char *buf, size_t size)
+{
+    uint32_t crc = base_crc32c(0, buf + BASE_SNAPSHOT_HEADER,
+                               size - BASE_SNAPSHOT_HEADER);
+    memcpy(buf + 44, &crc, sizeof(crc));
+    crc = base_crc32c(0, buf, 56);
+    memcpy(buf + 56, &crc, sizeof(crc));
+}
+
+/**
+ * Snapshot: Round trip
+ *
+ * A fleet in every state, faults included, saved and loaded into a
+ * fresh fleet, is restored bit for bit and steps on identically.
+ */
+static void test_snapshot_round_trip(void)
+{
+    double x[FLEET_N];
+    size_t size = base_snapshot_bytes(FLEET_N);
+    base_fleet_t a, b;
+
+    /* Check value: CRC-32C("123456789") */
+    if (base_crc32c(0, "123456789", 9) != 0xE3069283u ||
+        base_crc32c(base_crc32c(0, "1234", 4), "56789", 5) != 0xE3069283u) {
+        TEST_FAIL("Snapshot: Round trip", "CRC-32C check value");
+        return;
+    }
+    if (size == 0 || size > sizeof(snap_buf) || base_snapshot_bytes(0) != 0) {
+        TEST_FAIL("Snapshot: Round trip", "bad size");
+        return;
+    }
+
+    base_fleet_init(&a, fleet_mem, sizeof(fleet_mem), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+    for (int step = 0; step < 40; step++) {
+        for (size_t i = 0; i < FLEET_N; i++) {
+            x[i] = (double)(i % 7) * 20.0 + (double)((step * 7 + (int)i) % 5);
+            if (i % 13 == 0 && step > 30) x[i] += 100.0;  /* DEVIATION */
+            if (i % 17 == 0 && step == 25) x[i] = NAN;    /* Fault     */
+        }
+        base_fleet_step(&a, x, NULL);
+    }
+    base_fleet_init(&b, fleet_mem2, sizeof(fleet_mem2), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+
+    if (base_snapshot_save(&a, snap_buf, size - 1) != BASE_SNAP_ERR_SIZE ||
+        base_snapshot_save(&a, snap_buf, size) != BASE_SNAP_OK ||
+        base_snapshot_load(&b, snap_buf, size) != BASE_SNAP_OK ||
+        !fleets_equal(&a, &b)) {
+        TEST_FAIL("Snapshot: Round trip", "fleet not restored");
+        return;
+    }
+
+    for (int step = 0; step < 20; step++) {
+        for (size_t i = 0; i < FLEET_N; i++) {
+            x[i] = (double)(i % 7) * 20.0 + (double)((step + (int)i) % 3);
+        }
+        base_fleet_step(&a, x, NULL);
+        base_fleet_step(&b, x, NULL);
+    }
+    if (!fleets_equal(&a, &b)) {
+        TEST_FAIL("Snapshot: Round trip", "restored fleet diverged");
+        return;
+    }
+
+    TEST_PASS("Snapshot: Save and load restore every stream exactly");
+}
+
+/**
+ * Snapshot: Quiet streams
+ *
+ * A STABLE stream fed a constant decays σ² below ε and stays STABLE
+ * (INV-2 only asks σ² > ε on leaving LEARNING): a fleet of them is a
+ * running fleet, and its snapshot must load.
+ */
+static void test_snapshot_quiet(void)
+{
+    double x[FLEET_N];
+    size_t size = base_snapshot_bytes(FLEET_N);
+    base_fleet_t a, b;
+
+    base_fleet_init(&a, fleet_mem, sizeof(fleet_mem), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+    for (int step = 0; step < 440; step++) {
+        for (size_t i = 0; i < FLEET_N; i++) {
+            x[i] = (step >= 40) ? 0.0 : ((step & 1) ? 1.0 : -1.0);
+        }
+        base_fleet_step(&a, x, NULL);
+    }
+    /* Q16.16 rounds this ε to 0 and σ² stalls a few ulps above it */
+    if (base_fleet_state(&a, 0) != BASE_STABLE
+#if !defined(BASE_FIXED_POINT)
+        || a.variance[0] > a.epsilon
+#endif
+       ) {
+        TEST_FAIL("Snapshot: Quiet streams", "variance did not decay");
+        return;
+    }
+
+    base_fleet_init(&b, fleet_mem2, sizeof(fleet_mem2), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+    if (base_snapshot_save(&a, snap_buf, size) != BASE_SNAP_OK ||
+        base_snapshot_load(&b, snap_buf, size) != BASE_SNAP_OK ||
+        !fleets_equal(&a, &b)) {
+        TEST_FAIL("Snapshot: Quiet streams", "running fleet rejected");
+        return;
+    }
+
+    TEST_PASS("Snapshot: Quiet streams with sigma^2 below epsilon load");
+}
+
+/**
+ * Snapshot: Rejection
+ *
+ * Truncated, corrupted, foreign, mismatched and invariant-breaking
+ * snapshots are each rejected with their own error, and the fleet is
+ * left untouched.
+ */
+static void test_snapshot_rejects(void)
+{
+    static unsigned char bad[sizeof(snap_buf)];
+    double x[FLEET_N];
+    size_t size = base_snapshot_bytes(FLEET_N);
+    size_t state_col = BASE_SNAPSHOT_HEADER +
+                       FLEET_N * (3 * sizeof(base_value_t) + sizeof(uint32_t));
+    base_config_t cfg = BASE_DEFAULT_CONFIG;
+    base_fleet_t a, b, other;
+
+    base_fleet_init(&a, fleet_mem, sizeof(fleet_mem), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        x[i] = 10.0 + (double)(i % 4);
+    }
+    base_fleet_step(&a, x, NULL);
+    base_snapshot_save(&a, snap_buf, size);
+
+    /* b holds different streams; every rejection must leave them */
+    base_fleet_init(&b, fleet_mem2, sizeof(fleet_mem2), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+
+    memcpy(bad, snap_buf, size);
+    bad[BASE_SNAPSHOT_HEADER + 5] ^= 0x10;
+    if (base_snapshot_load(&b, bad, size) != BASE_SNAP_ERR_CRC) {
+        TEST_FAIL("Snapshot: Rejection", "corrupted payload accepted");
+        return;
+    }
+    memcpy(bad, snap_buf, size);
+    bad[20] ^= 0x01;
+    if (base_snapshot_load(&b, bad, size) != BASE_SNAP_ERR_CRC) {
+        TEST_FAIL("Snapshot: Rejection", "corrupted header accepted");
+        return;
+    }
+    memcpy(bad, snap_buf, size);
+    bad[0] = 'X';
+    if (base_snapshot_load(&b, bad, size) != BASE_SNAP_ERR_FORMAT) {
+        TEST_FAIL("Snapshot: Rejection", "bad magic accepted");
+        return;
+    }
+    memcpy(bad, snap_buf, size);
+    bad[4] = 2;
+    if (base_snapshot_load(&b, bad, size) != BASE_SNAP_ERR_FORMAT) {
+        TEST_FAIL("Snapshot: Rejection", "future version accepted");
+        return;
+    }
+    if (base_snapshot_load(&b, snap_buf, size - 1) != BASE_SNAP_ERR_SIZE ||
+        base_snapshot_load(&b, snap_buf, 10) != BASE_SNAP_ERR_SIZE) {
+        TEST_FAIL("Snapshot: Rejection", "truncated snapshot accepted");
+        return;
+    }
+
+    /* Another configuration or stream count */
+    cfg.k = 4.0;
+    base_fleet_init(&other, fleet_mem2, sizeof(fleet_mem2), FLEET_N, &cfg);
+    if (base_snapshot_load(&other, snap_buf, size) != BASE_SNAP_ERR_CONFIG) {
+        TEST_FAIL("Snapshot: Rejection", "other config accepted");
+        return;
+    }
+    base_fleet_init(&other, fleet_mem2, sizeof(fleet_mem2), FLEET_N - 1,
+                    &BASE_DEFAULT_CONFIG);
+    if (base_snapshot_load(&other, snap_buf, size) != BASE_SNAP_ERR_CONFIG) {
+        TEST_FAIL("Snapshot: Rejection", "other stream count accepted");
+        return;
+    }
+    base_fleet_init(&b, fleet_mem2, sizeof(fleet_mem2), FLEET_N,
+                    &BASE_DEFAULT_CONFIG);
+
+    /* Valid checksums over broken streams: INV-1, INV-2, INV-3, INV-5, INV-6 */
+    for (int breach = 0; breach < 5; breach++) {
+        base_value_t v = (base_value_t)-1;
+
+        memcpy(bad, snap_buf, size);
+        switch (breach) {
+        case 0: bad[state_col + 100] = 3; break;
+        case 1: bad[state_col + FLEET_N + 100] = 1; break;
+        case 4:
+            /* STABLE after one observation: count < n_min */
+            bad[state_col + 100] = (uint8_t)BASE_STABLE;
+            break;
+        case 2:
+            memcpy(bad + BASE_SNAPSHOT_HEADER +
+                   (FLEET_N + 100) * sizeof(base_value_t), &v, sizeof(v));
+            break;
+        default:
+            memcpy(bad + BASE_SNAPSHOT_HEADER +
+                   (2 * FLEET_N + 100) * sizeof(base_value_t), &v, sizeof(v));
+            break;
+        }
+        snap_reseal(bad, size);
+        if (base_snapshot_load(&b, bad, size) != BASE_SNAP_ERR_STATE) {
+            TEST_FAIL("Snapshot: Rejection", "broken invariant accepted");
+            return;
+        }
+    }
+
+    for (size_t i = 0; i < FLEET_N; i++) {
+        if (b.count[i] != 0 || b.state[i] != (uint8_t)BASE_LEARNING) {
+            TEST_FAIL("Snapshot: Rejection", "rejected load wrote the fleet");
+            return;
+        }
+    }
+
+    a.in_step = 1;
+    if (base_snapshot_save(&a, snap_buf, size) != BASE_SNAP_ERR_BUSY ||
+        base_snapshot_load(NULL, snap_buf, size) != BASE_SNAP_ERR_NULL) {
+        TEST_FAIL("Snapshot: Rejection", "busy or NULL accepted");
+        return;
+    }
+
+    TEST_PASS("Snapshot: Corrupt, foreign and invalid snapshots rejected");
+}
+
 /*===========================================================================
  * MAIN
  *===========================================================================*/
@@ -662,6 +2216,55 @@ int main(void)
     test_edge_reset_clears_faults();
     printf("\n");
     
+    printf("Batch Tests:\n");
+    test_batch_matches_step();
+    test_batch_outputs_and_reentry();
+    printf("\n");
+    
+    printf("Fast Path Tests:\n");
+    test_fast_matches_step();
+    printf("\n");
+    
+    printf("Timed Tests:\n");
+    test_timed_regular_matches_step();
+    test_timed_decay();
+    printf("\n");
+    
+    printf("Robust Tests:\n");
+    test_robust_matches_sort();
+    test_robust_spikes_and_faults();
+    test_robust_periodic();
+    printf("\n");
+    
+    printf("Multivariate Tests:\n");
+    test_multi_matches_step();
+    test_multi_correlated();
+    printf("\n");
+    
+    printf("Sketch Tests:\n");
+    test_sketch_quantiles();
+    test_sketch_merge();
+    printf("\n");
+    
+    printf("Backfill Tests:\n");
+    test_backfill_matches_step();
+    test_backfill_fallback();
+    printf("\n");
+    
+    printf("Fleet Tests:\n");
+#if !defined(BASE_FLOAT32) && !defined(BASE_FIXED_POINT)
+    test_fleet_kernels_match_step();
+#endif
+    test_fleet_precision_bounds();
+    test_fleet_fault_isolation();
+    printf("\n");
+    
+    printf("Snapshot Tests:\n");
+    test_snapshot_round_trip();
+    test_snapshot_quiet();
+    test_snapshot_rejects();
+    printf("\n");
+    
     printf("══════════════════════════════════════════════════════════════════\n");
     printf("  Results: %d/%d tests passed\n", tests_passed, tests_run);
     printf("══════════════════════════════════════════════════════════════════\n");
@@ -0,0 +1,132 @@
+/**
+ * pulse_feed.h - Transition-Only Change Feed
+ *
+ * A consumer that wants to know what changed must otherwise call
+ * hb_state() on every monitor after every step: O(monitors) per tick
+ * even when nothing happened. The feed records one entry per actual
+ * change of st, so the consumer pays O(changes).
+ *
+ *   evaluator (producer)                 consumer (alerting, logging)
+ *   --------------------                 ----------------------------
+ *   hb_step_feed(m, q, id, ...)          while (hb_feed_pop(q, &c)) ...
+ *   hb_fleet_step_feed(f, q, ...)
+ *
+ * The feed is a fixed-size single-producer, single-consumer ring over
+ * caller-provided memory. Neither side ever blocks or allocates. When
+ * the ring is full the change is dropped and the feed remembers it;
+ * once the consumer has drained the ring it receives HB_FEED_RESYNC,
+ * meaning "changes were lost: read the state of every monitor again".
+ *
+ * CONTRACTS:
+ *   1. COMPLETENESS: Every change of st made through the *_feed step
+ *      functions is either delivered, or followed by HB_FEED_RESYNC.
+ *   2. ORDER:        Entries are delivered in the order they occurred.
+ *   3. QUIET:        A step that leaves st unchanged writes nothing.
+ *   The pulse.h contracts are untouched: the feed only observes.
+ *
+ * REQUIREMENTS:
+ *   - One producer thread and one consumer thread per feed
+ *   - Lock-free atomics on the target (checked at compile time)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_FEED_H
+#define PULSE_FEED_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse.h"
+#include "pulse_fleet.h"
+
+#if defined(ATOMIC_LONG_LOCK_FREE) && ATOMIC_LONG_LOCK_FREE != 2
+#error "pulse_feed.h needs lock-free atomics to be non-blocking"
+#endif
+
+/** One observed transition of one monitor. */
+typedef struct {
+    uint64_t t;       /* now of the step that made the change */
+    uint32_t id;      /* Monitor id (fleet index or caller's)  */
+    uint8_t  old_st;  /* state_t before the step               */
+    uint8_t  new_st;  /* state_t after the step                */
+} hb_change_t;
+
+/** Result of hb_feed_pop(). */
+typedef enum {
+    HB_FEED_EMPTY  = 0,  /* Nothing to report                         */
+    HB_FEED_CHANGE = 1,  /* *out holds the next change                */
+    HB_FEED_RESYNC = 2   /* Changes were lost: rescan every monitor   */
+} hb_feed_result_t;
+
+/**
+ * Change feed ring.
+ *
+ * INVARIANTS:
+ *   INV-F1: 0 <= head - tail <= cap (free-running counters)
+ *   INV-F2: cap is a power of two
+ */
+typedef struct {
+    hb_change_t         *buf;   /* Caller-provided ring storage        */
+    size_t               cap;   /* Entries in buf                      */
+    _Atomic size_t       head;  /* Next slot to write (producer)       */
+    _Atomic size_t       tail;  /* Next slot to read (consumer)        */
+    atomic_uchar         lost;  /* A change was dropped since last
+                                   HB_FEED_RESYNC                      */
+} hb_feed_t;
+
+/**
+ * Initialise an empty feed.
+ *
+ * @param q   Pointer to feed (not yet shared with other threads)
+ * @param buf Ring storage of cap entries
+ * @param cap Number of entries, a power of two >= 2
+ * @return    0 on success, -1 on invalid parameters
+ */
+int hb_feed_init(hb_feed_t *q, hb_change_t *buf, size_t cap);
+
+/**
+ * Record one change. Producer side; never blocks.
+ *
+ * @return 1 if recorded, 0 if the ring was full and the change dropped
+ */
+uint8_t hb_feed_push(hb_feed_t *q, uint32_t id, state_t old_st,
+                     state_t new_st, uint64_t t);
+
+/**
+ * Take the next entry. Consumer side; never blocks.
+ *
+ * @param q   Pointer to initialised feed
+ * @param out Receives the change when HB_FEED_CHANGE is returned
+ * @return    HB_FEED_CHANGE, HB_FEED_RESYNC once the ring is drained
+ *            after a loss, or HB_FEED_EMPTY
+ */
+hb_feed_result_t hb_feed_pop(hb_feed_t *q, hb_change_t *out);
+
+/**
+ * hb_step() that logs a change of st to the feed.
+ *
+ * @param m       Pointer to initialised state machine
+ * @param q       Feed this monitor reports to
+ * @param id      Id to record for this monitor
+ * @param now     Current timestamp
+ * @param hb_seen 1 if heartbeat observed this step, 0 otherwise
+ * @param T       Timeout threshold (time units)
+ * @param W       Initialisation window (time units)
+ */
+void hb_step_feed(hb_fsm_t *m, hb_feed_t *q, uint32_t id, uint64_t now,
+                  uint8_t hb_seen, uint64_t T, uint64_t W);
+
+/**
+ * hb_fleet_step() that logs every change of st to the feed, with the
+ * monitor index as id. The fleet must have fewer than 2^32 monitors.
+ *
+ * A reentrant call is a second producer and must not touch the ring:
+ * it faults the fleet as hb_fleet_step() does and marks the feed lost,
+ * so the consumer is told to resync.
+ */
+void hb_fleet_step_feed(hb_fleet_t *f, hb_feed_t *q, uint64_t now,
+                        const uint64_t *seen_bitmap, uint64_t T, uint64_t W);
+
+#endif /* PULSE_FEED_H */
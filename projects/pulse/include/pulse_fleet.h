@@ -0,0 +1,167 @@
+/**
+ * pulse_fleet.h - Structure-of-Arrays Fleet of Liveness Monitors
+ *
+ * The same closed, total, deterministic state machine as pulse.h,
+ * stored column-wise so that N monitors can be stepped in one linear
+ * pass over contiguous memory.
+ *
+ * An array of hb_fsm_t costs 32 bytes per monitor, most of it padding,
+ * and every sweep chases one struct at a time. The fleet keeps each
+ * field of hb_fsm_t in its own column:
+ *
+ *   last_hb[]       uint64_t   8 bytes
+ *   t_init[]        uint64_t   8 bytes
+ *   st[]            uint8_t    1 byte
+ *   have_hb[]       uint8_t    1 byte
+ *   fault_time[]    uint8_t    1 byte
+ *   fault_reentry[] uint8_t    1 byte
+ *
+ * CONTRACTS:
+ *   Identical to pulse.h. Monitor i of a fleet stepped with
+ *   hb_fleet_step() reaches exactly the state an hb_fsm_t would reach
+ *   under hb_step() with hb_seen = bit i of the seen bitmap.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to the whole fleet (caller must ensure)
+ *   - Monotonic time source (caller provides)
+ *   - Backing memory provided by the caller (no allocation here)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_FLEET_H
+#define PULSE_FLEET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse.h"
+
+/**
+ * Implementation of the per-monitor step body (see pulse_kernel.h).
+ *
+ * All kernels produce identical results; they differ only in speed.
+ */
+typedef enum {
+    HB_KERNEL_SCALAR = 0,  /* Portable C                        */
+    HB_KERNEL_AVX2   = 1,  /* 4 monitors per step, x86-64 AVX2   */
+    HB_KERNEL_AVX512 = 2   /* 8 monitors per step, AVX-512F      */
+} hb_kernel_t;
+
+/**
+ * Fleet of heartbeat monitors, one column per hb_fsm_t field.
+ *
+ * INVARIANTS (for every i < n):
+ *   INV-1: st[i] ∈ { UNKNOWN, ALIVE, DEAD }
+ *   INV-2: (st[i] == ALIVE) → (have_hb[i] == 1)
+ *   INV-3: (fault_time[i] ∨ fault_reentry[i]) → (st[i] == DEAD)
+ *   INV-4: (in_step == 0) when not executing hb_fleet_step
+ *
+ * The per-monitor reentrancy guard of hb_fsm_t becomes a single
+ * fleet-wide guard: the fleet is the unit of atomicity.
+ */
+typedef struct {
+    size_t    n;             /* Number of monitors                   */
+    uint64_t *last_hb;       /* Column: most recent heartbeat        */
+    uint64_t *t_init;        /* Column: boot/reset reference time    */
+    uint8_t  *st;            /* Column: state_t, stored as one byte  */
+    uint8_t  *have_hb;       /* Column: evidence flag                */
+    uint8_t  *fault_time;    /* Column: clock corruption detected    */
+    uint8_t  *fault_reentry; /* Column: atomicity violation detected */
+    uint8_t   in_step;       /* Fleet-wide reentrancy guard          */
+    hb_kernel_t kernel;      /* Step kernel used by hb_fleet_step    */
+} hb_fleet_t;
+
+/** Number of uint64_t words in a seen bitmap covering n monitors. */
+#define HB_FLEET_WORDS(n) (((n) + 63u) / 64u)
+
+/**
+ * Bytes of backing memory required for a fleet of n monitors.
+ *
+ * Each column starts on a 64-byte boundary relative to the start of
+ * the buffer, so a 64-byte-aligned buffer gives cache-aligned columns.
+ *
+ * @param n Number of monitors
+ * @return  Required size in bytes (0 if n is 0 or the size overflows)
+ */
+size_t hb_fleet_bytes(size_t n);
+
+/**
+ * Initialise a fleet over caller-provided memory.
+ *
+ * Every monitor is initialised as if by hb_init(m, now), and the
+ * fleet is set to step with the widest kernel this CPU supports.
+ *
+ * @param f        Pointer to fleet structure
+ * @param mem      Backing memory, at least 8-byte aligned
+ * @param mem_size Size of mem in bytes (>= hb_fleet_bytes(n))
+ * @param n        Number of monitors (> 0)
+ * @param now      Current timestamp from monotonic source
+ * @return         0 on success, -1 on invalid parameters
+ */
+int hb_fleet_init(hb_fleet_t *f, void *mem, size_t mem_size,
+                  size_t n, uint64_t now);
+
+/**
+ * Execute one atomic step of every monitor in the fleet.
+ *
+ * Equivalent to calling hb_step(&m[i], now, seen_i, T, W) for every
+ * i in order, where seen_i is bit (i % 64) of seen_bitmap[i / 64].
+ *
+ * @param f           Pointer to initialised fleet
+ * @param now         Current timestamp
+ * @param seen_bitmap HB_FLEET_WORDS(n) words of heartbeat bits,
+ *                    or NULL if no heartbeat was seen this step
+ * @param T           Timeout threshold (time units)
+ * @param W           Initialisation window (time units)
+ */
+void hb_fleet_step(hb_fleet_t *f, uint64_t now,
+                   const uint64_t *seen_bitmap, uint64_t T, uint64_t W);
+
+/**
+ * Record heartbeats without evaluating: for every set bit i of bits,
+ * last_hb[i] = now and have_hb[i] = 1. Nothing else changes.
+ *
+ * Cost is proportional to the number of set bits, not to n: each word
+ * is walked with count-trailing-zeros, and all-zero words are skipped.
+ * Follow with a sweep, hb_fleet_step(f, now, NULL, T, W); marking and
+ * sweeping at the same now is equivalent to hb_fleet_step(f, now, bits,
+ * T, W). Several marks may precede one sweep; the last mark of a monitor wins.
+ *
+ * A call made while hb_fleet_step() is running faults every monitor,
+ * exactly as a reentrant hb_fleet_step() does.
+ *
+ * @param f    Pointer to initialised fleet
+ * @param now  Timestamp to record for each marked monitor
+ * @param bits HB_FLEET_WORDS(n) words, bit (i % 64) of word i / 64 for
+ *             monitor i; bits past n are ignored. NULL marks nothing.
+ * @return     Number of monitors marked
+ */
+size_t hb_fleet_mark_seen_bitmap(hb_fleet_t *f, uint64_t now,
+                                 const uint64_t *bits);
+
+/**
+ * Choose the kernel used by hb_fleet_step().
+ *
+ * @param f Pointer to initialised fleet
+ * @param k Kernel to use
+ * @return  0 on success, -1 if k is not supported on this CPU
+ */
+int hb_fleet_set_kernel(hb_fleet_t *f, hb_kernel_t k);
+
+/** Query current state of monitor i. */
+static inline state_t hb_fleet_state(const hb_fleet_t *f, size_t i) {
+    return (state_t)f->st[i];
+}
+
+/** Check if monitor i has detected any fault. */
+static inline uint8_t hb_fleet_faulted(const hb_fleet_t *f, size_t i) {
+    return f->fault_time[i] || f->fault_reentry[i];
+}
+
+/** Check if monitor i has ever observed evidence. */
+static inline uint8_t hb_fleet_has_evidence(const hb_fleet_t *f, size_t i) {
+    return f->have_hb[i];
+}
+
+#endif /* PULSE_FLEET_H */
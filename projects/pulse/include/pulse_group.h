@@ -0,0 +1,152 @@
+/**
+ * pulse_group.h - Incremental Liveness Counts per Group
+ *
+ * "How many monitors in rack R are ALIVE?" answered by scanning every
+ * monitor costs O(monitors) per query. This layer keeps, for every
+ * group, one counter per state and moves a monitor between counters
+ * only when its state actually changes. A query is then O(1) per
+ * group and a full dashboard O(groups).
+ *
+ * Groups may nest: each group names an optional parent, and a
+ * transition is applied to the monitor's group and every ancestor.
+ * Racks with zones as parents give per-rack and per-zone counts from
+ * the same step.
+ *
+ *   zone 0 (group 4)        zone 1 (group 5)
+ *    ├── rack 0 (group 0)    ├── rack 2 (group 2)
+ *    └── rack 1 (group 1)    └── rack 3 (group 3)
+ *
+ * A group may also carry a quorum, the minimum number of ALIVE
+ * monitors it needs. The step functions return how many times a
+ * group crossed its quorum, so an alert can fire in the same tick.
+ * A group that loses and regains quorum within one fleet step counts
+ * twice; hb_groups_has_quorum() gives the settled answer.
+ *
+ * CONTRACTS:
+ *   1. EXACTNESS: count(k, s) equals the number of monitors in group
+ *                 k or any descendant whose state is s, provided
+ *                 every change of state passes through this layer.
+ *   2. QUIET:     A step that leaves a state unchanged costs no
+ *                 counter update.
+ *   The pulse.h contracts are untouched: groups only observe.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to groups and monitors together
+ *   - Every state change reported: through the *_step functions here,
+ *     hb_groups_move() (e.g. from a pulse_feed.h consumer), or a
+ *     rebuild after any change made elsewhere
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_GROUP_H
+#define PULSE_GROUP_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse.h"
+#include "pulse_fleet.h"
+
+#define HB_GROUP_NONE   0xFFFFFFFFu  /* No group / no parent     */
+#define HB_GROUP_STATES 3            /* UNKNOWN, ALIVE, DEAD     */
+
+/**
+ * Per-group state counters over caller-provided memory.
+ *
+ * INVARIANTS (for every group k):
+ *   INV-G1: parent[k] == HB_GROUP_NONE or k < parent[k] < n_groups
+ *   INV-G2: sum over s of count[k][s] == monitors in k's subtree
+ *   INV-G3: group_of[i] == HB_GROUP_NONE or group_of[i] < n_groups
+ */
+typedef struct {
+    size_t          n_groups;    /* Number of groups                  */
+    size_t          n_monitors;  /* Number of monitors mapped         */
+    const uint32_t *group_of;    /* Monitor -> group (caller's array) */
+    const uint32_t *parent;      /* Group -> parent (caller's array)  */
+    uint32_t       *count;       /* count[k * 3 + state]              */
+    uint32_t       *quorum;      /* Minimum ALIVE per group, 0 = none */
+} hb_groups_t;
+
+/**
+ * Bytes of backing memory required for n_groups groups.
+ *
+ * @return Required size in bytes (0 if n_groups is 0 or too large)
+ */
+size_t hb_groups_bytes(size_t n_groups);
+
+/**
+ * Initialise groups over caller-provided memory.
+ *
+ * Every monitor starts counted as UNKNOWN, matching freshly
+ * initialised monitors; use a rebuild when attaching to monitors that
+ * have already run. No group has a quorum. The parent and group_of
+ * arrays are borrowed, not copied, and must outlive g.
+ *
+ * @param g          Pointer to groups structure
+ * @param mem        Backing memory, at least 4-byte aligned
+ * @param mem_size   Size of mem in bytes (>= hb_groups_bytes(n_groups))
+ * @param n_groups   Number of groups (> 0, < HB_GROUP_NONE)
+ * @param parent     n_groups entries; a parent has a larger index than
+ *                   its children, or is HB_GROUP_NONE. NULL: flat.
+ * @param group_of   n_monitors entries, each a group or HB_GROUP_NONE
+ * @param n_monitors Number of monitors (< 2^32)
+ * @return           0 on success, -1 on invalid parameters
+ */
+int hb_groups_init(hb_groups_t *g, void *mem, size_t mem_size,
+                   size_t n_groups, const uint32_t *parent,
+                   const uint32_t *group_of, size_t n_monitors);
+
+/**
+ * Set the quorum of group k: the group has quorum while at least q of
+ * its monitors are ALIVE. q = 0 removes the quorum.
+ *
+ * @return 0 on success, -1 if k is out of range
+ */
+int hb_groups_set_quorum(hb_groups_t *g, size_t k, uint32_t q);
+
+/**
+ * Record that monitor id changed state, in its group and every
+ * ancestor. Nothing happens when old_st == new_st.
+ *
+ * @return Number of quorum crossings
+ */
+size_t hb_groups_move(hb_groups_t *g, size_t id, state_t old_st,
+                      state_t new_st);
+
+/**
+ * hb_step() on monitor id, then hb_groups_move() if its state changed.
+ *
+ * @return Number of quorum crossings
+ */
+size_t hb_groups_step(hb_groups_t *g, hb_fsm_t *m, size_t id,
+                      uint64_t now, uint8_t hb_seen, uint64_t T, uint64_t W);
+
+/**
+ * hb_fleet_step(), then hb_groups_move() for every monitor whose state
+ * changed. Monitor i of the fleet is monitor i of the groups.
+ *
+ * @return Number of quorum crossings
+ */
+size_t hb_groups_fleet_step(hb_groups_t *g, hb_fleet_t *f, uint64_t now,
+                            const uint64_t *seen_bitmap,
+                            uint64_t T, uint64_t W);
+
+/**
+ * Recount every group from the fleet's current states, O(monitors).
+ * Use after changes made outside this layer, or on HB_FEED_RESYNC.
+ */
+void hb_groups_rebuild_fleet(hb_groups_t *g, const hb_fleet_t *f);
+
+/** Number of monitors in group k (and descendants) in state s. */
+static inline uint32_t hb_groups_count(const hb_groups_t *g, size_t k,
+                                       state_t s) {
+    return g->count[k * HB_GROUP_STATES + (size_t)s];
+}
+
+/** Check if group k meets its quorum (always true with no quorum). */
+static inline uint8_t hb_groups_has_quorum(const hb_groups_t *g, size_t k) {
+    return hb_groups_count(g, k, STATE_ALIVE) >= g->quorum[k];
+}
+
+#endif /* PULSE_GROUP_H */
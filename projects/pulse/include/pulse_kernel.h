@@ -0,0 +1,66 @@
+/**
+ * pulse_kernel.h - Step Kernels for a Pulse Fleet
+ *
+ * hb_fleet_step() spends its time in a handful of compares on
+ * now - last_hb. That body is the "kernel"; this header exposes one
+ * portable and two SIMD implementations of it, all computing the same
+ * transition as hb_step() over one 64-monitor block of a fleet:
+ *
+ *   HB_KERNEL_SCALAR   Portable C, one monitor at a time
+ *   HB_KERNEL_AVX2     4 monitors per 256-bit vector
+ *   HB_KERNEL_AVX512   8 monitors per 512-bit vector (AVX-512F)
+ *
+ * hb_fleet_init() picks the widest kernel the running CPU supports
+ * (hb_kernel_best()); hb_fleet_set_kernel() overrides the choice.
+ * The SIMD kernels are compiled with per-function target attributes,
+ * so the library itself still runs on any x86-64, and on other
+ * architectures or compilers only the scalar kernel exists.
+ *
+ * CONTRACTS:
+ *   Every kernel leaves the fleet columns bit-identical to the scalar
+ *   kernel, which is a transcription of hb_step(): the same modular
+ *   age, the same half-range validity rule and the same age > T test.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_KERNEL_H
+#define PULSE_KERNEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse_fleet.h"
+
+/**
+ * Step one block of monitors [base, end), end - base <= 64.
+ *
+ * Monitor base + j saw a heartbeat iff bit j of seen is set.
+ * The caller holds the fleet's reentrancy guard.
+ */
+typedef void (*hb_kernel_fn)(hb_fleet_t *f, size_t base, size_t end,
+                             uint64_t seen, uint64_t now, uint64_t T);
+
+/**
+ * Check whether a kernel can run on this CPU.
+ *
+ * @param k Kernel to test
+ * @return  1 if compiled in and supported by the CPU, 0 otherwise
+ */
+uint8_t hb_kernel_supported(hb_kernel_t k);
+
+/** Widest kernel supported by the running CPU. */
+hb_kernel_t hb_kernel_best(void);
+
+/**
+ * Look up the implementation of a kernel.
+ *
+ * @param k Kernel to look up
+ * @return  Block function, or the scalar kernel if k is unsupported
+ */
+hb_kernel_fn hb_kernel_get(hb_kernel_t k);
+
+/** Human-readable kernel name ("scalar", "avx2", "avx512"). */
+const char *hb_kernel_name(hb_kernel_t k);
+
+#endif /* PULSE_KERNEL_H */
@@ -0,0 +1,95 @@
+/**
+ * pulse_mailbox.h - Multi-Producer Heartbeat Recording
+ *
+ * hb_step() requires a single writer: a concurrent entry trips the
+ * in_step guard, sets fault_reentry and kills the monitor. When
+ * heartbeats arrive on many I/O threads, the only safe option so far
+ * has been a mutex around every hb_step() call.
+ *
+ * The mailbox splits the work:
+ *
+ *   producers (any number)        evaluator (exactly one)
+ *   ----------------------        -----------------------
+ *   hb_post(mb, ts)               hb_step_mailbox(m, mb, now, T, W)
+ *     wait-free atomic stores       collects the latest posted ts,
+ *                                   then runs the hb_step transition
+ *
+ * The hb_fsm_t itself is touched only by the evaluator, so the
+ * single-writer requirement of pulse.h still holds.
+ *
+ * CONTRACTS:
+ *   1. SOUNDNESS is preserved. The recorded heartbeat time is never
+ *      later than a heartbeat that actually happened, nor later than
+ *      the evaluator's now. Racing producers may leave an older
+ *      timestamp in the mailbox; that only makes the computed age
+ *      larger, so DEAD can come earlier, never ALIVE later.
+ *   2. LIVENESS and STABILITY are inherited from hb_step().
+ *
+ * REQUIREMENTS:
+ *   - One evaluator thread per monitor (caller must ensure)
+ *   - Producers and evaluator read the same monotonic clock
+ *   - Lock-free 64-bit atomics on the target (checked at compile time)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_MAILBOX_H
+#define PULSE_MAILBOX_H
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include "pulse.h"
+
+#if defined(ATOMIC_LLONG_LOCK_FREE) && ATOMIC_LLONG_LOCK_FREE != 2
+#error "pulse_mailbox.h needs lock-free 64-bit atomics to be wait-free"
+#endif
+
+/**
+ * Heartbeat mailbox shared by producers and one evaluator.
+ *
+ * Place mailboxes of different monitors on separate cache lines if
+ * their producers are hot; otherwise they will share lines.
+ */
+typedef struct {
+    _Atomic uint64_t latest;   /* Most recently posted timestamp      */
+    atomic_uchar     pending;  /* 1 if posted since the last collect  */
+} hb_mailbox_t;
+
+/**
+ * Initialise an empty mailbox.
+ *
+ * @param mb Pointer to mailbox (not yet shared with other threads)
+ */
+void hb_mailbox_init(hb_mailbox_t *mb);
+
+/**
+ * Post a heartbeat. Wait-free; safe from any number of threads.
+ *
+ * @param mb Pointer to initialised mailbox
+ * @param ts Timestamp of the heartbeat from the shared monotonic clock
+ */
+static inline void hb_post(hb_mailbox_t *mb, uint64_t ts) {
+    atomic_store_explicit(&mb->latest, ts, memory_order_relaxed);
+    /* Release: an evaluator that sees pending also sees ts (or newer) */
+    atomic_store_explicit(&mb->pending, 1, memory_order_release);
+}
+
+/**
+ * Collect any posted heartbeat and execute one step of the monitor.
+ *
+ * Must only be called from the single evaluator thread.
+ *
+ * @param m   Pointer to initialised state machine
+ * @param mb  Mailbox fed by the producers of this monitor
+ * @param now Current timestamp
+ * @param T   Timeout threshold (time units)
+ * @param W   Initialisation window (time units)
+ *
+ * A posted timestamp ahead of now is recorded as now; one older than
+ * the heartbeat already held is ignored.
+ */
+void hb_step_mailbox(hb_fsm_t *m, hb_mailbox_t *mb, uint64_t now,
+                     uint64_t T, uint64_t W);
+
+#endif /* PULSE_MAILBOX_H */
@@ -0,0 +1,162 @@
+/**
+ * pulse_packed.h - Compact 16-Byte Liveness Monitors
+ *
+ * hb_fsm_t carries two absolute 64-bit timestamps and four flag bytes,
+ * 32 bytes per monitor once padded: two monitors per cache line. When
+ * a fleet sweep is limited by memory bandwidth, that is the cost.
+ *
+ * A packed fleet stores timestamps as 32-bit offsets from one
+ * fleet-wide 64-bit epoch, and the state with its flags in one byte:
+ *
+ *   hb_packed_t (16 bytes, 16-byte aligned: four per cache line)
+ *     last_hb   uint32_t   last heartbeat - epoch
+ *     t_init    uint32_t   boot/reset time - epoch
+ *     bits      uint8_t    st | have_hb | fault_time | fault_reentry
+ *                          | last_far | init_far
+ *
+ * WINDOW AND REBASING:
+ *   Offsets span [epoch, epoch + 2^32). Before every step the fleet
+ *   checks that now lies in the middle half of that window,
+ *   [epoch + 2^30, epoch + 3 * 2^30); if not, hb_packed_rebase() moves
+ *   the epoch to now - 2^31 and shifts every offset. A timestamp that
+ *   falls off either end is pinned to that end and marked "far":
+ *
+ *     last_hb far behind   -> the monitor has been silent for more than
+ *                             2^31 units: DEAD by timeout
+ *     last_hb far ahead    -> the clock ran backwards past it: DEAD with
+ *                             fault_time, as the half-range rule says
+ *     t_init far behind    -> age is valid: stays UNKNOWN
+ *     t_init far ahead     -> fault_time, as the half-range rule says
+ *
+ *   Ages of in-window timestamps are computed exactly, in 64 bits, by
+ *   the same age_u64/age_valid half-range rule as pulse.c.
+ *
+ * CONTRACTS:
+ *   Monitor i of a packed fleet reaches exactly the state and flags of
+ *   an hb_fsm_t stepped by hb_step(), provided T < 2^30 and the clock
+ *   never falls 2^30 units or more below the latest now it has shown.
+ *   Outside those bounds a "far" timestamp can turn a fault into a
+ *   plain DEAD or UNKNOWN, or any verdict into DEAD, but never into
+ *   ALIVE: SOUNDNESS is preserved unconditionally.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to the whole fleet (caller must ensure)
+ *   - Monotonic time source (caller provides)
+ *   - Backing array provided by the caller (no allocation here)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_PACKED_H
+#define PULSE_PACKED_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse.h"
+
+/* Layout of hb_packed_t.bits */
+#define HB_PACKED_ST_MASK      0x03u  /* state_t in bits 0-1            */
+#define HB_PACKED_HAVE_HB      0x04u  /* Evidence flag                  */
+#define HB_PACKED_FAULT_TIME   0x08u  /* Clock corruption detected      */
+#define HB_PACKED_FAULT_REENTRY 0x10u /* Atomicity violation detected   */
+#define HB_PACKED_LAST_FAR     0x20u  /* last_hb pinned to window edge  */
+#define HB_PACKED_INIT_FAR     0x40u  /* t_init pinned to window edge   */
+
+/* Epoch window, in time units */
+#define HB_PACKED_WINDOW_LO    (1ULL << 30)   /* now - epoch lower bound */
+#define HB_PACKED_WINDOW_HI    (3ULL << 30)   /* now - epoch upper bound */
+#define HB_PACKED_WINDOW_MID   (1ULL << 31)   /* now - epoch after rebase */
+
+/**
+ * One packed monitor.
+ *
+ * INVARIANTS:
+ *   INV-1: (bits & ST_MASK) ∈ { UNKNOWN, ALIVE, DEAD }
+ *   INV-2: ALIVE → HAVE_HB
+ *   INV-3: (FAULT_TIME ∨ FAULT_REENTRY) → DEAD
+ *   INV-4: LAST_FAR → last_hb ∈ { 0, UINT32_MAX } (edge it fell off)
+ *   INV-5: INIT_FAR → t_init ∈ { 0, UINT32_MAX }
+ */
+typedef struct {
+    _Alignas(16) uint32_t last_hb;  /* Last heartbeat, epoch-relative */
+    uint32_t t_init;                /* Reset time, epoch-relative     */
+    uint8_t  bits;                  /* State and flags, see above     */
+} hb_packed_t;
+
+_Static_assert(sizeof(hb_packed_t) == 16, "hb_packed_t must be 16 bytes");
+
+/**
+ * Fleet of packed monitors sharing one epoch.
+ *
+ * The per-monitor reentrancy guard of hb_fsm_t becomes a single
+ * fleet-wide guard, as in hb_fleet_t.
+ */
+typedef struct {
+    size_t       n;        /* Number of monitors                 */
+    hb_packed_t *m;        /* Caller-provided array of n monitors */
+    uint64_t     epoch;    /* Absolute time of offset 0          */
+    uint8_t      in_step;  /* Fleet-wide reentrancy guard        */
+} hb_packed_fleet_t;
+
+/**
+ * Initialise a packed fleet over a caller-provided array.
+ *
+ * Every monitor is initialised as if by hb_init(m, now).
+ *
+ * @param f   Pointer to fleet structure
+ * @param m   Array of n monitors, 16-byte aligned
+ * @param n   Number of monitors (> 0)
+ * @param now Current timestamp from monotonic source
+ * @return    0 on success, -1 on invalid parameters
+ */
+int hb_packed_init(hb_packed_fleet_t *f, hb_packed_t *m, size_t n,
+                   uint64_t now);
+
+/**
+ * Move the epoch so that now sits in the middle of the window.
+ *
+ * Called by hb_packed_step() whenever now leaves the middle half of
+ * the window; exposed so an idle fleet can be rebased off the hot path.
+ * Costs one pass over the fleet.
+ *
+ * @param f   Pointer to initialised fleet
+ * @param now Current timestamp
+ */
+void hb_packed_rebase(hb_packed_fleet_t *f, uint64_t now);
+
+/**
+ * Execute one atomic step of every monitor in the fleet.
+ *
+ * Equivalent to hb_step(&m[i], now, seen_i, T, W) for every i, within
+ * the bounds stated under CONTRACTS, where seen_i is bit (i % 64) of
+ * seen_bitmap[i / 64].
+ *
+ * @param f           Pointer to initialised fleet
+ * @param now         Current timestamp
+ * @param seen_bitmap (n + 63) / 64 words of heartbeat bits,
+ *                    or NULL if no heartbeat was seen this step
+ * @param T           Timeout threshold (time units)
+ * @param W           Initialisation window (time units)
+ */
+void hb_packed_step(hb_packed_fleet_t *f, uint64_t now,
+                    const uint64_t *seen_bitmap, uint64_t T, uint64_t W);
+
+/** Query current state of monitor i. */
+static inline state_t hb_packed_state(const hb_packed_fleet_t *f, size_t i) {
+    return (state_t)(f->m[i].bits & HB_PACKED_ST_MASK);
+}
+
+/** Check if monitor i has detected any fault. */
+static inline uint8_t hb_packed_faulted(const hb_packed_fleet_t *f, size_t i) {
+    return (f->m[i].bits & (HB_PACKED_FAULT_TIME | HB_PACKED_FAULT_REENTRY))
+           != 0;
+}
+
+/** Check if monitor i has ever observed evidence. */
+static inline uint8_t hb_packed_has_evidence(const hb_packed_fleet_t *f,
+                                             size_t i) {
+    return (f->m[i].bits & HB_PACKED_HAVE_HB) != 0;
+}
+
+#endif /* PULSE_PACKED_H */
@@ -0,0 +1,145 @@
+/**
+ * pulse_wheel.h - Deadline Scheduler for a Pulse Fleet
+ *
+ * hb_step() only discovers that a monitor is DEAD when it is polled,
+ * so a supervisor that wants prompt verdicts must sweep the whole fleet
+ * every tick: O(N) per tick, even when nothing expires.
+ *
+ * The wheel indexes every ALIVE monitor of an hb_fleet_t by its
+ * deadline, last_hb + T + 1 (the first instant at which age > T).
+ * hb_advance() then visits only the monitors whose deadline has
+ * passed, and hb_wheel_heartbeat() reschedules a monitor in O(1).
+ *
+ * STRUCTURE:
+ *   A hierarchical timing wheel of HB_WHEEL_LEVELS levels with
+ *   HB_WHEEL_SLOTS slots each. Level L has a resolution of 64^L time
+ *   units, so four levels cover deadlines up to 2^24 units ahead;
+ *   anything further waits in the last slot of the top level and is
+ *   re-filed when that slot comes due. Slots are intrusive doubly
+ *   linked lists threaded through per-monitor index columns.
+ *
+ * CONTRACTS (inherited from pulse.h):
+ *   1. SOUNDNESS:  A monitor is declared DEAD only after re-checking
+ *                  age > T (or an invalid age) against the fleet's
+ *                  own columns. The wheel decides when to look, never
+ *                  what the verdict is.
+ *   2. LIVENESS:   Every scheduled monitor is visited no later than the
+ *                  first hb_advance() whose now reaches its deadline.
+ *   3. STABILITY:  A heartbeat before the deadline reschedules; no
+ *                  spurious DEAD.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access to fleet and wheel together (caller ensures)
+ *   - Monotonic time source (caller provides)
+ *   - While a wheel is attached, heartbeats go through
+ *     hb_wheel_heartbeat(). Monitors made ALIVE by hb_fleet_step() are
+ *     not scheduled until hb_wheel_init() is called again.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_WHEEL_H
+#define PULSE_WHEEL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse.h"
+#include "pulse_fleet.h"
+
+#define HB_WHEEL_LEVELS 4    /* Levels in the hierarchy          */
+#define HB_WHEEL_BITS   6    /* log2(slots per level)            */
+#define HB_WHEEL_SLOTS  64   /* Slots per level                  */
+#define HB_WHEEL_NONE   0xFFFFFFFFu  /* Null link / empty slot   */
+#define HB_WHEEL_IDLE   0xFFFFu      /* Monitor not scheduled    */
+
+/** Largest timeout a wheel accepts (keeps deadline arithmetic in range) */
+#define HB_WHEEL_T_MAX  ((1ULL << 62) - 1u)
+
+/**
+ * Timing wheel attached to one fleet.
+ *
+ * INVARIANTS:
+ *   INV-W1: Every monitor with slot[i] ≠ IDLE is on exactly one list,
+ *           the one named by slot[i].
+ *   INV-W2: Every scheduled deadline expiry[i] > now, except entries
+ *           left in the current level-0 slot by a capped hb_advance(),
+ *           which are due and are visited first by the next call.
+ *   INV-W3: Bit s of occupied[L] is set iff head[L][s] ≠ NONE.
+ */
+typedef struct {
+    hb_fleet_t *fleet;       /* Fleet whose deadlines are indexed      */
+    uint64_t    T;           /* Timeout threshold, fixed for the wheel */
+    uint64_t    now;         /* Wheel time: deadlines ≤ now are due    */
+    uint32_t   *next;        /* Column: next monitor in the same slot  */
+    uint32_t   *prev;        /* Column: previous monitor in the slot   */
+    uint64_t   *expiry;      /* Column: last_hb + T + 1                */
+    uint16_t   *slot;        /* Column: level * 64 + slot, or IDLE     */
+    uint32_t    head[HB_WHEEL_LEVELS][HB_WHEEL_SLOTS];
+    uint64_t    occupied[HB_WHEEL_LEVELS]; /* Non-empty slot bitmaps   */
+    uint8_t     fault_time;  /* hb_advance() saw time move backwards   */
+} hb_wheel_t;
+
+/**
+ * Bytes of backing memory required for a wheel over n monitors.
+ *
+ * @param n Number of monitors in the fleet
+ * @return  Required size in bytes (0 if n is 0 or too large)
+ */
+size_t hb_wheel_bytes(size_t n);
+
+/**
+ * Attach a wheel to an initialised fleet.
+ *
+ * Schedules every monitor that is currently ALIVE. Calling this again
+ * on the same memory rebuilds the schedule from the fleet's columns,
+ * e.g. after a full hb_fleet_step() sweep.
+ *
+ * @param w        Pointer to wheel structure
+ * @param f        Initialised fleet (n < 2^32 - 1)
+ * @param mem      Backing memory, at least 8-byte aligned
+ * @param mem_size Size of mem in bytes (>= hb_wheel_bytes(f->n))
+ * @param now      Current timestamp
+ * @param T        Timeout threshold (<= HB_WHEEL_T_MAX)
+ * @return         0 on success, -1 on invalid parameters
+ */
+int hb_wheel_init(hb_wheel_t *w, hb_fleet_t *f, void *mem, size_t mem_size,
+                  uint64_t now, uint64_t T);
+
+/**
+ * Record a heartbeat for monitor i and reschedule its deadline. O(1).
+ *
+ * Equivalent to hb_step(m, now, 1, T, W) on that monitor alone.
+ *
+ * @param w   Pointer to initialised wheel
+ * @param i   Monitor index (< fleet->n)
+ * @param now Timestamp of the heartbeat
+ */
+void hb_wheel_heartbeat(hb_wheel_t *w, size_t i, uint64_t now);
+
+/**
+ * Advance wheel time to now and expire every monitor whose deadline
+ * has passed.
+ *
+ * Cost is proportional to the number of due monitors plus the number
+ * of non-empty slots crossed, not to the fleet size.
+ *
+ * @param w       Pointer to initialised wheel
+ * @param now     Current timestamp (must not move backwards)
+ * @param expired Output: indices of monitors that became DEAD, or NULL
+ * @param cap     Capacity of expired (ignored if expired is NULL)
+ * @return        Number of monitors that became DEAD in this call
+ *
+ * If expired fills up, the call stops early and returns cap; call
+ * again with the same now to continue. A backwards now sets
+ * fault_time and returns 0; recover with hb_fleet_step() and
+ * hb_wheel_init(), which detect the fault per monitor.
+ */
+size_t hb_advance(hb_wheel_t *w, uint64_t now, uint32_t *expired, size_t cap);
+
+/** Check if monitor i currently has a pending deadline. */
+static inline uint8_t hb_wheel_scheduled(const hb_wheel_t *w, size_t i) {
+    return w->slot[i] != HB_WHEEL_IDLE;
+}
+
+#endif /* PULSE_WHEEL_H */
@@ -11,22 +11,7 @@
  */
 
 #include "pulse.h"
-
-/*---------------------------------------------------------------------------
- * Helper Functions
- *---------------------------------------------------------------------------*/
-
-/** Modular age computation: (now - then) mod 2^64 */
-static inline uint64_t age_u64(uint64_t now, uint64_t then)
-{
-    return (uint64_t)(now - then);
-}
-
-/** Half-range rule: valid if age < 2^63 */
-static inline uint8_t age_valid(uint64_t age)
-{
-    return (age < (1ULL << 63));
-}
+#include "pulse_internal.h"
 
 /*---------------------------------------------------------------------------
  * Public API
@@ -0,0 +1,129 @@
+/**
+ * pulse_feed.c - Transition-Only Change Feed Implementation
+ *
+ * The ring is the classic single-producer, single-consumer queue: the
+ * producer owns head, the consumer owns tail, and each publishes its
+ * counter with release ordering after touching the slot.
+ *
+ * The step wrappers compare st before and after the unchanged step
+ * code, so every transition still comes from hb_step() or the fleet
+ * step kernels.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "pulse_feed.h"
+#include "pulse_fleet_internal.h"
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Context of push_change() */
+struct push_ctx {
+    hb_feed_t *q;
+    uint64_t   now;
+};
+
+/** hb_fleet_change_fn: one fleet change onto the feed */
+static void push_change(void *ctx, size_t id, state_t old_st, state_t new_st)
+{
+    struct push_ctx *c = (struct push_ctx *)ctx;
+
+    (void)hb_feed_push(c->q, (uint32_t)id, old_st, new_st, c->now);
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+int hb_feed_init(hb_feed_t *q, hb_change_t *buf, size_t cap)
+{
+    if (q == NULL || buf == NULL || cap < 2 || (cap & (cap - 1u)) != 0) {
+        return -1;
+    }
+
+    q->buf = buf;
+    q->cap = cap;
+    atomic_init(&q->head, 0);
+    atomic_init(&q->tail, 0);
+    atomic_init(&q->lost, 0);
+    return 0;
+}
+
+uint8_t hb_feed_push(hb_feed_t *q, uint32_t id, state_t old_st,
+                     state_t new_st, uint64_t t)
+{
+    size_t head = atomic_load_explicit(&q->head, memory_order_relaxed);
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_acquire);
+    hb_change_t *c;
+
+    /* Full: drop, and make the consumer resync once it has drained */
+    if (head - tail >= q->cap) {
+        atomic_store_explicit(&q->lost, 1, memory_order_release);
+        return 0;
+    }
+
+    c = &q->buf[head & (q->cap - 1u)];
+    c->t = t;
+    c->id = id;
+    c->old_st = (uint8_t)old_st;
+    c->new_st = (uint8_t)new_st;
+
+    atomic_store_explicit(&q->head, head + 1u, memory_order_release);
+    return 1;
+}
+
+hb_feed_result_t hb_feed_pop(hb_feed_t *q, hb_change_t *out)
+{
+    size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+    size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+    if (head == tail) {
+        /* Drained: report any loss now, so the rescan sees the latest state */
+        if (atomic_exchange_explicit(&q->lost, 0, memory_order_acquire)) {
+            return HB_FEED_RESYNC;
+        }
+        return HB_FEED_EMPTY;
+    }
+
+    *out = q->buf[tail & (q->cap - 1u)];
+    atomic_store_explicit(&q->tail, tail + 1u, memory_order_release);
+    return HB_FEED_CHANGE;
+}
+
+void hb_step_feed(hb_fsm_t *m, hb_feed_t *q, uint32_t id, uint64_t now,
+                  uint8_t hb_seen, uint64_t T, uint64_t W)
+{
+    state_t old_st = m->st;
+
+    /* A reentrant call would be a second producer: flag, don't push */
+    if (m->in_step) {
+        hb_step(m, now, hb_seen, T, W);
+        atomic_store_explicit(&q->lost, 1, memory_order_release);
+        return;
+    }
+
+    hb_step(m, now, hb_seen, T, W);
+    if (m->st != old_st) {
+        (void)hb_feed_push(q, id, old_st, m->st, now);
+    }
+}
+
+void hb_fleet_step_feed(hb_fleet_t *f, hb_feed_t *q, uint64_t now,
+                        const uint64_t *seen_bitmap, uint64_t T, uint64_t W)
+{
+    struct push_ctx c;
+
+    /* W (init window) not used, exactly as in hb_step */
+    (void)W;
+
+    c.q = q;
+    c.now = now;
+
+    /* Reentrancy: the fleet faults as in hb_fleet_step, ask for a resync */
+    if (hb_fleet_step_changes(f, now, seen_bitmap, T, push_change, &c) != 0) {
+        atomic_store_explicit(&q->lost, 1, memory_order_release);
+    }
+}
@@ -0,0 +1,217 @@
+/**
+ * pulse_fleet.c - Structure-of-Arrays Fleet Implementation
+ *
+ * The transition rules are those of hb_step() in pulse.c, applied to
+ * column i of every array in turn. Nothing here is new mathematics;
+ * only the memory layout changes. The per-monitor body lives in the
+ * step kernels of pulse_kernel.c.
+ *
+ * See: pulse.c, pulse_kernel.c, lessons/02-mathematical-closure/LESSON.md
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include <string.h>
+#include "pulse_fleet.h"
+#include "pulse_fleet_internal.h"
+#include "pulse_kernel.h"
+#include "pulse_internal.h"
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Reentrancy fault: every monitor DEAD, as hb_step() does for one */
+static void fault_reentry_all(hb_fleet_t *f)
+{
+    size_t i;
+
+    for (i = 0; i < f->n; i++) {
+        f->fault_reentry[i] = 1;
+        f->st[i] = (uint8_t)STATE_DEAD;
+    }
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t hb_fleet_bytes(size_t n)
+{
+    /* Largest n for which 2 x 8-byte columns + 4 x 1-byte columns fit */
+    if (n == 0 || n > ((size_t)-1 - 6u * 63u) / 20u) {
+        return 0;
+    }
+    return 2u * column_bytes(n, sizeof(uint64_t))
+         + 4u * column_bytes(n, sizeof(uint8_t));
+}
+
+int hb_fleet_init(hb_fleet_t *f, void *mem, size_t mem_size,
+                  size_t n, uint64_t now)
+{
+    size_t need = hb_fleet_bytes(n);
+    unsigned char *p = (unsigned char *)mem;
+    size_t i;
+
+    if (f == NULL || mem == NULL || need == 0 || mem_size < need) {
+        return -1;
+    }
+
+    /* 64-bit columns must be naturally aligned */
+    if (((uintptr_t)mem & (sizeof(uint64_t) - 1u)) != 0) {
+        return -1;
+    }
+
+    /* Carve columns: wide columns first so alignment is preserved */
+    f->last_hb = (uint64_t *)(void *)p;
+    p += column_bytes(n, sizeof(uint64_t));
+    f->t_init = (uint64_t *)(void *)p;
+    p += column_bytes(n, sizeof(uint64_t));
+    f->st = p;
+    p += column_bytes(n, sizeof(uint8_t));
+    f->have_hb = p;
+    p += column_bytes(n, sizeof(uint8_t));
+    f->fault_time = p;
+    p += column_bytes(n, sizeof(uint8_t));
+    f->fault_reentry = p;
+
+    f->n = n;
+    f->in_step = 0;
+    f->kernel = hb_kernel_best();
+
+    /* Every monitor as if by hb_init(m, now) */
+    for (i = 0; i < n; i++) {
+        f->st[i] = (uint8_t)STATE_UNKNOWN;
+        f->t_init[i] = now;
+        f->last_hb[i] = 0;
+        f->have_hb[i] = 0;
+        f->fault_time[i] = 0;
+        f->fault_reentry[i] = 0;
+    }
+
+    return 0;
+}
+
+void hb_fleet_step(hb_fleet_t *f, uint64_t now,
+                   const uint64_t *seen_bitmap, uint64_t T, uint64_t W)
+{
+    hb_kernel_fn kernel = hb_kernel_get(f->kernel);
+    size_t base;
+
+    /* W (init window) not used, exactly as in hb_step */
+    (void)W;
+
+    /* Reentrancy check — CONTRACT enforcement, fleet-wide */
+    if (f->in_step) {
+        fault_reentry_all(f);
+        return;
+    }
+    f->in_step = 1;
+
+    /* One linear pass, 64 monitors per bitmap word */
+    for (base = 0; base < f->n; base += 64u) {
+        uint64_t seen = seen_bitmap ? seen_bitmap[base >> 6] : 0;
+        size_t end = (f->n - base < 64u) ? f->n : base + 64u;
+
+        kernel(f, base, end, seen, now, T);
+    }
+
+    f->in_step = 0;
+}
+
+int hb_fleet_step_changes(hb_fleet_t *f, uint64_t now,
+                          const uint64_t *seen_bitmap, uint64_t T,
+                          hb_fleet_change_fn on_change, void *ctx)
+{
+    hb_kernel_fn kernel = hb_kernel_get(f->kernel);
+    uint8_t old[64];
+    size_t base;
+    size_t i;
+
+    if (f->in_step) {
+        fault_reentry_all(f);
+        return -1;
+    }
+    f->in_step = 1;
+
+    for (base = 0; base < f->n; base += 64u) {
+        uint64_t seen = seen_bitmap ? seen_bitmap[base >> 6] : 0;
+        size_t end = (f->n - base < 64u) ? f->n : base + 64u;
+        size_t len = end - base;
+
+        memcpy(old, &f->st[base], len);
+        kernel(f, base, end, seen, now, T);
+
+        /* Compare eight states at a time; most words are unchanged */
+        for (i = 0; i < len; i += 8u) {
+            uint64_t a = 0;
+            uint64_t b = 0;
+            size_t w = (len - i < 8u) ? len - i : 8u;
+            size_t j;
+
+            memcpy(&a, &old[i], w);
+            memcpy(&b, &f->st[base + i], w);
+            if (a == b) {
+                continue;
+            }
+            for (j = i; j < i + w; j++) {
+                if (old[j] != f->st[base + j]) {
+                    on_change(ctx, base + j, (state_t)old[j],
+                              (state_t)f->st[base + j]);
+                }
+            }
+        }
+    }
+
+    f->in_step = 0;
+    return 0;
+}
+
+size_t hb_fleet_mark_seen_bitmap(hb_fleet_t *f, uint64_t now,
+                                 const uint64_t *bits)
+{
+    size_t words = HB_FLEET_WORDS(f->n);
+    size_t marked = 0;
+    size_t w;
+
+    /* A mark during a step is a second writer — same fault as a step */
+    if (f->in_step) {
+        fault_reentry_all(f);
+        return 0;
+    }
+    if (bits == NULL) {
+        return 0;
+    }
+
+    for (w = 0; w < words; w++) {
+        uint64_t word = bits[w];
+
+        /* Bits past n in the last word name no monitor */
+        if (w == words - 1u && (f->n & 63u) != 0) {
+            word &= (1ULL << (f->n & 63u)) - 1u;
+        }
+        if (word == 0) {
+            continue;
+        }
+
+        marked += (size_t)__builtin_popcountll(word);
+        do {
+            size_t i = (w << 6) + (size_t)__builtin_ctzll(word);
+            f->last_hb[i] = now;
+            f->have_hb[i] = 1;
+            word &= word - 1u;  /* Clear lowest set bit */
+        } while (word != 0);
+    }
+
+    return marked;
+}
+
+int hb_fleet_set_kernel(hb_fleet_t *f, hb_kernel_t k)
+{
+    if (!hb_kernel_supported(k)) {
+        return -1;
+    }
+    f->kernel = k;
+    return 0;
+}
@@ -0,0 +1,36 @@
+/**
+ * pulse_fleet_internal.h - Fleet Step with Change Reporting
+ *
+ * Not part of the public API. The change feed (pulse_feed.c) and the
+ * group counters (pulse_group.c) both need every state change of a
+ * fleet step; both get them from the one loop in pulse_fleet.c.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_FLEET_INTERNAL_H
+#define PULSE_FLEET_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "pulse_fleet.h"
+
+/** Called once per monitor whose state changed during a fleet step */
+typedef void (*hb_fleet_change_fn)(void *ctx, size_t id,
+                                   state_t old_st, state_t new_st);
+
+/**
+ * hb_fleet_step(), calling on_change for every monitor whose state
+ * changed, in ascending id order.
+ *
+ * On reentry the fleet faults exactly as in hb_fleet_step() and no
+ * changes are reported; the caller must resynchronise.
+ *
+ * @return 0 on success, -1 on reentry
+ */
+int hb_fleet_step_changes(hb_fleet_t *f, uint64_t now,
+                          const uint64_t *seen_bitmap, uint64_t T,
+                          hb_fleet_change_fn on_change, void *ctx);
+
+#endif /* PULSE_FLEET_INTERNAL_H */
@@ -0,0 +1,179 @@
+/**
+ * pulse_group.c - Incremental Liveness Counts Implementation
+ *
+ * A transition decrements one counter and increments another in the
+ * monitor's group, then repeats for each ancestor. Because a parent
+ * always has a larger index than its child, the walk up the tree
+ * terminates and never revisits a group.
+ *
+ * The fleet wrapper finds transitions the same way hb_fleet_step_feed()
+ * does: snapshot 64 states, step, compare eight bytes at a time.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include <string.h>
+#include "pulse_group.h"
+#include "pulse_fleet_internal.h"
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Reset every counter: all monitors counted as UNKNOWN */
+static void count_all_unknown(hb_groups_t *g)
+{
+    size_t i;
+
+    memset(g->count, 0, g->n_groups * HB_GROUP_STATES * sizeof(uint32_t));
+    for (i = 0; i < g->n_monitors; i++) {
+        uint32_t k = g->group_of[i];
+        while (k != HB_GROUP_NONE) {
+            g->count[(size_t)k * HB_GROUP_STATES + STATE_UNKNOWN]++;
+            k = g->parent ? g->parent[k] : HB_GROUP_NONE;
+        }
+    }
+}
+
+/** Context of move_change() */
+struct move_ctx {
+    hb_groups_t *g;
+    size_t       flips;
+};
+
+/** hb_fleet_change_fn: one fleet change into the counters */
+static void move_change(void *ctx, size_t id, state_t old_st, state_t new_st)
+{
+    struct move_ctx *c = (struct move_ctx *)ctx;
+
+    c->flips += hb_groups_move(c->g, id, old_st, new_st);
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t hb_groups_bytes(size_t n_groups)
+{
+    size_t per_group = (HB_GROUP_STATES + 1u) * sizeof(uint32_t);
+
+    if (n_groups == 0 || n_groups >= HB_GROUP_NONE ||
+        n_groups > (size_t)-1 / per_group) {
+        return 0;
+    }
+    return n_groups * per_group;
+}
+
+int hb_groups_init(hb_groups_t *g, void *mem, size_t mem_size,
+                   size_t n_groups, const uint32_t *parent,
+                   const uint32_t *group_of, size_t n_monitors)
+{
+    size_t need = hb_groups_bytes(n_groups);
+    size_t i;
+
+    if (g == NULL || mem == NULL || group_of == NULL || need == 0 ||
+        mem_size < need || n_monitors > HB_GROUP_NONE) {
+        return -1;
+    }
+    if (((uintptr_t)mem & (sizeof(uint32_t) - 1u)) != 0) {
+        return -1;
+    }
+
+    /* INV-G1: parents point strictly upward, so the tree is acyclic */
+    for (i = 0; parent != NULL && i < n_groups; i++) {
+        if (parent[i] != HB_GROUP_NONE &&
+            (parent[i] <= i || parent[i] >= n_groups)) {
+            return -1;
+        }
+    }
+    /* INV-G3 */
+    for (i = 0; i < n_monitors; i++) {
+        if (group_of[i] != HB_GROUP_NONE && group_of[i] >= n_groups) {
+            return -1;
+        }
+    }
+
+    g->n_groups = n_groups;
+    g->n_monitors = n_monitors;
+    g->group_of = group_of;
+    g->parent = parent;
+    g->count = (uint32_t *)mem;
+    g->quorum = g->count + n_groups * HB_GROUP_STATES;
+
+    memset(g->quorum, 0, n_groups * sizeof(uint32_t));
+    count_all_unknown(g);
+    return 0;
+}
+
+int hb_groups_set_quorum(hb_groups_t *g, size_t k, uint32_t q)
+{
+    if (k >= g->n_groups) {
+        return -1;
+    }
+    g->quorum[k] = q;
+    return 0;
+}
+
+size_t hb_groups_move(hb_groups_t *g, size_t id, state_t old_st,
+                      state_t new_st)
+{
+    uint32_t k;
+    size_t flips = 0;
+
+    if (old_st == new_st || id >= g->n_monitors) {
+        return 0;
+    }
+
+    k = g->group_of[id];
+    while (k != HB_GROUP_NONE) {
+        uint32_t *c = &g->count[(size_t)k * HB_GROUP_STATES];
+        int had = c[STATE_ALIVE] >= g->quorum[k];
+
+        c[old_st]--;
+        c[new_st]++;
+        flips += (size_t)(had != (c[STATE_ALIVE] >= g->quorum[k]));
+
+        k = g->parent ? g->parent[k] : HB_GROUP_NONE;
+    }
+    return flips;
+}
+
+size_t hb_groups_step(hb_groups_t *g, hb_fsm_t *m, size_t id,
+                      uint64_t now, uint8_t hb_seen, uint64_t T, uint64_t W)
+{
+    state_t old_st = m->st;
+
+    hb_step(m, now, hb_seen, T, W);
+    return hb_groups_move(g, id, old_st, m->st);
+}
+
+size_t hb_groups_fleet_step(hb_groups_t *g, hb_fleet_t *f, uint64_t now,
+                            const uint64_t *seen_bitmap,
+                            uint64_t T, uint64_t W)
+{
+    struct move_ctx c;
+
+    /* W (init window) not used, exactly as in hb_step */
+    (void)W;
+
+    c.g = g;
+    c.flips = 0;
+
+    /* Reentrant: the fleet faults wholesale, so recount wholesale */
+    if (hb_fleet_step_changes(f, now, seen_bitmap, T, move_change, &c) != 0) {
+        hb_groups_rebuild_fleet(g, f);
+        return 0;
+    }
+    return c.flips;
+}
+
+void hb_groups_rebuild_fleet(hb_groups_t *g, const hb_fleet_t *f)
+{
+    size_t i;
+
+    count_all_unknown(g);
+    for (i = 0; i < g->n_monitors && i < f->n; i++) {
+        (void)hb_groups_move(g, i, STATE_UNKNOWN, (state_t)f->st[i]);
+    }
+}
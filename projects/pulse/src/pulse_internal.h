@@ -0,0 +1,63 @@
+/**
+ * pulse_internal.h - Helpers Shared by the Pulse Translation Units
+ *
+ * Not part of the public API. Every monitor representation (hb_fsm_t,
+ * the fleet and its kernels, the packed fleet, the wheel, the mailbox)
+ * must apply exactly the same clock-fault rule as hb_step(); keeping the
+ * rule here, once, is what lets their contracts say "as pulse.c".
+ * Private to pulse: other modules keep their own copies.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#ifndef PULSE_INTERNAL_H
+#define PULSE_INTERNAL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/*---------------------------------------------------------------------------
+ * Clock Arithmetic
+ *---------------------------------------------------------------------------*/
+
+/** Modular age computation: (now - then) mod 2^64 */
+static inline uint64_t age_u64(uint64_t now, uint64_t then)
+{
+    return (uint64_t)(now - then);
+}
+
+/** Half-range rule: valid if age < 2^63 */
+static inline uint8_t age_valid(uint64_t age)
+{
+    return (age < (1ULL << 63));
+}
+
+/*---------------------------------------------------------------------------
+ * Column Layout
+ *---------------------------------------------------------------------------*/
+
+/** Round a column size up to a whole number of 64-byte cache lines */
+static inline size_t column_bytes(size_t n, size_t elem)
+{
+    return ((n * elem) + 63u) & ~(size_t)63u;
+}
+
+/*---------------------------------------------------------------------------
+ * Lane Masks — eight 0/1 state bytes <-> 8-bit masks
+ *---------------------------------------------------------------------------*/
+
+/** Eight 0/1 bytes, byte j = bit j of m */
+static inline uint64_t lanes_to_bytes(unsigned m)
+{
+    uint64_t x = ((uint64_t)m * 0x0101010101010101ULL) & 0x8040201008040201ULL;
+    return ((x + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+}
+
+/** 8-bit lane mask of eight 0/1 bytes, bit j = byte j */
+static inline unsigned bytes_to_lanes(uint64_t b)
+{
+    return (unsigned)((b * 0x0102040810204080ULL) >> 56);
+}
+
+#endif /* PULSE_INTERNAL_H */
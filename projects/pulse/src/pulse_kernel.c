@@ -0,0 +1,291 @@
+/**
+ * pulse_kernel.c - Step Kernels for a Pulse Fleet
+ *
+ * The scalar kernel is the loop body of hb_step() applied to one
+ * column index. The vector kernels compute the same thing for 4 or 8
+ * monitors at once, branch-free:
+ *
+ *   seen     lanes whose heartbeat bit is set
+ *   last_hb  <- seen ? now : last_hb
+ *   have     <- have_hb | seen
+ *   ref      <- have ? last_hb : t_init
+ *   age      <- now - ref                      (mod 2^64, as age_u64)
+ *   invalid  <- age >= 2^63                    (as !age_valid)
+ *   dead     <- invalid | (have & age > T)
+ *   alive    <- have & !dead
+ *
+ * Without evidence, hb_step only checks t_init for a clock fault and
+ * otherwise stays UNKNOWN: that is the have = 0 case above.
+ *
+ * See: pulse.c, pulse_kernel.h
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include <string.h>
+#include "pulse_kernel.h"
+#include "pulse_internal.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define HB_KERNEL_X86 1
+#include <immintrin.h>
+#else
+#define HB_KERNEL_X86 0
+#endif
+
+/*---------------------------------------------------------------------------
+ * Scalar Kernel
+ *---------------------------------------------------------------------------*/
+
+static void kernel_scalar(hb_fleet_t *f, size_t base, size_t end,
+                          uint64_t seen, uint64_t now, uint64_t T)
+{
+    size_t i;
+
+    for (i = base; i < end; i++, seen >>= 1) {
+        /* Record heartbeat if seen */
+        if (seen & 1u) {
+            f->last_hb[i] = now;
+            f->have_hb[i] = 1;
+        }
+
+        /* No evidence yet — stay UNKNOWN unless the clock is corrupt */
+        if (!f->have_hb[i]) {
+            if (!age_valid(age_u64(now, f->t_init[i]))) {
+                f->fault_time[i] = 1;
+                f->st[i] = (uint8_t)STATE_DEAD;
+            } else {
+                f->st[i] = (uint8_t)STATE_UNKNOWN;
+            }
+            continue;
+        }
+
+        /* Have evidence — check age */
+        uint64_t a_hb = age_u64(now, f->last_hb[i]);
+        if (!age_valid(a_hb)) {
+            f->fault_time[i] = 1;
+            f->st[i] = (uint8_t)STATE_DEAD;
+            continue;
+        }
+
+        /* Transition based on timeout — direct from transition table */
+        f->st[i] = (uint8_t)((a_hb > T) ? STATE_DEAD : STATE_ALIVE);
+    }
+}
+
+#if HB_KERNEL_X86
+
+/*---------------------------------------------------------------------------
+ * AVX2 Kernel — 8 monitors per iteration, two 4-lane vectors
+ *---------------------------------------------------------------------------*/
+
+/** Lane mask of four 64-bit lanes from the low 4 bits of m */
+__attribute__((target("avx2")))
+static inline __m256i avx2_lanes(unsigned m, __m256i lane_bit)
+{
+    __m256i v = _mm256_and_si256(_mm256_set1_epi64x((long long)m), lane_bit);
+    return _mm256_cmpeq_epi64(v, lane_bit);
+}
+
+/**
+ * Ages of four monitors: returns the invalid mask, sets *over to the
+ * age > T mask. seen4/have4 are 4-bit lane masks.
+ */
+__attribute__((target("avx2")))
+static inline unsigned avx2_age4(uint64_t *last_hb, const uint64_t *t_init,
+                                 unsigned seen4, unsigned have4,
+                                 __m256i now_v, __m256i t_x, __m256i lane_bit,
+                                 unsigned *over)
+{
+    const __m256i sign = _mm256_set1_epi64x((long long)(1ULL << 63));
+
+    /* Record heartbeats: last_hb <- seen ? now : last_hb */
+    __m256i last = _mm256_loadu_si256((const __m256i *)last_hb);
+    last = _mm256_blendv_epi8(last, now_v, avx2_lanes(seen4, lane_bit));
+    _mm256_storeu_si256((__m256i *)last_hb, last);
+
+    /* Age from last_hb with evidence, from t_init without */
+    __m256i tinit = _mm256_loadu_si256((const __m256i *)t_init);
+    __m256i age = _mm256_sub_epi64(
+        now_v, _mm256_blendv_epi8(tinit, last, avx2_lanes(have4, lane_bit)));
+
+    /* Unsigned age > T via sign-biased signed compare */
+    *over = (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(
+        _mm256_cmpgt_epi64(_mm256_xor_si256(age, sign), t_x)));
+
+    /* Sign bit set: age >= 2^63 */
+    return (unsigned)_mm256_movemask_pd(_mm256_castsi256_pd(age));
+}
+
+__attribute__((target("avx2")))
+static void kernel_avx2(hb_fleet_t *f, size_t base, size_t end,
+                        uint64_t seen, uint64_t now, uint64_t T)
+{
+    const __m256i now_v = _mm256_set1_epi64x((long long)now);
+    const __m256i t_x = _mm256_set1_epi64x((long long)(T ^ (1ULL << 63)));
+    const __m256i lane_bit = _mm256_set_epi64x(8, 4, 2, 1);
+    uint64_t *last_hb = f->last_hb;
+    const uint64_t *t_init = f->t_init;
+    size_t i;
+
+    for (i = base; i + 8u <= end; i += 8u, seen >>= 8) {
+        unsigned s8 = (unsigned)(seen & 0xFFu);
+        unsigned have, invalid, over, over_hi, dead, alive;
+        uint64_t b;
+
+        memcpy(&b, &f->have_hb[i], sizeof(b));
+        have = bytes_to_lanes(b) | s8;
+
+        invalid = avx2_age4(&last_hb[i], &t_init[i], s8 & 0xFu, have & 0xFu,
+                            now_v, t_x, lane_bit, &over);
+        invalid |= avx2_age4(&last_hb[i + 4u], &t_init[i + 4u], s8 >> 4,
+                             have >> 4, now_v, t_x, lane_bit, &over_hi) << 4;
+        over |= over_hi << 4;
+
+        dead = invalid | (have & over);
+        alive = have & ~dead;
+
+        b = lanes_to_bytes(have);
+        memcpy(&f->have_hb[i], &b, sizeof(b));
+
+        if (invalid) {
+            memcpy(&b, &f->fault_time[i], sizeof(b));
+            b |= lanes_to_bytes(invalid);
+            memcpy(&f->fault_time[i], &b, sizeof(b));
+        }
+
+        b = lanes_to_bytes(dead) * (uint64_t)STATE_DEAD
+          + lanes_to_bytes(alive) * (uint64_t)STATE_ALIVE;
+        memcpy(&f->st[i], &b, sizeof(b));
+    }
+
+    /* Leave no dirty upper state for the SSE/scalar code that follows */
+    _mm256_zeroupper();
+
+    /* Tail of a partial block */
+    kernel_scalar(f, i, end, seen, now, T);
+}
+
+/*---------------------------------------------------------------------------
+ * AVX-512 Kernel — 8 monitors per iteration
+ *---------------------------------------------------------------------------*/
+
+__attribute__((target("avx512f")))
+static void kernel_avx512(hb_fleet_t *f, size_t base, size_t end,
+                          uint64_t seen, uint64_t now, uint64_t T)
+{
+    const __m512i sign = _mm512_set1_epi64((long long)(1ULL << 63));
+    const __m512i now_v = _mm512_set1_epi64((long long)now);
+    const __m512i t_v = _mm512_set1_epi64((long long)T);
+    const __m512i one = _mm512_set1_epi64(1);
+    size_t i;
+
+    for (i = base; i + 8u <= end; i += 8u, seen >>= 8) {
+        __mmask8 s8 = (__mmask8)(seen & 0xFFu);
+
+        /* Record heartbeats: last_hb <- seen ? now : last_hb */
+        __m512i last = _mm512_loadu_si512(&f->last_hb[i]);
+        last = _mm512_mask_mov_epi64(last, s8, now_v);
+        _mm512_storeu_si512(&f->last_hb[i], last);
+
+        __m512i have_v = _mm512_cvtepu8_epi64(
+            _mm_loadl_epi64((const __m128i *)&f->have_hb[i]));
+        __mmask8 have = (__mmask8)(_mm512_test_epi64_mask(have_v, have_v) | s8);
+
+        /* Age from last_hb with evidence, from t_init without */
+        __m512i tinit = _mm512_loadu_si512(&f->t_init[i]);
+        __m512i age = _mm512_sub_epi64(now_v,
+                                       _mm512_mask_blend_epi64(have, tinit, last));
+
+        __mmask8 invalid = _mm512_cmpge_epu64_mask(age, sign);
+        __mmask8 over = _mm512_cmpgt_epu64_mask(age, t_v);
+        __mmask8 dead = (__mmask8)(invalid | (have & over));
+        __mmask8 alive = (__mmask8)(have & ~dead);
+
+        _mm_storel_epi64((__m128i *)&f->have_hb[i],
+                         _mm512_cvtepi64_epi8(_mm512_maskz_mov_epi64(have, one)));
+
+        __m512i fault_v = _mm512_cvtepu8_epi64(
+            _mm_loadl_epi64((const __m128i *)&f->fault_time[i]));
+        fault_v = _mm512_mask_mov_epi64(fault_v, invalid, one);
+        _mm_storel_epi64((__m128i *)&f->fault_time[i],
+                         _mm512_cvtepi64_epi8(fault_v));
+
+        __m512i st_v = _mm512_maskz_mov_epi64(
+            dead, _mm512_set1_epi64((long long)STATE_DEAD));
+        st_v = _mm512_mask_mov_epi64(
+            st_v, alive, _mm512_set1_epi64((long long)STATE_ALIVE));
+        _mm_storel_epi64((__m128i *)&f->st[i], _mm512_cvtepi64_epi8(st_v));
+    }
+
+    /* Leave no dirty upper state for the SSE/scalar code that follows */
+    _mm256_zeroupper();
+
+    /* Tail of a partial block */
+    kernel_scalar(f, i, end, seen, now, T);
+}
+
+#endif /* HB_KERNEL_X86 */
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+uint8_t hb_kernel_supported(hb_kernel_t k)
+{
+    switch (k) {
+    case HB_KERNEL_SCALAR:
+        return 1;
+#if HB_KERNEL_X86
+    case HB_KERNEL_AVX2:
+        return __builtin_cpu_supports("avx2") ? 1 : 0;
+    case HB_KERNEL_AVX512:
+        return __builtin_cpu_supports("avx512f") ? 1 : 0;
+#endif
+    default:
+        return 0;
+    }
+}
+
+hb_kernel_t hb_kernel_best(void)
+{
+    if (hb_kernel_supported(HB_KERNEL_AVX512)) {
+        return HB_KERNEL_AVX512;
+    }
+    if (hb_kernel_supported(HB_KERNEL_AVX2)) {
+        return HB_KERNEL_AVX2;
+    }
+    return HB_KERNEL_SCALAR;
+}
+
+hb_kernel_fn hb_kernel_get(hb_kernel_t k)
+{
+    if (!hb_kernel_supported(k)) {
+        return kernel_scalar;
+    }
+    switch (k) {
+#if HB_KERNEL_X86
+    case HB_KERNEL_AVX2:
+        return kernel_avx2;
+    case HB_KERNEL_AVX512:
+        return kernel_avx512;
+#endif
+    default:
+        return kernel_scalar;
+    }
+}
+
+const char *hb_kernel_name(hb_kernel_t k)
+{
+    switch (k) {
+    case HB_KERNEL_SCALAR:
+        return "scalar";
+    case HB_KERNEL_AVX2:
+        return "avx2";
+    case HB_KERNEL_AVX512:
+        return "avx512";
+    default:
+        return "invalid";
+    }
+}
@@ -0,0 +1,46 @@
+/**
+ * pulse_mailbox.c - Multi-Producer Heartbeat Recording Implementation
+ *
+ * The evaluator turns "some heartbeat was posted" into a last_hb value
+ * and then defers to hb_step() with hb_seen = 0, so every transition
+ * still comes from the one transcription of the transition table.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "pulse_mailbox.h"
+#include "pulse_internal.h"
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+void hb_mailbox_init(hb_mailbox_t *mb)
+{
+    atomic_init(&mb->latest, 0);
+    atomic_init(&mb->pending, 0);
+}
+
+void hb_step_mailbox(hb_fsm_t *m, hb_mailbox_t *mb, uint64_t now,
+                     uint64_t T, uint64_t W)
+{
+    /* A reentrant call leaves the mailbox alone; hb_step faults it */
+    if (!m->in_step &&
+        atomic_exchange_explicit(&mb->pending, 0, memory_order_acquire)) {
+        uint64_t ts = atomic_load_explicit(&mb->latest, memory_order_relaxed);
+
+        /* Producer read the clock after us: record no later than now */
+        if (!age_valid(age_u64(now, ts))) {
+            ts = now;
+        }
+
+        /* A racing producer left an older stamp: keep the newer one */
+        if (!m->have_hb || age_valid(age_u64(ts, m->last_hb))) {
+            m->last_hb = ts;
+            m->have_hb = 1;
+        }
+    }
+
+    hb_step(m, now, 0, T, W);
+}
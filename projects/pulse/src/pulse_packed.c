@@ -0,0 +1,191 @@
+/**
+ * pulse_packed.c - Compact 16-Byte Liveness Monitor Implementation
+ *
+ * The transition rules are those of hb_step() in pulse.c. Ages are
+ * taken between epoch-relative offsets: (now - epoch) - off equals
+ * now - (epoch + off) modulo 2^64, so the half-range rule is applied
+ * to exactly the value pulse.c would see.
+ *
+ * See: pulse.c, pulse_fleet.c
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "pulse_packed.h"
+#include "pulse_internal.h"
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Set the state field of a bits byte */
+static inline uint8_t with_state(uint8_t bits, state_t st)
+{
+    return (uint8_t)((bits & ~HB_PACKED_ST_MASK) | (uint8_t)st);
+}
+
+/**
+ * Shift one offset by an epoch move, pinning it to the window edge it
+ * falls off. Offsets already pinned keep their edge.
+ *
+ * @param off     Offset to shift (updated)
+ * @param bits    Flags byte (updated)
+ * @param far     The FAR flag belonging to this offset
+ * @param forward 1 if the epoch moves later, 0 if earlier
+ * @param d       Distance the epoch moves
+ */
+static void shift_offset(uint32_t *off, uint8_t *bits, uint8_t far,
+                         uint8_t forward, uint64_t d)
+{
+    if (*bits & far) {
+        return;
+    }
+    if (forward) {
+        if ((uint64_t)*off < d) {
+            *off = 0;
+            *bits |= far;
+        } else {
+            *off = (uint32_t)((uint64_t)*off - d);
+        }
+    } else {
+        if (d > (uint64_t)(UINT32_MAX - *off)) {
+            *off = UINT32_MAX;
+            *bits |= far;
+        } else {
+            *off = (uint32_t)((uint64_t)*off + d);
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+int hb_packed_init(hb_packed_fleet_t *f, hb_packed_t *m, size_t n,
+                   uint64_t now)
+{
+    size_t i;
+
+    if (f == NULL || m == NULL || n == 0) {
+        return -1;
+    }
+
+    /* Four monitors per cache line only if the array is 16-byte aligned */
+    if (((uintptr_t)m & (sizeof(hb_packed_t) - 1u)) != 0) {
+        return -1;
+    }
+
+    f->n = n;
+    f->m = m;
+    f->epoch = now - HB_PACKED_WINDOW_MID;
+    f->in_step = 0;
+
+    /* Every monitor as if by hb_init(m, now) */
+    for (i = 0; i < n; i++) {
+        m[i].last_hb = 0;
+        m[i].t_init = (uint32_t)HB_PACKED_WINDOW_MID;
+        m[i].bits = (uint8_t)STATE_UNKNOWN;
+    }
+
+    return 0;
+}
+
+void hb_packed_rebase(hb_packed_fleet_t *f, uint64_t now)
+{
+    uint64_t epoch = now - HB_PACKED_WINDOW_MID;
+    uint64_t d = age_u64(epoch, f->epoch);
+    uint8_t forward = age_valid(d);
+    size_t i;
+
+    if (!forward) {
+        d = age_u64(f->epoch, epoch);
+    }
+
+    for (i = 0; i < f->n; i++) {
+        hb_packed_t *m = &f->m[i];
+        shift_offset(&m->last_hb, &m->bits, HB_PACKED_LAST_FAR, forward, d);
+        shift_offset(&m->t_init, &m->bits, HB_PACKED_INIT_FAR, forward, d);
+    }
+
+    f->epoch = epoch;
+}
+
+void hb_packed_step(hb_packed_fleet_t *f, uint64_t now,
+                    const uint64_t *seen_bitmap, uint64_t T, uint64_t W)
+{
+    uint64_t rel;
+    size_t base;
+    size_t i;
+
+    /* W (init window) not used, exactly as in hb_step */
+    (void)W;
+
+    /* Reentrancy check — CONTRACT enforcement, fleet-wide */
+    if (f->in_step) {
+        for (i = 0; i < f->n; i++) {
+            f->m[i].bits = with_state(
+                (uint8_t)(f->m[i].bits | HB_PACKED_FAULT_REENTRY), STATE_DEAD);
+        }
+        return;
+    }
+    f->in_step = 1;
+
+    /* Keep now in the middle half of the window */
+    rel = age_u64(now, f->epoch);
+    if (rel < HB_PACKED_WINDOW_LO || rel >= HB_PACKED_WINDOW_HI) {
+        hb_packed_rebase(f, now);
+        rel = HB_PACKED_WINDOW_MID;
+    }
+
+    for (base = 0; base < f->n; base += 64u) {
+        uint64_t seen = seen_bitmap ? seen_bitmap[base >> 6] : 0;
+        size_t end = (f->n - base < 64u) ? f->n : base + 64u;
+
+        for (i = base; i < end; i++, seen >>= 1) {
+            hb_packed_t *m = &f->m[i];
+            uint8_t bits = m->bits;
+
+            /* Record heartbeat if seen: now is always inside the window */
+            if (seen & 1u) {
+                m->last_hb = (uint32_t)rel;
+                bits = (uint8_t)((bits | HB_PACKED_HAVE_HB)
+                                 & ~HB_PACKED_LAST_FAR);
+            }
+
+            if (!(bits & HB_PACKED_HAVE_HB)) {
+                /* No evidence yet — stay UNKNOWN unless the clock is corrupt */
+                uint8_t valid = (bits & HB_PACKED_INIT_FAR)
+                              ? (m->t_init == 0)
+                              : age_valid(age_u64(rel, m->t_init));
+                if (!valid) {
+                    bits = with_state((uint8_t)(bits | HB_PACKED_FAULT_TIME),
+                                      STATE_DEAD);
+                } else {
+                    bits = with_state(bits, STATE_UNKNOWN);
+                }
+            } else if (bits & HB_PACKED_LAST_FAR) {
+                /* Far behind: silent > 2^31 units. Far ahead: clock fault */
+                if (m->last_hb != 0) {
+                    bits |= HB_PACKED_FAULT_TIME;
+                }
+                bits = with_state(bits, STATE_DEAD);
+            } else {
+                /* Have evidence — check age */
+                uint64_t a_hb = age_u64(rel, m->last_hb);
+                if (!age_valid(a_hb)) {
+                    bits = with_state((uint8_t)(bits | HB_PACKED_FAULT_TIME),
+                                      STATE_DEAD);
+                } else {
+                    /* Transition based on timeout — from transition table */
+                    bits = with_state(bits,
+                                      (a_hb > T) ? STATE_DEAD : STATE_ALIVE);
+                }
+            }
+
+            m->bits = bits;
+        }
+    }
+
+    f->in_step = 0;
+}
@@ -0,0 +1,146 @@
+/**
+ * pulse_send.c - Heartbeat load generator for pulsed
+ *
+ * Sends heartbeats for monitors 0..MONITORS-1, round robin, to a
+ * pulsed socket. Ids are packed IDS_PER_DGRAM to a datagram and
+ * datagrams are sent BATCH at a time with sendmmsg(). RATE is the
+ * target in heartbeats/sec; 0 sends as fast as the socket allows.
+ *
+ * Usage: pulse_send SOCKET MONITORS RATE SECONDS
+ *   MONITORS  1 .. 2^32-1
+ *   RATE      0 .. 10^9 heartbeats/sec (0 = unpaced)
+ *   SECONDS   0 .. 10^9
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#define _GNU_SOURCE /* For sendmmsg */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define IDS_PER_DGRAM 32
+#define BATCH 32
+#define NS_PER_S 1000000000ULL
+
+/** Get current time in nanoseconds (monotonic) */
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * NS_PER_S + (uint64_t)ts.tv_nsec;
+}
+
+/**
+ * Parse a decimal argument in [0, max].
+ *
+ * strtoull() alone accepts "", "abc" (as 0), "-1" (as 2^64-1) and
+ * trailing junk; all of those are rejected here.
+ *
+ * @return 0 on success, -1 if s is not a number in range
+ */
+static int parse_u64(const char *s, uint64_t max, uint64_t *out) {
+  char *end;
+  unsigned long long v;
+
+  if (*s < '0' || *s > '9') {
+    return -1;
+  }
+  errno = 0;
+  v = strtoull(s, &end, 10);
+  if (errno != 0 || *end != '\0' || v > max) {
+    return -1;
+  }
+  *out = (uint64_t)v;
+  return 0;
+}
+
+/** Nanoseconds after start at which heartbeat number sent is due */
+static uint64_t due_ns(uint64_t sent, uint64_t rate) {
+  /* Whole seconds first: sent * 10^9 would overflow after ~1.8e10 */
+  return (sent / rate) * NS_PER_S + (sent % rate) * NS_PER_S / rate;
+}
+
+int main(int argc, char **argv) {
+  static uint32_t ids[BATCH][IDS_PER_DGRAM];
+  struct mmsghdr msgs[BATCH];
+  struct iovec iov[BATCH];
+  struct sockaddr_un addr;
+  uint64_t monitors, rate, seconds, start, end, sent = 0;
+  uint32_t next = 0;
+  int sock;
+
+  if (argc != 5 || strlen(argv[1]) >= sizeof(addr.sun_path) ||
+      parse_u64(argv[2], UINT32_MAX, &monitors) != 0 || monitors == 0 ||
+      parse_u64(argv[3], NS_PER_S, &rate) != 0 ||
+      parse_u64(argv[4], NS_PER_S, &seconds) != 0) {
+    fprintf(stderr,
+            "usage: %s SOCKET MONITORS RATE SECONDS\n"
+            "  MONITORS  1 .. 4294967295\n"
+            "  RATE      0 .. 1000000000 heartbeats/sec (0 = unpaced)\n"
+            "  SECONDS   0 .. 1000000000\n",
+            argv[0]);
+    return 2;
+  }
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, argv[1]);
+  sock = socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0);
+  if (sock < 0 ||
+      connect(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    perror("pulse_send: connect");
+    return 1;
+  }
+
+  memset(msgs, 0, sizeof(msgs));
+  for (int i = 0; i < BATCH; i++) {
+    iov[i].iov_base = ids[i];
+    iov[i].iov_len = sizeof(ids[i]);
+    msgs[i].msg_hdr.msg_iov = &iov[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  start = now_ns();
+  end = start + seconds * NS_PER_S;
+  for (uint64_t t = start; t < end; t = now_ns()) {
+    int done;
+
+    /* Pace: stay at or below rate heartbeats/sec */
+    if (rate != 0 && due_ns(sent, rate) > t - start) {
+      struct timespec pause = {0, 100000}; /* 100 us */
+      nanosleep(&pause, NULL);
+      continue;
+    }
+
+    for (int i = 0; i < BATCH; i++) {
+      for (int k = 0; k < IDS_PER_DGRAM; k++) {
+        ids[i][k] = next;
+        next = (next + 1u == monitors) ? 0 : next + 1u;
+      }
+    }
+
+    done = sendmmsg(sock, msgs, BATCH, 0);
+    if (done < 0) {
+      if (errno == EAGAIN || errno == ENOBUFS || errno == EINTR) {
+        continue;
+      }
+      perror("pulse_send: sendmmsg");
+      return 1;
+    }
+    sent += (uint64_t)done * IDS_PER_DGRAM;
+  }
+
+  printf("pulse_send: %lu heartbeats in %lu s (%lu/s)\n",
+         (unsigned long)sent, (unsigned long)seconds,
+         (unsigned long)(seconds ? sent / seconds : 0));
+  close(sock);
+  return 0;
+}
@@ -0,0 +1,368 @@
+/**
+ * pulse_wheel.c - Hierarchical Timing Wheel Implementation
+ *
+ * Deadlines are filed by distance from wheel time:
+ *
+ *   delta = expiry - now     level = smallest L with delta < 64^(L+1)
+ *   slot  = (expiry >> 6L) mod 64
+ *
+ * When wheel time enters a new 64^L block, the slot of level L for
+ * that block is emptied and its monitors re-filed; they land on a
+ * lower level because their delta has shrunk. Per-level occupancy
+ * bitmaps let wheel time jump straight to the next non-empty slot.
+ *
+ * Every visit re-checks the fleet's own columns, so the wheel only
+ * ever decides when a monitor is examined.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#include "pulse_wheel.h"
+#include "pulse_internal.h"
+
+/*---------------------------------------------------------------------------
+ * Helper Functions
+ *---------------------------------------------------------------------------*/
+
+/** Index of the lowest set bit (x must be non-zero) */
+static inline unsigned lowest_bit(uint64_t x)
+{
+#if defined(__GNUC__)
+    return (unsigned)__builtin_ctzll(x);
+#else
+    unsigned b = 0;
+    while (!(x & 1u)) {
+        x >>= 1;
+        b++;
+    }
+    return b;
+#endif
+}
+
+/** Remove monitor i from whatever slot list holds it */
+static void unlink_monitor(hb_wheel_t *w, uint32_t i)
+{
+    uint16_t s = w->slot[i];
+    unsigned level;
+    unsigned idx;
+
+    if (s == HB_WHEEL_IDLE) {
+        return;
+    }
+    level = (unsigned)s / HB_WHEEL_SLOTS;
+    idx = (unsigned)s % HB_WHEEL_SLOTS;
+
+    if (w->prev[i] != HB_WHEEL_NONE) {
+        w->next[w->prev[i]] = w->next[i];
+    } else {
+        w->head[level][idx] = w->next[i];
+    }
+    if (w->next[i] != HB_WHEEL_NONE) {
+        w->prev[w->next[i]] = w->prev[i];
+    }
+
+    if (w->head[level][idx] == HB_WHEEL_NONE) {
+        w->occupied[level] &= ~(1ULL << idx);
+    }
+    w->slot[i] = HB_WHEEL_IDLE;
+}
+
+/** File monitor i under its expiry relative to current wheel time */
+static void file_monitor(hb_wheel_t *w, uint32_t i)
+{
+    uint64_t expiry = w->expiry[i];
+    uint64_t delta = age_u64(expiry, w->now);
+    unsigned level = 0;
+    unsigned idx;
+
+    /* Deadline already due: current level-0 slot, visited next */
+    if (!age_valid(delta)) {
+        delta = 0;
+        expiry = w->now;
+    }
+
+    while (level < HB_WHEEL_LEVELS - 1u &&
+           delta >= (1ULL << (HB_WHEEL_BITS * (level + 1u)))) {
+        level++;
+    }
+
+    /* Beyond the top level: park at its furthest slot, re-filed later */
+    if (delta >= (1ULL << (HB_WHEEL_BITS * HB_WHEEL_LEVELS))) {
+        expiry = w->now + ((1ULL << (HB_WHEEL_BITS * HB_WHEEL_LEVELS)) - 1u);
+    }
+
+    idx = (unsigned)((expiry >> (HB_WHEEL_BITS * level)) &
+                     (HB_WHEEL_SLOTS - 1u));
+
+    w->prev[i] = HB_WHEEL_NONE;
+    w->next[i] = w->head[level][idx];
+    if (w->next[i] != HB_WHEEL_NONE) {
+        w->prev[w->next[i]] = i;
+    }
+    w->head[level][idx] = i;
+    w->occupied[level] |= (1ULL << idx);
+    w->slot[i] = (uint16_t)(level * HB_WHEEL_SLOTS + idx);
+}
+
+/** Schedule monitor i for deadline last_hb + T + 1 */
+static void schedule_monitor(hb_wheel_t *w, uint32_t i)
+{
+    w->expiry[i] = w->fleet->last_hb[i] + w->T + 1u;
+    file_monitor(w, i);
+}
+
+/** Re-file every monitor of one slot (cascade on block entry) */
+static void cascade_slot(hb_wheel_t *w, unsigned level, unsigned idx)
+{
+    uint32_t i = w->head[level][idx];
+
+    /* Detach the whole list first: re-filing may target this slot */
+    w->head[level][idx] = HB_WHEEL_NONE;
+    w->occupied[level] &= ~(1ULL << idx);
+
+    while (i != HB_WHEEL_NONE) {
+        uint32_t nxt = w->next[i];
+        file_monitor(w, i);
+        i = nxt;
+    }
+}
+
+/** Cascade every level whose block boundary wheel time just crossed */
+static void cascade(hb_wheel_t *w)
+{
+    unsigned level;
+
+    for (level = 1; level < HB_WHEEL_LEVELS; level++) {
+        uint64_t lower = w->now >> (HB_WHEEL_BITS * level);
+        unsigned idx = (unsigned)(lower & (HB_WHEEL_SLOTS - 1u));
+
+        cascade_slot(w, level, idx);
+
+        /* Higher levels only turn over when this one wraps */
+        if (idx != 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * Earliest future time at which the wheel has work: a non-empty
+ * level-0 slot to visit or a non-empty higher slot to cascade.
+ *
+ * Level L is consulted only when every level below it is empty, so no
+ * finer-grained event can be skipped. Slots at or behind the current
+ * index belong to the next turn of their level; for those the next
+ * boundary of the level above is returned, which is never late.
+ *
+ * Returns 0 if the wheel is empty.
+ */
+static uint8_t next_event(const hb_wheel_t *w, uint64_t *target)
+{
+    unsigned level;
+
+    for (level = 0; level < HB_WHEEL_LEVELS; level++) {
+        unsigned shift = HB_WHEEL_BITS * level;
+        uint64_t blk = w->now >> shift;
+        unsigned idx = (unsigned)(blk & (HB_WHEEL_SLOTS - 1u));
+        uint64_t ahead = (idx == HB_WHEEL_SLOTS - 1u)
+                       ? 0 : (w->occupied[level] >> (idx + 1u));
+
+        if (ahead) {
+            *target = (blk + lowest_bit(ahead) + 1u) << shift;
+            return 1;
+        }
+        if (w->occupied[level]) {
+            *target = ((blk | (HB_WHEEL_SLOTS - 1u)) + 1u) << shift;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * Visit every monitor in the current level-0 slot.
+ *
+ * Returns 0 if expired filled up before the slot was empty.
+ */
+static uint8_t fire_slot(hb_wheel_t *w, uint32_t *expired, size_t cap,
+                         size_t *count)
+{
+    hb_fleet_t *f = w->fleet;
+    unsigned idx = (unsigned)(w->now & (HB_WHEEL_SLOTS - 1u));
+    uint32_t i;
+
+    while ((i = w->head[0][idx]) != HB_WHEEL_NONE) {
+        if (expired != NULL && *count >= cap) {
+            return 0;
+        }
+        unlink_monitor(w, i);
+
+        /* Re-check against the fleet: only ALIVE monitors can expire */
+        if (!f->have_hb[i] || f->st[i] != (uint8_t)STATE_ALIVE) {
+            continue;
+        }
+
+        uint64_t a_hb = age_u64(w->now, f->last_hb[i]);
+        if (!age_valid(a_hb)) {
+            f->fault_time[i] = 1;
+            f->st[i] = (uint8_t)STATE_DEAD;
+        } else if (a_hb > w->T) {
+            f->st[i] = (uint8_t)STATE_DEAD;
+        } else {
+            /* Heartbeat arrived by another path: not due yet */
+            schedule_monitor(w, i);
+            continue;
+        }
+
+        if (expired != NULL) {
+            expired[*count] = i;
+        }
+        (*count)++;
+    }
+    return 1;
+}
+
+/*---------------------------------------------------------------------------
+ * Public API
+ *---------------------------------------------------------------------------*/
+
+size_t hb_wheel_bytes(size_t n)
+{
+    /* Indices are 32-bit with one value reserved for NONE */
+    if (n == 0 || n >= (size_t)HB_WHEEL_NONE ||
+        n > ((size_t)-1 - 4u * 63u) / 32u) {
+        return 0;
+    }
+    return 2u * column_bytes(n, sizeof(uint32_t))
+         + column_bytes(n, sizeof(uint64_t))
+         + column_bytes(n, sizeof(uint16_t));
+}
+
+int hb_wheel_init(hb_wheel_t *w, hb_fleet_t *f, void *mem, size_t mem_size,
+                  uint64_t now, uint64_t T)
+{
+    unsigned char *p = (unsigned char *)mem;
+    size_t need;
+    size_t i;
+    unsigned level;
+    unsigned idx;
+
+    if (w == NULL || f == NULL || mem == NULL || T > HB_WHEEL_T_MAX) {
+        return -1;
+    }
+    need = hb_wheel_bytes(f->n);
+    if (need == 0 || mem_size < need ||
+        ((uintptr_t)mem & (sizeof(uint64_t) - 1u)) != 0) {
+        return -1;
+    }
+
+    /* Carve columns: wide columns first so alignment is preserved */
+    w->expiry = (uint64_t *)(void *)p;
+    p += column_bytes(f->n, sizeof(uint64_t));
+    w->next = (uint32_t *)(void *)p;
+    p += column_bytes(f->n, sizeof(uint32_t));
+    w->prev = (uint32_t *)(void *)p;
+    p += column_bytes(f->n, sizeof(uint32_t));
+    w->slot = (uint16_t *)(void *)p;
+
+    w->fleet = f;
+    w->T = T;
+    w->now = now;
+    w->fault_time = 0;
+
+    for (level = 0; level < HB_WHEEL_LEVELS; level++) {
+        w->occupied[level] = 0;
+        for (idx = 0; idx < HB_WHEEL_SLOTS; idx++) {
+            w->head[level][idx] = HB_WHEEL_NONE;
+        }
+    }
+
+    /* Schedule everything currently ALIVE; stale ones fall due at once */
+    for (i = 0; i < f->n; i++) {
+        w->slot[i] = HB_WHEEL_IDLE;
+        if (f->have_hb[i] && f->st[i] == (uint8_t)STATE_ALIVE) {
+            schedule_monitor(w, (uint32_t)i);
+        }
+    }
+
+    return 0;
+}
+
+void hb_wheel_heartbeat(hb_wheel_t *w, size_t i, uint64_t now)
+{
+    hb_fleet_t *f = w->fleet;
+
+    /* Reentrancy check — the fleet is the unit of atomicity */
+    if (f->in_step) {
+        f->fault_reentry[i] = 1;
+        f->st[i] = (uint8_t)STATE_DEAD;
+        return;
+    }
+    f->in_step = 1;
+
+    /* As hb_step with hb_seen = 1: age is zero, so ALIVE */
+    f->last_hb[i] = now;
+    f->have_hb[i] = 1;
+    f->st[i] = (uint8_t)STATE_ALIVE;
+
+    unlink_monitor(w, (uint32_t)i);
+    schedule_monitor(w, (uint32_t)i);
+
+    f->in_step = 0;
+}
+
+size_t hb_advance(hb_wheel_t *w, uint64_t now, uint32_t *expired, size_t cap)
+{
+    hb_fleet_t *f = w->fleet;
+    size_t count = 0;
+    size_t i;
+
+    /* Reentrancy check — fail safe, as hb_fleet_step */
+    if (f->in_step) {
+        for (i = 0; i < f->n; i++) {
+            f->fault_reentry[i] = 1;
+            f->st[i] = (uint8_t)STATE_DEAD;
+        }
+        return 0;
+    }
+
+    /* Time must not run backwards: the wheel cannot un-expire */
+    if (!age_valid(age_u64(now, w->now))) {
+        w->fault_time = 1;
+        return 0;
+    }
+    f->in_step = 1;
+
+    /* Finish any slot a previous capped call left behind */
+    if (!fire_slot(w, expired, cap, &count)) {
+        f->in_step = 0;
+        return count;
+    }
+
+    while (w->now != now) {
+        uint64_t target;
+
+        if (!next_event(w, &target)) {
+            /* Nothing scheduled anywhere: jump straight to now */
+            w->now = now;
+            break;
+        }
+        if (age_u64(target, w->now) > age_u64(now, w->now)) {
+            /* Next event lies beyond now: nothing happens in between */
+            w->now = now;
+            break;
+        }
+
+        w->now = target;
+        if ((w->now & (HB_WHEEL_SLOTS - 1u)) == 0) {
+            cascade(w);
+        }
+        if (!fire_slot(w, expired, cap, &count)) {
+            break;
+        }
+    }
+
+    f->in_step = 0;
+    return count;
+}
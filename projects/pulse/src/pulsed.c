@@ -0,0 +1,323 @@
+/**
+ * pulsed.c - Event-driven heartbeat daemon for a fleet of monitors
+ *
+ * The demo in main.c polls one monitor with usleep() and reads the
+ * clock once per iteration. pulsed instead sleeps in epoll_wait()
+ * until there is something to do:
+ *
+ *   - heartbeats arrive on a Unix datagram socket, drained in batches
+ *     with recvmmsg(); each datagram carries one or more uint32_t
+ *     monitor ids in host byte order
+ *   - a timerfd tick advances a timing wheel (pulse_wheel.h), which
+ *     visits only monitors whose deadline has passed
+ *   - SIGINT/SIGTERM arrive through a signalfd and stop the loop
+ *
+ * The clock is read once per recvmmsg() batch and once per tick.
+ * Once a second pulsed prints heartbeats/sec and wakeups/sec, the
+ * figures to compare against the polling loop, and how many monitors
+ * came ALIVE and went DEAD. src/pulse_send.c is a matching load
+ * generator.
+ *
+ * Per-monitor transitions are printed only with -v: at startup, or
+ * after a network blip, a whole fleet changes state within one tick,
+ * and that many blocking stdout writes would stall the event loop.
+ *
+ * Usage: pulsed [-v] SOCKET [MONITORS [TIMEOUT_MS [TICK_MS]]]
+ *
+ * Linux only (epoll, timerfd, signalfd, recvmmsg).
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License - https://github.com/williamofai/c-from-scratch
+ */
+
+#define _GNU_SOURCE /* For recvmmsg */
+
+#include "pulse_fleet.h"
+#include "pulse_wheel.h"
+#include <errno.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BATCH 64          /* Datagrams per recvmmsg() call          */
+#define DGRAM_MAX 1024    /* Bytes per datagram (256 monitor ids)   */
+#define EXPIRED_CAP 1024  /* Monitors expired per hb_advance() call */
+#define STATS_MS 1000     /* Interval between stats lines           */
+
+/** Get current time in milliseconds (monotonic) */
+static uint64_t now_ms(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000ULL + (uint64_t)ts.tv_nsec / 1000000ULL;
+}
+
+/** Parse a positive decimal argument, or return fallback if absent */
+static uint64_t arg_u64(int argc, char **argv, int i, uint64_t fallback) {
+  char *end;
+  unsigned long long v;
+
+  if (i >= argc) {
+    return fallback;
+  }
+  v = strtoull(argv[i], &end, 10);
+  if (*end != '\0' || v == 0) {
+    fprintf(stderr, "pulsed: invalid number '%s'\n", argv[i]);
+    exit(2);
+  }
+  return (uint64_t)v;
+}
+
+/** Daemon state, counters included */
+typedef struct {
+  hb_fleet_t fleet;
+  hb_wheel_t wheel;
+  uint64_t T;
+  size_t alive;           /* Monitors currently ALIVE             */
+  int verbose;            /* Print every transition (-v)          */
+  uint64_t revived;       /* -> ALIVE since the last stats line   */
+  uint64_t died;          /* -> DEAD since the last stats line    */
+  uint64_t heartbeats;    /* Heartbeats since the last stats line */
+  uint64_t wakeups;       /* epoll wakeups since the last line    */
+  uint64_t total_hb;
+  uint64_t total_wakeups;
+  uint64_t stats_at;      /* When the next stats line is due      */
+} pulsed_t;
+
+/** Drain the socket: recvmmsg() batches until it would block */
+static void on_heartbeats(pulsed_t *d, int sock) {
+  static uint32_t bufs[BATCH][DGRAM_MAX / sizeof(uint32_t)];
+  struct mmsghdr msgs[BATCH];
+  struct iovec iov[BATCH];
+
+  for (;;) {
+    int got;
+    uint64_t now;
+
+    memset(msgs, 0, sizeof(msgs));
+    for (int i = 0; i < BATCH; i++) {
+      iov[i].iov_base = bufs[i];
+      iov[i].iov_len = sizeof(bufs[i]);
+      msgs[i].msg_hdr.msg_iov = &iov[i];
+      msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    got = recvmmsg(sock, msgs, BATCH, MSG_DONTWAIT, NULL);
+    if (got <= 0) {
+      if (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK &&
+          errno != EINTR) {
+        perror("pulsed: recvmmsg");
+      }
+      return;
+    }
+
+    /* One clock read per batch */
+    now = now_ms();
+    for (int i = 0; i < got; i++) {
+      size_t ids = msgs[i].msg_len / sizeof(uint32_t);
+      for (size_t k = 0; k < ids; k++) {
+        uint32_t id = bufs[i][k];
+        if (id >= d->fleet.n) {
+          continue;
+        }
+        if (hb_fleet_state(&d->fleet, id) != STATE_ALIVE) {
+          d->alive++;
+          d->revived++;
+        }
+        if (d->verbose && hb_fleet_state(&d->fleet, id) != STATE_ALIVE) {
+          printf("[%8lu] monitor %u: %s -> ALIVE\n", (unsigned long)now,
+                 (unsigned)id,
+                 hb_fleet_state(&d->fleet, id) == STATE_DEAD ? "DEAD"
+                                                             : "UNKNOWN");
+        }
+        hb_wheel_heartbeat(&d->wheel, id, now);
+        d->heartbeats++;
+      }
+    }
+
+    if (got < BATCH) {
+      return;
+    }
+  }
+}
+
+/** Timer tick: expire due monitors, print stats when due */
+static void on_tick(pulsed_t *d, int tfd) {
+  static uint32_t expired[EXPIRED_CAP];
+  uint64_t ticks;
+  uint64_t now;
+  size_t n;
+
+  if (read(tfd, &ticks, sizeof(ticks)) != (ssize_t)sizeof(ticks)) {
+    return;
+  }
+
+  now = now_ms();
+  do {
+    n = hb_advance(&d->wheel, now, expired, EXPIRED_CAP);
+    d->alive -= n;
+    d->died += n;
+    for (size_t k = 0; d->verbose && k < n; k++) {
+      printf("[%8lu] monitor %u: ALIVE -> DEAD%s\n", (unsigned long)now,
+             (unsigned)expired[k],
+             hb_fleet_faulted(&d->fleet, expired[k]) ? " [FAULT]" : "");
+    }
+  } while (n == EXPIRED_CAP);
+
+  if (now >= d->stats_at) {
+    printf("[%8lu] %lu heartbeats/s, %lu wakeups/s, %lu/%lu alive "
+           "(+%lu, -%lu)\n",
+           (unsigned long)now,
+           (unsigned long)(d->heartbeats * 1000u / STATS_MS),
+           (unsigned long)(d->wakeups * 1000u / STATS_MS),
+           (unsigned long)d->alive, (unsigned long)d->fleet.n,
+           (unsigned long)d->revived, (unsigned long)d->died);
+    fflush(stdout);
+    d->total_hb += d->heartbeats;
+    d->total_wakeups += d->wakeups;
+    d->heartbeats = 0;
+    d->wakeups = 0;
+    d->revived = 0;
+    d->died = 0;
+    d->stats_at = now + STATS_MS;
+  }
+}
+
+int main(int argc, char **argv) {
+  static pulsed_t d;
+  struct sockaddr_un addr;
+  struct itimerspec its;
+  struct epoll_event ev;
+  sigset_t sigs;
+  void *fleet_mem;
+  void *wheel_mem;
+  uint64_t n, tick, start;
+  int sock, tfd, sfd, ep;
+  int running = 1;
+  const char *prog = argv[0];
+
+  if (argc > 1 && strcmp(argv[1], "-v") == 0) {
+    d.verbose = 1;
+    argv++;
+    argc--;
+  }
+  if (argc < 2 || argc > 5) {
+    fprintf(stderr,
+            "usage: %s [-v] SOCKET [MONITORS [TIMEOUT_MS [TICK_MS]]]\n",
+            prog);
+    return 2;
+  }
+  n = arg_u64(argc, argv, 2, 1024);
+  d.T = arg_u64(argc, argv, 3, 2000);
+  tick = arg_u64(argc, argv, 4, 100);
+  if (n >= HB_WHEEL_NONE || d.T > HB_WHEEL_T_MAX ||
+      strlen(argv[1]) >= sizeof(addr.sun_path)) {
+    fprintf(stderr, "pulsed: parameter out of range\n");
+    return 2;
+  }
+
+  /* Fleet and wheel over heap memory, sized by the library */
+  fleet_mem = malloc(hb_fleet_bytes((size_t)n));
+  wheel_mem = malloc(hb_wheel_bytes((size_t)n));
+  start = now_ms();
+  if (fleet_mem == NULL || wheel_mem == NULL ||
+      hb_fleet_init(&d.fleet, fleet_mem, hb_fleet_bytes((size_t)n), (size_t)n,
+                    start) != 0 ||
+      hb_wheel_init(&d.wheel, &d.fleet, wheel_mem, hb_wheel_bytes((size_t)n),
+                    start, d.T) != 0) {
+    fprintf(stderr, "pulsed: cannot set up %lu monitors\n", (unsigned long)n);
+    return 1;
+  }
+  d.stats_at = start + STATS_MS;
+
+  /* Heartbeat socket */
+  sock = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, argv[1]);
+  unlink(argv[1]);
+  if (sock < 0 || bind(sock, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+    perror("pulsed: socket");
+    return 1;
+  }
+
+  /* Evaluation tick */
+  tfd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+  its.it_interval.tv_sec = (time_t)(tick / 1000u);
+  its.it_interval.tv_nsec = (long)((tick % 1000u) * 1000000u);
+  its.it_value = its.it_interval;
+  if (tfd < 0 || timerfd_settime(tfd, 0, &its, NULL) != 0) {
+    perror("pulsed: timerfd");
+    return 1;
+  }
+
+  /* Clean shutdown on SIGINT/SIGTERM */
+  sigemptyset(&sigs);
+  sigaddset(&sigs, SIGINT);
+  sigaddset(&sigs, SIGTERM);
+  sigprocmask(SIG_BLOCK, &sigs, NULL);
+  sfd = signalfd(-1, &sigs, SFD_NONBLOCK | SFD_CLOEXEC);
+
+  ep = epoll_create1(EPOLL_CLOEXEC);
+  if (sfd < 0 || ep < 0) {
+    perror("pulsed: epoll");
+    return 1;
+  }
+  ev.events = EPOLLIN;
+  ev.data.fd = sock;
+  epoll_ctl(ep, EPOLL_CTL_ADD, sock, &ev);
+  ev.data.fd = tfd;
+  epoll_ctl(ep, EPOLL_CTL_ADD, tfd, &ev);
+  ev.data.fd = sfd;
+  epoll_ctl(ep, EPOLL_CTL_ADD, sfd, &ev);
+
+  printf("pulsed - %lu monitors, T = %lu ms, tick = %lu ms, socket %s\n",
+         (unsigned long)n, (unsigned long)d.T, (unsigned long)tick, argv[1]);
+  fflush(stdout);
+
+  while (running) {
+    struct epoll_event events[3];
+    int ready = epoll_wait(ep, events, 3, -1);
+
+    if (ready < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      perror("pulsed: epoll_wait");
+      break;
+    }
+    d.wakeups++;
+
+    for (int i = 0; i < ready; i++) {
+      if (events[i].data.fd == sock) {
+        on_heartbeats(&d, sock);
+      } else if (events[i].data.fd == tfd) {
+        on_tick(&d, tfd);
+      } else {
+        running = 0;
+      }
+    }
+  }
+
+  d.total_hb += d.heartbeats;
+  d.total_wakeups += d.wakeups;
+  printf("\npulsed: %lu heartbeats, %lu wakeups in %lu ms\n",
+         (unsigned long)d.total_hb, (unsigned long)d.total_wakeups,
+         (unsigned long)(now_ms() - start));
+
+  close(ep);
+  close(sfd);
+  close(tfd);
+  close(sock);
+  unlink(argv[1]);
+  free(wheel_mem);
+  free(fleet_mem);
+  return 0;
+}
@@ -14,7 +14,15 @@
 #include <assert.h>
 #include <stdlib.h>
 #include <time.h>
+#include <pthread.h>
 #include "pulse.h"
+#include "pulse_fleet.h"
+#include "pulse_kernel.h"
+#include "pulse_wheel.h"
+#include "pulse_mailbox.h"
+#include "pulse_packed.h"
+#include "pulse_feed.h"
+#include "pulse_group.h"
 
 /*---------------------------------------------------------------------------
  * Test Counters
@@ -396,6 +404,1059 @@ static void test_fuzz(uint64_t iterations)
     PASS();
 }
 
+/*---------------------------------------------------------------------------
+ * Fleet Tests
+ *---------------------------------------------------------------------------*/
+#define FLEET_N 200  /* Deliberately not a multiple of 64 */
+
+static uint64_t fleet_mem[4096];  /* uint64_t storage: 8-byte aligned */
+
+/** Deterministic xorshift64 so failures are reproducible */
+static uint64_t fleet_rng = 0x9E3779B97F4A7C15ULL;
+static uint64_t fleet_rand(void)
+{
+    fleet_rng ^= fleet_rng << 13;
+    fleet_rng ^= fleet_rng >> 7;
+    fleet_rng ^= fleet_rng << 17;
+    return fleet_rng;
+}
+
+/** Monitor i of the fleet must equal the reference hb_fsm_t exactly */
+static void verify_fleet_matches(const hb_fleet_t *f, const hb_fsm_t *ref)
+{
+    for (size_t i = 0; i < f->n; i++) {
+        assert(f->st[i] == (uint8_t)ref[i].st);
+        assert(f->last_hb[i] == ref[i].last_hb);
+        assert(f->t_init[i] == ref[i].t_init);
+        assert(f->have_hb[i] == ref[i].have_hb);
+        assert(f->fault_time[i] == ref[i].fault_time);
+        assert(f->fault_reentry[i] == ref[i].fault_reentry);
+    }
+    assert(f->in_step == 0);
+}
+
+static void test_fleet_init(void)
+{
+    TEST("Fleet: Init validates memory and matches hb_init");
+
+    hb_fleet_t f;
+    size_t need = hb_fleet_bytes(FLEET_N);
+
+    assert(need > 0 && need <= sizeof(fleet_mem));
+    assert(hb_fleet_bytes(0) == 0);
+
+    /* Rejected: NULL, empty, too small, misaligned */
+    assert(hb_fleet_init(NULL, fleet_mem, need, FLEET_N, 0) == -1);
+    assert(hb_fleet_init(&f, NULL, need, FLEET_N, 0) == -1);
+    assert(hb_fleet_init(&f, fleet_mem, need, 0, 0) == -1);
+    assert(hb_fleet_init(&f, fleet_mem, need - 1, FLEET_N, 0) == -1);
+    assert(hb_fleet_init(&f, (char *)fleet_mem + 1, need, FLEET_N, 0) == -1);
+
+    assert(hb_fleet_init(&f, fleet_mem, need, FLEET_N, 42) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        assert(hb_fleet_state(&f, i) == STATE_UNKNOWN);
+        assert(f.t_init[i] == 42);
+        assert(!hb_fleet_has_evidence(&f, i));
+        assert(!hb_fleet_faulted(&f, i));
+    }
+
+    PASS();
+}
+
+static void test_fleet_matches_hb_step(void)
+{
+    TEST("Fleet: hb_fleet_step equals hb_step per monitor");
+
+    hb_fleet_t f;
+    hb_fsm_t ref[FLEET_N];
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint64_t T = 1000;
+    uint64_t W = 0;
+    uint64_t now = 5000;
+
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, now) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        hb_init(&ref[i], now);
+    }
+
+    for (int step = 0; step < 2000; step++) {
+        /* Mostly forward time, occasional backward jump (fault path) */
+        if (fleet_rand() % 500 == 0) {
+            now -= 1 + fleet_rand() % 3000;
+        } else {
+            now += fleet_rand() % 400;
+        }
+
+        /* Sparse, dense or absent heartbeat bitmaps */
+        uint64_t density = fleet_rand() % 4;
+        for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+            uint64_t r = fleet_rand();
+            seen[w] = (density == 0) ? 0
+                    : (density == 1) ? (r & fleet_rand() & fleet_rand())
+                    : r;
+        }
+
+        hb_fleet_step(&f, now, (density == 3) ? NULL : seen, T, W);
+        for (size_t i = 0; i < FLEET_N; i++) {
+            uint8_t hb = (density == 3) ? 0
+                       : (uint8_t)((seen[i / 64] >> (i % 64)) & 1u);
+            hb_step(&ref[i], now, hb, T, W);
+        }
+
+        verify_fleet_matches(&f, ref);
+    }
+
+    PASS();
+}
+
+static void test_fleet_reentry(void)
+{
+    TEST("Fleet: Reentrancy faults every monitor");
+
+    hb_fleet_t f;
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, 0) == 0);
+    for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+        seen[w] = ~0ULL;
+    }
+    hb_fleet_step(&f, 0, seen, 1000, 0);
+    assert(hb_fleet_state(&f, 0) == STATE_ALIVE);
+
+    /* Simulate reentrancy by manually setting the fleet guard */
+    f.in_step = 1;
+    hb_fleet_step(&f, 100, seen, 1000, 0);
+
+    for (size_t i = 0; i < FLEET_N; i++) {
+        assert(hb_fleet_state(&f, i) == STATE_DEAD);
+        assert(hb_fleet_faulted(&f, i));
+        assert(f.fault_reentry[i] == 1);
+    }
+
+    PASS();
+}
+
+static uint64_t kernel_mem[4096];
+
+/** Two fleets must agree column for column */
+static void verify_fleets_equal(const hb_fleet_t *a, const hb_fleet_t *b)
+{
+    assert(a->n == b->n);
+    for (size_t i = 0; i < a->n; i++) {
+        assert(a->st[i] == b->st[i]);
+        assert(a->last_hb[i] == b->last_hb[i]);
+        assert(a->t_init[i] == b->t_init[i]);
+        assert(a->have_hb[i] == b->have_hb[i]);
+        assert(a->fault_time[i] == b->fault_time[i]);
+        assert(a->fault_reentry[i] == b->fault_reentry[i]);
+    }
+}
+
+static void test_fleet_kernels_agree(void)
+{
+    TEST("Fleet: Every supported kernel equals the scalar kernel");
+
+    static const uint64_t timeouts[] = {
+        0, 1, 1000, (1ULL << 63) - 1, 1ULL << 63, ~0ULL
+    };
+    hb_fleet_t ref;
+    hb_fleet_t f;
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+
+    assert(hb_kernel_supported(HB_KERNEL_SCALAR));
+    assert(hb_kernel_supported(hb_kernel_best()));
+
+    for (int k = HB_KERNEL_SCALAR; k <= HB_KERNEL_AVX512; k++) {
+        if (!hb_kernel_supported((hb_kernel_t)k)) {
+            assert(hb_fleet_init(&f, kernel_mem, sizeof(kernel_mem),
+                                 FLEET_N, 0) == 0);
+            assert(hb_fleet_set_kernel(&f, (hb_kernel_t)k) == -1);
+            continue;
+        }
+
+        for (size_t t = 0; t < sizeof(timeouts) / sizeof(timeouts[0]); t++) {
+            uint64_t T = timeouts[t];
+            uint64_t now = 1ULL << 62;
+
+            /* Sizes exercise whole vectors, partial vectors and tails */
+            for (size_t n = 1; n <= FLEET_N; n += 1 + n / 3) {
+                assert(hb_fleet_init(&ref, fleet_mem, sizeof(fleet_mem),
+                                     n, now) == 0);
+                assert(hb_fleet_init(&f, kernel_mem, sizeof(kernel_mem),
+                                     n, now) == 0);
+                assert(hb_fleet_set_kernel(&ref, HB_KERNEL_SCALAR) == 0);
+                assert(hb_fleet_set_kernel(&f, (hb_kernel_t)k) == 0);
+
+                for (int step = 0; step < 200; step++) {
+                    uint64_t r = fleet_rand() % 50;
+                    if (r == 0) {
+                        now -= 1 + fleet_rand() % 3000;
+                    } else if (r == 1) {
+                        now += fleet_rand();
+                    } else {
+                        now += fleet_rand() % 400;
+                    }
+                    for (size_t w = 0; w < HB_FLEET_WORDS(n); w++) {
+                        seen[w] = fleet_rand() & fleet_rand();
+                    }
+                    hb_fleet_step(&ref, now, (r == 2) ? NULL : seen, T, 0);
+                    hb_fleet_step(&f, now, (r == 2) ? NULL : seen, T, 0);
+                    verify_fleets_equal(&f, &ref);
+                }
+            }
+        }
+    }
+
+    PASS();
+}
+
+static void test_fleet_mark_then_sweep(void)
+{
+    TEST("Fleet: mark_seen_bitmap + sweep equals hb_fleet_step");
+
+    hb_fleet_t f;
+    hb_fleet_t ref;
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint64_t T = 1000;
+    uint64_t now = 5000;
+
+    assert(hb_fleet_init(&f, kernel_mem, sizeof(kernel_mem),
+                         FLEET_N, now) == 0);
+    assert(hb_fleet_init(&ref, fleet_mem, sizeof(fleet_mem),
+                         FLEET_N, now) == 0);
+
+    for (int step = 0; step < 2000; step++) {
+        size_t expect = 0;
+
+        if (fleet_rand() % 500 == 0) {
+            now -= 1 + fleet_rand() % 3000;
+        } else {
+            now += fleet_rand() % 400;
+        }
+
+        /* Bits past FLEET_N are set too: they must be ignored */
+        for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+            seen[w] = (fleet_rand() % 3 == 0) ? 0
+                                              : fleet_rand() & fleet_rand();
+        }
+        for (size_t i = 0; i < FLEET_N; i++) {
+            expect += (seen[i / 64] >> (i % 64)) & 1u;
+        }
+
+        assert(hb_fleet_mark_seen_bitmap(&f, now, seen) == expect);
+        hb_fleet_step(&f, now, NULL, T, 0);
+        hb_fleet_step(&ref, now, seen, T, 0);
+        verify_fleets_equal(&f, &ref);
+    }
+
+    /* NULL marks nothing; marking never evaluates */
+    assert(hb_fleet_mark_seen_bitmap(&f, now, NULL) == 0);
+    seen[0] = 1;
+    assert(hb_fleet_init(&f, kernel_mem, sizeof(kernel_mem),
+                         FLEET_N, now) == 0);
+    assert(hb_fleet_mark_seen_bitmap(&f, now, seen) == 1);
+    assert(hb_fleet_has_evidence(&f, 0));
+    assert(hb_fleet_state(&f, 0) == STATE_UNKNOWN);
+
+    /* Marking during a step is reentry: every monitor faults */
+    f.in_step = 1;
+    assert(hb_fleet_mark_seen_bitmap(&f, now, seen) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        assert(hb_fleet_state(&f, i) == STATE_DEAD);
+        assert(f.fault_reentry[i] == 1);
+    }
+
+    PASS();
+}
+
+
+/*---------------------------------------------------------------------------
+ * Timing Wheel Tests
+ *---------------------------------------------------------------------------*/
+static uint64_t wheel_mem[4096];
+static uint64_t ref_mem[4096];
+
+/**
+ * Drive a wheel-backed fleet and a fully swept reference fleet with the
+ * same heartbeats; after every hb_advance both must agree exactly, and
+ * the expired list must be exactly the ALIVE → DEAD transitions.
+ */
+static void run_wheel_equivalence(uint64_t T, uint64_t max_gap)
+{
+    hb_fleet_t f, ref;
+    hb_wheel_t w;
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint8_t before[FLEET_N];
+    uint32_t expired[FLEET_N];
+    uint64_t now = 1000;
+
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, now) == 0);
+    assert(hb_fleet_init(&ref, ref_mem, sizeof(ref_mem), FLEET_N, now) == 0);
+    assert(hb_wheel_init(&w, &f, wheel_mem, sizeof(wheel_mem), now, T) == 0);
+
+    for (int step = 0; step < 3000; step++) {
+        /* Occasional long silences exercise the upper levels */
+        now += (fleet_rand() % 16 == 0) ? fleet_rand() % (max_gap * 8u)
+                                         : fleet_rand() % max_gap;
+
+        for (size_t k = 0; k < HB_FLEET_WORDS(FLEET_N); k++) {
+            seen[k] = fleet_rand() & fleet_rand() & fleet_rand();
+        }
+        for (size_t i = 0; i < FLEET_N; i++) {
+            before[i] = ref.st[i];
+            if ((seen[i / 64] >> (i % 64)) & 1u) {
+                hb_wheel_heartbeat(&w, i, now);
+            }
+        }
+
+        size_t n_exp = hb_advance(&w, now, expired, FLEET_N);
+        hb_fleet_step(&ref, now, seen, T, 0);
+
+        for (size_t i = 0; i < FLEET_N; i++) {
+            assert(f.st[i] == ref.st[i]);
+            assert(f.last_hb[i] == ref.last_hb[i]);
+            assert(hb_wheel_scheduled(&w, i) == (f.st[i] == STATE_ALIVE));
+        }
+
+        /* Expired list == monitors whose reference went ALIVE → DEAD
+         * without a heartbeat this step */
+        size_t n_trans = 0;
+        for (size_t i = 0; i < FLEET_N; i++) {
+            if (before[i] == STATE_ALIVE && ref.st[i] == STATE_DEAD) {
+                n_trans++;
+            }
+        }
+        assert(n_exp == n_trans);
+        for (size_t k = 0; k < n_exp; k++) {
+            assert(before[expired[k]] == STATE_ALIVE);
+            assert(f.st[expired[k]] == STATE_DEAD);
+        }
+    }
+}
+
+static void test_wheel_matches_sweep(void)
+{
+    TEST("Wheel: hb_advance equals full sweep (all levels)");
+
+    run_wheel_equivalence(1000, 400);          /* Levels 0-1          */
+    run_wheel_equivalence(200000, 60000);      /* Levels 2-3          */
+    run_wheel_equivalence(1ULL << 26, 1ULL << 24); /* Beyond top level */
+
+    PASS();
+}
+
+static void test_wheel_capped_advance(void)
+{
+    TEST("Wheel: Capped hb_advance resumes where it stopped");
+
+    hb_fleet_t f;
+    hb_wheel_t w;
+    uint32_t expired[3];
+    uint64_t T = 1000;
+
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, 0) == 0);
+    assert(hb_wheel_init(&w, &f, wheel_mem, sizeof(wheel_mem), 0, T) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        hb_wheel_heartbeat(&w, i, i % 7);
+    }
+
+    /* Not yet due at T: nothing expires */
+    assert(hb_advance(&w, T, expired, 3) == 0);
+
+    size_t total = 0;
+    size_t got;
+    while ((got = hb_advance(&w, T + 7, expired, 3)) > 0) {
+        assert(got <= 3);
+        total += got;
+    }
+    assert(total == FLEET_N);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        assert(hb_fleet_state(&f, i) == STATE_DEAD);
+        assert(!hb_wheel_scheduled(&w, i));
+    }
+
+    PASS();
+}
+
+static void test_wheel_clock_backward(void)
+{
+    TEST("Wheel: Backward time is flagged, nothing expires");
+
+    hb_fleet_t f;
+    hb_wheel_t w;
+    uint64_t T = 1000;
+
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, 5000) == 0);
+    assert(hb_wheel_init(&w, &f, wheel_mem, sizeof(wheel_mem), 5000, T) == 0);
+    hb_wheel_heartbeat(&w, 0, 5000);
+
+    assert(hb_advance(&w, 4000, NULL, 0) == 0);
+    assert(w.fault_time == 1);
+    assert(hb_fleet_state(&f, 0) == STATE_ALIVE);
+
+    /* Recovery path: full sweep detects the per-monitor fault */
+    hb_fleet_step(&f, 4000, NULL, T, 0);
+    assert(hb_fleet_state(&f, 0) == STATE_DEAD);
+    assert(f.fault_time[0] == 1);
+
+    /* Invalid parameters */
+    assert(hb_wheel_init(&w, &f, wheel_mem, 8, 0, T) == -1);
+    assert(hb_wheel_init(&w, &f, wheel_mem, sizeof(wheel_mem), 0,
+                         HB_WHEEL_T_MAX + 1u) == -1);
+
+    PASS();
+}
+
+/*---------------------------------------------------------------------------
+ * Mailbox Tests
+ *---------------------------------------------------------------------------*/
+static void test_mailbox_records_posted_time(void)
+{
+    TEST("Mailbox: Posted timestamp becomes last_hb");
+
+    hb_fsm_t m;
+    hb_mailbox_t mb;
+    uint64_t T = 1000;
+
+    hb_init(&m, 0);
+    hb_mailbox_init(&mb);
+
+    /* Nothing posted: no evidence */
+    hb_step_mailbox(&m, &mb, 100, T, 0);
+    assert(hb_state(&m) == STATE_UNKNOWN);
+
+    /* Heartbeat at 150, evaluated at 400: age measured from 150 */
+    hb_post(&mb, 150);
+    hb_step_mailbox(&m, &mb, 400, T, 0);
+    assert(hb_state(&m) == STATE_ALIVE);
+    assert(m.last_hb == 150);
+
+    /* DEAD exactly when the posted heartbeat is older than T */
+    hb_step_mailbox(&m, &mb, 150 + T, T, 0);
+    assert(hb_state(&m) == STATE_ALIVE);
+    hb_step_mailbox(&m, &mb, 150 + T + 1, T, 0);
+    assert(hb_state(&m) == STATE_DEAD);
+    verify_invariants(&m);
+
+    PASS();
+}
+
+static void test_mailbox_never_optimistic(void)
+{
+    TEST("Mailbox: Stale and future stamps stay sound");
+
+    hb_fsm_t m;
+    hb_mailbox_t mb;
+    uint64_t T = 1000;
+
+    hb_init(&m, 0);
+    hb_mailbox_init(&mb);
+
+    hb_post(&mb, 500);
+    hb_step_mailbox(&m, &mb, 500, T, 0);
+    assert(m.last_hb == 500);
+
+    /* A racing producer left an older stamp: ignored */
+    hb_post(&mb, 300);
+    hb_step_mailbox(&m, &mb, 600, T, 0);
+    assert(m.last_hb == 500);
+
+    /* Producer clock read after the evaluator's: clamped to now */
+    hb_post(&mb, 900);
+    hb_step_mailbox(&m, &mb, 700, T, 0);
+    assert(m.last_hb == 700);
+    assert(hb_state(&m) == STATE_ALIVE);
+    assert(!hb_faulted(&m));
+    verify_invariants(&m);
+
+    PASS();
+}
+
+static void test_mailbox_reentry(void)
+{
+    TEST("Mailbox: Reentrant evaluator still faults");
+
+    hb_fsm_t m;
+    hb_mailbox_t mb;
+
+    hb_init(&m, 0);
+    hb_mailbox_init(&mb);
+    hb_post(&mb, 10);
+
+    m.in_step = 1;
+    hb_step_mailbox(&m, &mb, 20, 1000, 0);
+    assert(hb_state(&m) == STATE_DEAD);
+    assert(m.fault_reentry == 1);
+    assert(m.have_hb == 0);  /* Mailbox untouched by the faulted call */
+
+    PASS();
+}
+
+#define MAILBOX_PRODUCERS 4
+#define MAILBOX_POSTS     200000
+
+static _Atomic uint64_t mailbox_clock;
+static atomic_int mailbox_done;
+static hb_mailbox_t mailbox_shared;
+
+static void *mailbox_producer(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < MAILBOX_POSTS; i++) {
+        hb_post(&mailbox_shared, atomic_fetch_add(&mailbox_clock, 1));
+    }
+    atomic_fetch_add(&mailbox_done, 1);
+    return NULL;
+}
+
+static void test_mailbox_concurrent_producers(void)
+{
+    TEST("Mailbox: Concurrent producers, one evaluator, no faults");
+
+    pthread_t threads[MAILBOX_PRODUCERS];
+    hb_fsm_t m;
+    uint64_t T = 5000;
+
+    atomic_init(&mailbox_clock, 1);
+    atomic_init(&mailbox_done, 0);
+    hb_mailbox_init(&mailbox_shared);
+    hb_init(&m, 0);
+
+    for (int i = 0; i < MAILBOX_PRODUCERS; i++) {
+        assert(pthread_create(&threads[i], NULL, mailbox_producer, NULL) == 0);
+    }
+
+    while (atomic_load(&mailbox_done) < MAILBOX_PRODUCERS) {
+        uint64_t now = atomic_load(&mailbox_clock);
+        hb_step_mailbox(&m, &mailbox_shared, now, T, 0);
+        verify_invariants(&m);
+        assert(!hb_faulted(&m));
+
+        /* CONTRACT-1: ALIVE only on a heartbeat no newer than now */
+        if (hb_state(&m) == STATE_ALIVE) {
+            assert(m.last_hb <= now);
+            assert(now - m.last_hb <= T);
+        }
+    }
+
+    for (int i = 0; i < MAILBOX_PRODUCERS; i++) {
+        pthread_join(threads[i], NULL);
+    }
+
+    PASS();
+}
+
+/*---------------------------------------------------------------------------
+ * Packed Monitor Tests
+ *---------------------------------------------------------------------------*/
+static _Alignas(64) hb_packed_t packed_mem[FLEET_N];
+
+/** Packed monitor i must equal the reference hb_fsm_t exactly */
+static void verify_packed_matches(const hb_packed_fleet_t *f,
+                                  const hb_fsm_t *ref)
+{
+    for (size_t i = 0; i < f->n; i++) {
+        assert(hb_packed_state(f, i) == ref[i].st);
+        assert(hb_packed_has_evidence(f, i) == ref[i].have_hb);
+        assert(((f->m[i].bits & HB_PACKED_FAULT_TIME) != 0)
+               == ref[i].fault_time);
+        assert(((f->m[i].bits & HB_PACKED_FAULT_REENTRY) != 0)
+               == ref[i].fault_reentry);
+        if (ref[i].have_hb && !(f->m[i].bits & HB_PACKED_LAST_FAR)) {
+            assert(f->epoch + f->m[i].last_hb == ref[i].last_hb);
+        }
+    }
+    assert(f->in_step == 0);
+}
+
+static void test_packed_init(void)
+{
+    TEST("Packed: 16 bytes, init validates and matches hb_init");
+
+    hb_packed_fleet_t f;
+
+    assert(sizeof(hb_packed_t) == 16);
+    assert(hb_packed_init(NULL, packed_mem, FLEET_N, 0) == -1);
+    assert(hb_packed_init(&f, NULL, FLEET_N, 0) == -1);
+    assert(hb_packed_init(&f, packed_mem, 0, 0) == -1);
+    assert(hb_packed_init(&f, (hb_packed_t *)(void *)((char *)packed_mem + 4),
+                          FLEET_N - 1, 0) == -1);
+
+    assert(hb_packed_init(&f, packed_mem, FLEET_N, 42) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        assert(hb_packed_state(&f, i) == STATE_UNKNOWN);
+        assert(f.epoch + f.m[i].t_init == 42);
+        assert(!hb_packed_has_evidence(&f, i));
+        assert(!hb_packed_faulted(&f, i));
+    }
+
+    PASS();
+}
+
+static void test_packed_matches_hb_step(void)
+{
+    TEST("Packed: hb_packed_step equals hb_step across rebases");
+
+    hb_packed_fleet_t f;
+    hb_fsm_t ref[FLEET_N];
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint64_t T = 1000;
+    uint64_t W = 0;
+    uint64_t now = 5000;
+    uint64_t epoch = 0;
+    int rebases = 0;
+
+    assert(hb_packed_init(&f, packed_mem, FLEET_N, now) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        hb_init(&ref[i], now);
+    }
+
+    for (int step = 0; step < 3000; step++) {
+        /* Small backward jumps, ordinary ticks and huge forward leaps */
+        uint64_t r = fleet_rand() % 500;
+        if (r == 0) {
+            now -= 1 + fleet_rand() % 3000;
+        } else if (r < 10) {
+            now += fleet_rand() % (1ULL << 31);
+        } else {
+            now += fleet_rand() % 400;
+        }
+
+        uint64_t density = fleet_rand() % 4;
+        for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+            uint64_t x = fleet_rand();
+            seen[w] = (density == 0) ? 0
+                    : (density == 1) ? (x & fleet_rand() & fleet_rand())
+                    : x;
+        }
+
+        epoch = f.epoch;
+        hb_packed_step(&f, now, (density == 3) ? NULL : seen, T, W);
+        rebases += (f.epoch != epoch);
+        for (size_t i = 0; i < FLEET_N; i++) {
+            uint8_t hb = (density == 3) ? 0
+                       : (uint8_t)((seen[i / 64] >> (i % 64)) & 1u);
+            hb_step(&ref[i], now, hb, T, W);
+        }
+
+        verify_packed_matches(&f, ref);
+    }
+    assert(rebases > 5);
+
+    PASS();
+}
+
+static void test_packed_far_timestamps(void)
+{
+    TEST("Packed: Far timestamps never yield ALIVE");
+
+    hb_packed_fleet_t f;
+    hb_fsm_t ref[FLEET_N];
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint64_t T = 1000;
+    uint64_t now = 0;
+
+    assert(hb_packed_init(&f, packed_mem, FLEET_N, now) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        hb_init(&ref[i], now);
+    }
+
+    /* Even monitors beat once, then everyone is silent for 2^33 units */
+    for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+        seen[w] = 0x5555555555555555ULL;
+    }
+    hb_packed_step(&f, now, seen, T, 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        hb_step(&ref[i], now, (uint8_t)((i & 1u) == 0), T, 0);
+    }
+    for (int k = 0; k < 8; k++) {
+        now += 1ULL << 30;
+        hb_packed_step(&f, now, NULL, T, 0);
+        for (size_t i = 0; i < FLEET_N; i++) {
+            hb_step(&ref[i], now, 0, T, 0);
+        }
+        verify_packed_matches(&f, ref);
+    }
+    assert(f.m[0].bits & HB_PACKED_LAST_FAR);
+    assert(f.m[1].bits & HB_PACKED_INIT_FAR);
+
+    /* Beyond the exactness bounds: clock leaps back and forth */
+    for (int step = 0; step < 2000; step++) {
+        if (fleet_rand() % 2) {
+            now -= fleet_rand() % (1ULL << 33);
+        } else {
+            now += fleet_rand() % (1ULL << 33);
+        }
+        for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+            seen[w] = fleet_rand() & fleet_rand() & fleet_rand();
+        }
+        hb_packed_step(&f, now, seen, T, 0);
+        for (size_t i = 0; i < FLEET_N; i++) {
+            hb_step(&ref[i], now, (uint8_t)((seen[i / 64] >> (i % 64)) & 1u),
+                    T, 0);
+            /* CONTRACT-1: never ALIVE where hb_step is not */
+            if (hb_packed_state(&f, i) == STATE_ALIVE) {
+                assert(hb_state(&ref[i]) == STATE_ALIVE);
+            }
+        }
+    }
+
+    PASS();
+}
+
+/*---------------------------------------------------------------------------
+ * Change Feed Tests
+ *---------------------------------------------------------------------------*/
+static hb_change_t feed_buf[1024];
+
+static void test_feed_single_monitor(void)
+{
+    TEST("Feed: Only real transitions are recorded");
+
+    hb_feed_t q;
+    hb_change_t c;
+    hb_fsm_t m;
+    uint64_t T = 1000;
+
+    assert(hb_feed_init(NULL, feed_buf, 16) == -1);
+    assert(hb_feed_init(&q, NULL, 16) == -1);
+    assert(hb_feed_init(&q, feed_buf, 1) == -1);
+    assert(hb_feed_init(&q, feed_buf, 12) == -1);
+    assert(hb_feed_init(&q, feed_buf, 16) == 0);
+    assert(hb_feed_pop(&q, &c) == HB_FEED_EMPTY);
+
+    hb_init(&m, 0);
+    hb_step_feed(&m, &q, 7, 0, 0, T, 0);      /* UNKNOWN, no change */
+    hb_step_feed(&m, &q, 7, 10, 1, T, 0);     /* -> ALIVE           */
+    hb_step_feed(&m, &q, 7, 500, 1, T, 0);    /* ALIVE, no change   */
+    hb_step_feed(&m, &q, 7, 1501, 0, T, 0);   /* -> DEAD            */
+    hb_step_feed(&m, &q, 7, 1600, 0, T, 0);   /* DEAD, no change    */
+    hb_step_feed(&m, &q, 7, 1700, 1, T, 0);   /* -> ALIVE           */
+
+    assert(hb_feed_pop(&q, &c) == HB_FEED_CHANGE);
+    assert(c.id == 7 && c.t == 10);
+    assert(c.old_st == STATE_UNKNOWN && c.new_st == STATE_ALIVE);
+    assert(hb_feed_pop(&q, &c) == HB_FEED_CHANGE);
+    assert(c.t == 1501 && c.old_st == STATE_ALIVE && c.new_st == STATE_DEAD);
+    assert(hb_feed_pop(&q, &c) == HB_FEED_CHANGE);
+    assert(c.t == 1700 && c.old_st == STATE_DEAD && c.new_st == STATE_ALIVE);
+    assert(hb_feed_pop(&q, &c) == HB_FEED_EMPTY);
+    verify_invariants(&m);
+
+    PASS();
+}
+
+static void test_feed_fleet_matches_states(void)
+{
+    TEST("Feed: Fleet changes replay to the fleet's states");
+
+    hb_feed_t q;
+    hb_change_t c;
+    hb_fleet_t f;
+    uint8_t mirror[FLEET_N];
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint64_t T = 1000;
+    uint64_t now = 5000;
+
+    assert(hb_feed_init(&q, feed_buf, 1024) == 0);
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, now) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        mirror[i] = (uint8_t)STATE_UNKNOWN;
+    }
+
+    for (int step = 0; step < 2000; step++) {
+        if (fleet_rand() % 500 == 0) {
+            now -= 1 + fleet_rand() % 3000;
+        } else {
+            now += fleet_rand() % 400;
+        }
+        for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+            seen[w] = fleet_rand() & fleet_rand() & fleet_rand();
+        }
+        hb_fleet_step_feed(&f, &q, now, seen, T, 0);
+
+        /* Applying the changes must reproduce the fleet, in order */
+        hb_feed_result_t r;
+        while ((r = hb_feed_pop(&q, &c)) == HB_FEED_CHANGE) {
+            assert(c.id < FLEET_N && c.t == now);
+            assert(c.old_st == mirror[c.id] && c.new_st != c.old_st);
+            mirror[c.id] = c.new_st;
+        }
+        assert(r == HB_FEED_EMPTY);
+        for (size_t i = 0; i < FLEET_N; i++) {
+            assert(mirror[i] == f.st[i]);
+        }
+    }
+
+    PASS();
+}
+
+static void test_feed_overflow_resync(void)
+{
+    TEST("Feed: Overflow drops changes and demands a resync");
+
+    hb_feed_t q;
+    hb_change_t c;
+    hb_fleet_t f;
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    int changes = 0;
+
+    assert(hb_feed_init(&q, feed_buf, 8) == 0);
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, 0) == 0);
+    for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+        seen[w] = ~0ULL;
+    }
+
+    /* FLEET_N transitions into a ring of 8 */
+    hb_fleet_step_feed(&f, &q, 0, seen, 1000, 0);
+    hb_feed_result_t r;
+    while ((r = hb_feed_pop(&q, &c)) == HB_FEED_CHANGE) {
+        assert(c.id == (uint32_t)changes);
+        changes++;
+    }
+    assert(changes == 8);
+    assert(r == HB_FEED_RESYNC);
+    assert(hb_feed_pop(&q, &c) == HB_FEED_EMPTY);
+
+    /* The ring works normally afterwards */
+    hb_fleet_step_feed(&f, &q, 1001, NULL, 1000, 0);
+    assert(hb_feed_pop(&q, &c) == HB_FEED_CHANGE);
+    assert(c.old_st == STATE_ALIVE && c.new_st == STATE_DEAD);
+
+    PASS();
+}
+
+#define FEED_EVENTS 200000
+
+static hb_feed_t feed_shared;
+static atomic_int feed_done;
+
+typedef struct {
+    uint64_t delivered;
+    uint64_t resyncs;
+} feed_tally_t;
+
+static void *feed_consumer(void *arg)
+{
+    feed_tally_t *tally = (feed_tally_t *)arg;
+    uint64_t next = 0;
+    hb_change_t c;
+
+    for (;;) {
+        int done = atomic_load(&feed_done);
+        hb_feed_result_t r = hb_feed_pop(&feed_shared, &c);
+        if (r == HB_FEED_CHANGE) {
+            /* ORDER: timestamps only ever increase */
+            assert(c.t >= next);
+            next = c.t + 1;
+            tally->delivered++;
+        } else if (r == HB_FEED_RESYNC) {
+            tally->resyncs++;
+        } else if (done) {
+            break;
+        }
+    }
+    return NULL;
+}
+
+static void test_feed_concurrent(void)
+{
+    TEST("Feed: Threads, in-order delivery, loss implies resync");
+
+    pthread_t consumer;
+    feed_tally_t tally = { 0, 0 };
+    uint64_t dropped = 0;
+
+    assert(hb_feed_init(&feed_shared, feed_buf, 64) == 0);
+    atomic_store(&feed_done, 0);
+    assert(pthread_create(&consumer, NULL, feed_consumer, &tally) == 0);
+
+    for (uint64_t t = 0; t < FEED_EVENTS; t++) {
+        dropped += !hb_feed_push(&feed_shared, (uint32_t)t, STATE_ALIVE,
+                                 STATE_DEAD, t);
+    }
+    atomic_store(&feed_done, 1);
+    pthread_join(consumer, NULL);
+
+    /* COMPLETENESS: everything pushed arrived, and any loss was flagged */
+    assert(tally.delivered == FEED_EVENTS - dropped);
+    assert((dropped == 0) == (tally.resyncs == 0));
+
+    PASS();
+}
+
+/*---------------------------------------------------------------------------
+ * Group Tests
+ *---------------------------------------------------------------------------*/
+#define GROUP_RACKS 7
+#define GROUP_ZONES 3
+#define GROUP_N     (GROUP_RACKS + GROUP_ZONES)
+
+static uint32_t group_mem[GROUP_N * 4];
+static uint32_t group_parent[GROUP_N];
+static uint32_t group_of[FLEET_N];
+
+/** Racks 0..6 under zones 7..9; every 13th monitor is ungrouped */
+static void group_setup(void)
+{
+    for (uint32_t k = 0; k < GROUP_N; k++) {
+        group_parent[k] = (k < GROUP_RACKS) ? GROUP_RACKS + k % GROUP_ZONES
+                                            : HB_GROUP_NONE;
+    }
+    for (size_t i = 0; i < FLEET_N; i++) {
+        group_of[i] = (i % 13 == 0) ? HB_GROUP_NONE
+                                    : (uint32_t)(i % GROUP_RACKS);
+    }
+}
+
+/** Counts by brute force must equal the incremental counts */
+static void verify_group_counts(const hb_groups_t *g, const uint8_t *st,
+                                size_t n)
+{
+    for (size_t k = 0; k < GROUP_N; k++) {
+        uint32_t want[HB_GROUP_STATES] = {0, 0, 0};
+        for (size_t i = 0; i < n; i++) {
+            uint32_t up = group_of[i];
+            while (up != HB_GROUP_NONE && up != k) {
+                up = group_parent[up];
+            }
+            if (up == k) {
+                want[st[i]]++;
+            }
+        }
+        assert(hb_groups_count(g, k, STATE_UNKNOWN) == want[STATE_UNKNOWN]);
+        assert(hb_groups_count(g, k, STATE_ALIVE) == want[STATE_ALIVE]);
+        assert(hb_groups_count(g, k, STATE_DEAD) == want[STATE_DEAD]);
+    }
+}
+
+static void test_group_init(void)
+{
+    TEST("Group: Init validates the tree and counts UNKNOWN");
+
+    hb_groups_t g;
+    uint8_t st[FLEET_N] = {0};
+    uint32_t bad_parent[GROUP_N];
+
+    group_setup();
+    assert(hb_groups_bytes(0) == 0);
+    assert(hb_groups_bytes(GROUP_N) <= sizeof(group_mem));
+
+    assert(hb_groups_init(NULL, group_mem, sizeof(group_mem), GROUP_N,
+                          group_parent, group_of, FLEET_N) == -1);
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_N,
+                          group_parent, NULL, FLEET_N) == -1);
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem) - 1, GROUP_N,
+                          group_parent, group_of, FLEET_N) == -1);
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_RACKS,
+                          NULL, group_of, FLEET_N) == 0);
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), 2,
+                          NULL, group_of, FLEET_N) == -1);
+
+    /* A parent must have a larger index: no cycles, no self-loops */
+    for (size_t k = 0; k < GROUP_N; k++) {
+        bad_parent[k] = group_parent[k];
+    }
+    bad_parent[GROUP_N - 1] = 0;
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_N,
+                          bad_parent, group_of, FLEET_N) == -1);
+    bad_parent[GROUP_N - 1] = GROUP_N - 1;
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_N,
+                          bad_parent, group_of, FLEET_N) == -1);
+
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_N,
+                          group_parent, group_of, FLEET_N) == 0);
+    verify_group_counts(&g, st, FLEET_N);
+    for (size_t k = 0; k < GROUP_N; k++) {
+        assert(hb_groups_has_quorum(&g, k));
+    }
+    assert(hb_groups_set_quorum(&g, GROUP_N, 1) == -1);
+
+    PASS();
+}
+
+static void test_group_fleet_counts(void)
+{
+    TEST("Group: Fleet step keeps nested counts and quorum exact");
+
+    hb_fleet_t f;
+    hb_groups_t g;
+    uint64_t seen[HB_FLEET_WORDS(FLEET_N)];
+    uint8_t quorate[GROUP_N];
+    uint64_t now = 1000;
+
+    group_setup();
+    assert(hb_fleet_init(&f, fleet_mem, sizeof(fleet_mem), FLEET_N, now) == 0);
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_N,
+                          group_parent, group_of, FLEET_N) == 0);
+    for (size_t k = 0; k < GROUP_N; k++) {
+        assert(hb_groups_set_quorum(&g, k, (uint32_t)(5 + k * 3)) == 0);
+        quorate[k] = hb_groups_has_quorum(&g, k);
+    }
+
+    for (int step = 0; step < 2000; step++) {
+        size_t flips;
+        size_t want = 0;
+
+        if (fleet_rand() % 500 == 0) {
+            now -= 1 + fleet_rand() % 3000;
+        } else {
+            now += fleet_rand() % 400;
+        }
+        for (size_t w = 0; w < HB_FLEET_WORDS(FLEET_N); w++) {
+            seen[w] = fleet_rand() & fleet_rand();
+        }
+
+        flips = hb_groups_fleet_step(&g, &f, now,
+                                     (step % 7 == 0) ? NULL : seen, 1000, 0);
+        verify_group_counts(&g, f.st, FLEET_N);
+
+        /* Every net quorum change was reported; the rest come in pairs */
+        for (size_t k = 0; k < GROUP_N; k++) {
+            want += (quorate[k] != hb_groups_has_quorum(&g, k));
+            quorate[k] = hb_groups_has_quorum(&g, k);
+        }
+        assert(flips >= want && (flips - want) % 2 == 0);
+    }
+
+    /* Reentry faults the fleet; the groups follow via a recount */
+    f.in_step = 1;
+    (void)hb_groups_fleet_step(&g, &f, now, NULL, 1000, 0);
+    verify_group_counts(&g, f.st, FLEET_N);
+    assert(hb_groups_count(&g, GROUP_N - 1, STATE_ALIVE) == 0);
+
+    PASS();
+}
+
+static void test_group_single_monitors(void)
+{
+    TEST("Group: hb_groups_step tracks individual monitors");
+
+    hb_groups_t g;
+    hb_fsm_t m[FLEET_N];
+    uint8_t st[FLEET_N];
+    uint64_t now = 0;
+
+    group_setup();
+    assert(hb_groups_init(&g, group_mem, sizeof(group_mem), GROUP_N,
+                          group_parent, group_of, FLEET_N) == 0);
+    for (size_t i = 0; i < FLEET_N; i++) {
+        hb_init(&m[i], now);
+    }
+
+    for (int step = 0; step < 500; step++) {
+        now += fleet_rand() % 300;
+        for (size_t i = 0; i < FLEET_N; i++) {
+            (void)hb_groups_step(&g, &m[i], i, now,
+                                 (uint8_t)(fleet_rand() % 4 == 0), 500, 0);
+            st[i] = (uint8_t)hb_state(&m[i]);
+        }
+        verify_group_counts(&g, st, FLEET_N);
+    }
+
+    PASS();
+}
+
 /*---------------------------------------------------------------------------
  * Main
  *---------------------------------------------------------------------------*/
@@ -434,6 +1495,40 @@ int main(void)
     printf("\nFuzz Tests:\n");
     test_fuzz(100000);
 
+    printf("\nFleet Tests:\n");
+    test_fleet_init();
+    test_fleet_matches_hb_step();
+    test_fleet_reentry();
+    test_fleet_kernels_agree();
+    test_fleet_mark_then_sweep();
+
+    printf("\nTiming Wheel Tests:\n");
+    test_wheel_matches_sweep();
+    test_wheel_capped_advance();
+    test_wheel_clock_backward();
+
+    printf("\nMailbox Tests:\n");
+    test_mailbox_records_posted_time();
+    test_mailbox_never_optimistic();
+    test_mailbox_reentry();
+    test_mailbox_concurrent_producers();
+
+    printf("\nPacked Monitor Tests:\n");
+    test_packed_init();
+    test_packed_matches_hb_step();
+    test_packed_far_timestamps();
+
+    printf("\nChange Feed Tests:\n");
+    test_feed_single_monitor();
+    test_feed_fleet_matches_states();
+    test_feed_overflow_resync();
+    test_feed_concurrent();
+
+    printf("\nGroup Tests:\n");
+    test_group_init();
+    test_group_fleet_counts();
+    test_group_single_monitors();
+
     printf("\n");
     printf("══════════════════════════════════════════════════════════════════\n");
     printf("  Results: %d/%d tests passed\n", tests_passed, tests_run);
@@ -36,6 +36,7 @@
 #include <stdint.h>
 #include "pulse.h"
 #include "baseline.h"
+#include "timing_phi.h"
 
 /**
  * Composed timing health states.
@@ -64,6 +65,9 @@ typedef struct {
     double   epsilon;               /* Variance floor for z-score */
     double   k;                     /* Deviation threshold (sigma) */
     uint32_t n_min;                 /* Min observations before STABLE */
+    
+    /* Phi-accrual mode (see timing_phi.h) */
+    double   phi_threshold;         /* Suspicion level for DEAD, 0 = off */
 } timing_config_t;
 
 /**
@@ -75,6 +79,7 @@ typedef struct {
  * epsilon              = 1e-9   Variance floor
  * k                    = 3.0    Three-sigma threshold
  * n_min                = 20     Learning period
+ * phi_threshold        = 0      Phi-accrual off: fixed timeout only
  */
 static const timing_config_t TIMING_DEFAULT_CONFIG = {
     .heartbeat_timeout_ms = 5000,
@@ -82,7 +87,8 @@ static const timing_config_t TIMING_DEFAULT_CONFIG = {
     .alpha                = 0.1,
     .epsilon              = 1e-9,
     .k                    = 3.0,
-    .n_min                = 20
+    .n_min                = 20,
+    .phi_threshold        = 0.0
 };
 
 /**
@@ -95,6 +101,7 @@ static const timing_config_t TIMING_DEFAULT_CONFIG = {
  *   INV-4: (fault_pulse ∨ fault_baseline) → (state ∈ {UNHEALTHY, DEAD})
  *   INV-5: (in_step == 0) when not executing timing_heartbeat/timing_check
  *   INV-6: last_heartbeat_ms is valid after first heartbeat
+ *   INV-7: timeout_ms ≤ cfg.heartbeat_timeout_ms
  */
 typedef struct {
     /* Configuration (immutable after init) */
@@ -109,6 +116,8 @@ typedef struct {
     
     /* Timing tracking */
     uint64_t last_heartbeat_ms;  /* Timestamp of last heartbeat */
+    uint64_t timeout_ms;         /* Effective pulse timeout (≤ T) */
+    double   phi_z;              /* z at which phi reaches threshold */
     uint8_t  has_prev_heartbeat; /* Have we seen at least one heartbeat? */
     
     /* Fault flags (aggregated from components) */
@@ -141,6 +150,10 @@ typedef struct {
     double   z;
     uint8_t  has_z;
     
+    /* Phi-accrual suspicion of the current silence (valid if has_phi) */
+    double   phi;
+    uint8_t  has_phi;
+    
     /* Component states (for debugging/logging) */
     state_t      pulse_state;
     base_state_t baseline_state;
@@ -166,6 +179,7 @@ typedef struct {
  *   - epsilon > 0
  *   - k > 0
  *   - n_min >= ceil(2/alpha)
+ *   - phi_threshold >= 0 (0 disables phi-accrual mode)
  * 
  * POSTCONDITION: t is in INITIALIZING state with zeroed statistics.
  */
@@ -203,6 +217,14 @@ timing_result_t timing_heartbeat(timing_fsm_t *t, uint64_t timestamp_ms);
  * 
  * NOTE: Does not generate Δt or update baseline statistics.
  *       Only checks if pulse has timed out.
+ * 
+ * PHI-ACCRUAL MODE (phi_threshold > 0):
+ *   Once the baseline is ready, the pulse timeout shrinks from T to
+ *   the silence at which phi reaches phi_threshold, μ + z_thr · σ of
+ *   the learned inter-arrival times, never beyond T. It is recomputed
+ *   on each heartbeat, so this check is still one compare; result.phi
+ *   reports the current suspicion level from the lookup table.
+ *   DEAD can only come earlier than with T alone, never later.
  */
 timing_result_t timing_check(timing_fsm_t *t, uint64_t current_time_ms);
 
@@ -0,0 +1,226 @@
+/**
+ * timing_fleet.h - Column-Wise Fleet of Timing Monitors
+ *
+ * The same composition as timing.h (event → Pulse → Δt → Baseline),
+ * for millions of endpoints that share a handful of configurations.
+ *
+ * A timing_fsm_t is 224 bytes: its own timing_config_t, a base_fsm_t
+ * carrying a second copy of the baseline configuration, an hb_fsm_t
+ * whose last heartbeat duplicates the monitor's own, and counters no
+ * decision reads. The fleet keeps each configuration once, in a small
+ * table, and per endpoint only the fields a step reads or writes:
+ *
+ *   last_ms[]     uint64_t  8 bytes  last heartbeat (pulse last_hb)
+ *   timeout_ms[]  uint64_t  8 bytes  effective pulse timeout (≤ T)
+ *   mu[]          double    8 bytes  baseline μ of Δt
+ *   variance[]    double    8 bytes  baseline σ² of Δt (σ = √σ²)
+ *   count[]       uint32_t  4 bytes  baseline observation count (n)
+ *   state[]       uint8_t   1 byte   timing_state_t
+ *   parts[]       uint8_t   1 byte   pulse state_t | base_state_t << 2
+ *   flags[]       uint8_t   1 byte   TIMING_FLEET_* below
+ *   cfg_id[]      uint8_t   1 byte   index into the config table
+ *
+ * 40 bytes an endpoint: 10 million endpoints in 400 MB instead of
+ * 2.2 GB, and a timeout sweep reads only last_ms, timeout_ms, flags
+ * and parts.
+ *
+ * Dropped as derivable or constant: σ (√σ², recomputed where used),
+ * pulse t_init (always 0), have_hb (the HAS_PREV flag), the component
+ * fault and reentrancy flags (folded into the monitor's). Dropped as
+ * unused by any transition: heartbeat_count and the consecutive
+ * healthy/unhealthy counters; baseline n counts the Δt observed.
+ *
+ * CONTRACTS:
+ *   Identical to timing.h. Endpoint i, stepped with timing_fleet_
+ *   heartbeat() and timing_fleet_check(), returns exactly the
+ *   timing_result_t, and reaches exactly the state, that a timing_fsm_t
+ *   initialised with config cfg_id[i] would under timing_heartbeat()
+ *   and timing_check().
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access per endpoint (caller must ensure)
+ *   - Backing memory provided by the caller (no allocation here)
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#ifndef TIMING_FLEET_H
+#define TIMING_FLEET_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "timing.h"
+
+#define TIMING_FLEET_MAX_CONFIGS 16
+
+/* flags[] bits */
+#define TIMING_FLEET_HAS_PREV    0x01u  /* At least one heartbeat seen   */
+#define TIMING_FLEET_FAULT_PULSE 0x02u  /* Pulse faulted (sticky)        */
+#define TIMING_FLEET_FAULT_BASE  0x04u  /* Baseline faulted (sticky)     */
+#define TIMING_FLEET_IN_STEP     0x08u  /* Reentrancy guard              */
+
+/**
+ * Fleet of timing monitors over caller-provided memory.
+ *
+ * INVARIANTS (per endpoint i, as timing_fsm_t):
+ *   INV-1: state[i] ∈ { INITIALIZING, HEALTHY, UNHEALTHY, DEAD }
+ *   INV-4: fault flags → state[i] ∈ { UNHEALTHY, DEAD }
+ *   INV-5: IN_STEP clear when not executing a fleet step
+ *   INV-7: timeout_ms[i] ≤ T of config cfg_id[i]
+ *   INV-8: cfg_id[i] < n_cfg
+ */
+typedef struct {
+    /* Shared configuration table (append-only) */
+    timing_config_t cfg[TIMING_FLEET_MAX_CONFIGS];
+    double          phi_z[TIMING_FLEET_MAX_CONFIGS]; /* z at phi_threshold */
+    uint32_t        n_cfg;          /* Entries in use                    */
+
+    size_t n;                       /* Number of endpoints               */
+
+    /* Per-endpoint columns, n entries each */
+    uint64_t *last_ms;
+    uint64_t *timeout_ms;
+    double   *mu;
+    double   *variance;
+    uint32_t *count;                /* Baseline n                        */
+    uint8_t  *state;
+    uint8_t  *parts;
+    uint8_t  *flags;
+    uint8_t  *cfg_id;
+} timing_fleet_t;
+
+/**
+ * Bytes of backing memory required for n endpoints.
+ *
+ * @return Required size in bytes (0 if n is 0 or the size overflows)
+ */
+size_t timing_fleet_bytes(size_t n);
+
+/**
+ * Initialise the fleet; every endpoint starts on config 0 = *cfg.
+ *
+ * @param f        Pointer to fleet structure
+ * @param mem      Backing memory, aligned to sizeof(uint64_t)
+ * @param mem_size Size of mem in bytes (>= timing_fleet_bytes(n))
+ * @param n        Number of endpoints (> 0)
+ * @param cfg      Configuration, as for timing_init()
+ * @return         0 on success, -1 on invalid parameters
+ */
+int timing_fleet_init(timing_fleet_t *f, void *mem, size_t mem_size,
+                      size_t n, const timing_config_t *cfg);
+
+/**
+ * Add a configuration to the shared table.
+ *
+ * @return Its index (cfg_id), or -1 if cfg is invalid or the table full
+ */
+int timing_fleet_add_config(timing_fleet_t *f, const timing_config_t *cfg);
+
+/**
+ * Move endpoint i to config cfg_id and reset it.
+ *
+ * @return 0 on success, -1 if i or cfg_id is out of range
+ */
+int timing_fleet_assign(timing_fleet_t *f, size_t i, uint8_t cfg_id);
+
+/**
+ * timing_heartbeat() for endpoint i.
+ *
+ * GUARANTEE: Total function - an out-of-range i returns DEAD.
+ */
+timing_result_t timing_fleet_heartbeat(timing_fleet_t *f, size_t i,
+                                       uint64_t timestamp_ms);
+
+/**
+ * Scratch bytes timing_fleet_ingest() needs to group a batch of n.
+ */
+size_t timing_fleet_ingest_bytes(size_t n);
+
+/**
+ * Apply a batch of heartbeats (id[j], ts[j]), grouped by endpoint.
+ *
+ * Each endpoint sees its events in batch order, exactly as a loop of
+ * timing_fleet_heartbeat(f, id[j], ts[j]) would apply them, but with
+ * no timing_result_t built and each endpoint's columns touched in one
+ * run. An id-sorted batch is applied in place; any other is first
+ * grouped by a stable radix sort of (id, position) in scratch, ids in
+ * ascending order so the columns are walked front to back.
+ *
+ * @param f            Pointer to initialised fleet
+ * @param id           n endpoint indices; out-of-range ids are skipped
+ * @param ts           n heartbeat timestamps
+ * @param n            Number of events (< 2³²)
+ * @param scratch      Grouping memory, aligned to sizeof(uint64_t), or NULL
+ * @param scratch_size Bytes at scratch (>= timing_fleet_ingest_bytes(n))
+ * @param changed      Room for n ids, or NULL to count only
+ * @return             Number of ids written to changed: those whose
+ *                     timing_state_t differs after their run of events
+ *                     from before it
+ *
+ * An unsorted batch without enough scratch is applied in batch order,
+ * a run being consecutive events of one id: an id interleaved with
+ * others can then be reported once per run.
+ */
+size_t timing_fleet_ingest(timing_fleet_t *f, const uint32_t *id,
+                           const uint64_t *ts, size_t n, void *scratch,
+                           size_t scratch_size, uint32_t *changed);
+
+/**
+ * timing_check() for endpoint i.
+ *
+ * GUARANTEE: Total function - an out-of-range i returns DEAD.
+ */
+timing_result_t timing_fleet_check(timing_fleet_t *f, size_t i,
+                                   uint64_t current_time_ms);
+
+/**
+ * timing_check() for every endpoint at one time, reporting new deaths.
+ *
+ * Leaves every endpoint's columns exactly as a loop of timing_fleet_
+ * check(f, i, current_time_ms) over all i would, but builds no
+ * timing_result_t and computes no phi (a report-only value). Endpoints
+ * are tested eight at a time (with AVX2 where the CPU has it): a group
+ * that is ALIVE, unfaulted and not late is skipped without a write, so
+ * a sweep costs one pass over 18 bytes an endpoint.
+ *
+ * @param f               Pointer to initialised fleet
+ * @param current_time_ms One clock reading for the whole sweep
+ * @param dead            Room for n ids, or NULL to count only
+ * @return                Number of ids written to dead, in ascending
+ *                        order: those that were not DEAD before the
+ *                        sweep and are after it
+ */
+size_t timing_fleet_sweep(timing_fleet_t *f, uint64_t current_time_ms,
+                          uint32_t *dead);
+
+/**
+ * timing_reset() for endpoint i; its config is kept.
+ */
+void timing_fleet_reset(timing_fleet_t *f, size_t i);
+
+/**
+ * Query the timing state of endpoint i.
+ */
+static inline timing_state_t timing_fleet_state(const timing_fleet_t *f,
+                                                size_t i) {
+    return (timing_state_t)f->state[i];
+}
+
+/**
+ * Check if endpoint i has faulted.
+ */
+static inline uint8_t timing_fleet_faulted(const timing_fleet_t *f, size_t i) {
+    return (f->flags[i] & (TIMING_FLEET_FAULT_PULSE |
+                           TIMING_FLEET_FAULT_BASE)) != 0;
+}
+
+/**
+ * Check if the baseline of endpoint i has sufficient evidence.
+ */
+static inline uint8_t timing_fleet_ready(const timing_fleet_t *f, size_t i) {
+    const timing_config_t *c = &f->cfg[f->cfg_id[i]];
+    return (f->count[i] >= c->n_min) && (f->variance[i] > c->epsilon);
+}
+
+#endif /* TIMING_FLEET_H */
@@ -0,0 +1,53 @@
+/**
+ * timing_phi.h - Table-Driven Phi-Accrual Suspicion Levels
+ * 
+ * A fixed timeout T forces a choice between fast detection and false
+ * DEAD verdicts on jittery links. The phi-accrual detector instead
+ * asks how surprising the current silence is, given the rhythm the
+ * Baseline component has learned for inter-arrival times:
+ * 
+ *   z(t)   = (t - μ) / σ              t = time since last heartbeat
+ *   phi(t) = -log10(1 - F(z(t)))      F = standard normal CDF
+ * 
+ * phi = 1 means a 10% chance the silence is normal, phi = 3 means
+ * 0.1%, and so on. phi is monotonic in t, so a threshold on phi is a
+ * threshold on t:
+ * 
+ *   phi(t) >= phi_thr   ⟺   t >= μ + z_thr · σ
+ * 
+ * The timing monitor uses this to turn a phi threshold into an
+ * effective timeout once per heartbeat, so each check remains a
+ * single compare. phi itself, for reporting, comes from a precomputed
+ * table over z ∈ [-4, 12] in steps of 1/16 with linear interpolation;
+ * nothing calls erf() or log() at run time.
+ * 
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#ifndef TIMING_PHI_H
+#define TIMING_PHI_H
+
+#define TIMING_PHI_Z_MIN   (-4.0)  /* First table entry (z)          */
+#define TIMING_PHI_Z_MAX   12.0    /* Last table entry (z)           */
+#define TIMING_PHI_STEPS   16      /* Table entries per unit of z    */
+#define TIMING_PHI_ENTRIES 257     /* (Z_MAX - Z_MIN) * STEPS + 1    */
+
+/**
+ * Suspicion level for a standardised silence z.
+ * 
+ * @param z (t - μ) / σ
+ * @return  phi(z), clamped to the table range [phi(-4), phi(12)]
+ */
+double timing_phi_of_z(double z);
+
+/**
+ * Smallest z whose suspicion level reaches phi.
+ * 
+ * @param phi Threshold (> 0)
+ * @return    z_thr with timing_phi_of_z(z_thr) >= phi, clamped to
+ *            [TIMING_PHI_Z_MIN, TIMING_PHI_Z_MAX]
+ */
+double timing_phi_z_for(double phi);
+
+#endif /* TIMING_PHI_H */
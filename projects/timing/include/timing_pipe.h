@@ -0,0 +1,182 @@
+/**
+ * timing_pipe.h - Sharded Multi-Threaded Timing Pipeline
+ *
+ * timing.h needs a single writer per monitor and events in timestamp
+ * order, so a timing layer fed from one queue runs on one core. The
+ * pipeline splits the endpoints into shards, each owned by one worker
+ * thread, and connects every ingest thread to every shard by its own
+ * single-producer, single-consumer ring:
+ *
+ *   producers (ingest threads)          workers (one per shard)
+ *   --------------------------          -----------------------
+ *   timing_pipe_post(p, me, id, ts)     timing_pipe_drain(p, s, changed)
+ *     shard = id mod n_shards             ingest each ring's events into
+ *     push (id, ts) on ring[me][shard]    the shard's timing_fleet_t
+ *                                         timing_pipe_sweep(p, s, now, dead)
+ *
+ * Endpoint id lives in shard id mod n_shards at index id / n_shards of
+ * that shard's fleet. Only the shard's worker ever touches that fleet,
+ * and a ring delivers in push order, so the single-writer requirement
+ * and per-endpoint ordering hold by construction. Shards share nothing
+ * but the rings, each written by one thread and read by one other:
+ * throughput grows with workers until the producers saturate.
+ *
+ * CONTRACTS:
+ *   1. TRANSPARENT: Endpoint id ends exactly as a timing_fsm_t given the
+ *      events of id in the order its workers drained them. With all of
+ *      an endpoint's events posted by one producer, that is post order.
+ *   2. LOSSLESS:    A post either lands in its ring or returns 0 and
+ *      changes nothing; the producer decides whether to retry.
+ *   3. NON-BLOCKING: Neither side ever waits for the other or allocates.
+ *
+ * REQUIREMENTS:
+ *   - Producer index p is used by one thread at a time
+ *   - Shard s is drained, swept and queried by one thread at a time
+ *   - Lock-free atomics on the target (checked at compile time)
+ *
+ * Events of one endpoint posted by two producers travel on two rings
+ * and are applied ring by ring, not by timestamp: give each endpoint
+ * one producer (connection affinity), or reorder them upstream.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#ifndef TIMING_PIPE_H
+#define TIMING_PIPE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "timing.h"
+#include "timing_fleet.h"
+
+#if defined(ATOMIC_LONG_LOCK_FREE) && ATOMIC_LONG_LOCK_FREE != 2
+#error "timing_pipe.h needs lock-free atomics to be non-blocking"
+#endif
+
+#define TIMING_PIPE_MAX_SHARDS    64
+#define TIMING_PIPE_MAX_PRODUCERS 64
+#define TIMING_PIPE_LINE          64   /* Cache line size in bytes */
+
+/**
+ * One producer-to-shard ring.
+ *
+ * The producer owns head, the consumer owns tail; each sits on its own
+ * cache line so that pushing and draining never share a line.
+ *
+ * INVARIANTS:
+ *   INV-R1: 0 <= head - tail <= cap (free-running counters)
+ *   INV-R2: cap is a power of two
+ */
+typedef struct {
+    uint32_t *id;                   /* Fleet index within the shard      */
+    uint64_t *ts;                   /* Heartbeat timestamps              */
+    size_t    cap;                  /* Entries in id[] and ts[]          */
+
+    _Alignas(TIMING_PIPE_LINE)
+    _Atomic size_t head;            /* Next slot to write (producer)     */
+    size_t         tail_seen;       /* Producer's last view of tail      */
+
+    _Alignas(TIMING_PIPE_LINE)
+    _Atomic size_t tail;            /* Next slot to read (consumer)      */
+} timing_pipe_ring_t;
+
+/**
+ * Pipeline over caller-provided memory.
+ *
+ * INVARIANTS:
+ *   INV-1: Endpoint id is index id / n_shards of shard[id % n_shards]
+ *   INV-2: ring[p * n_shards + s] carries producer p's events for shard s
+ */
+typedef struct {
+    size_t              n;            /* Endpoints: ids 0 .. n-1          */
+    uint32_t            n_shards;
+    uint32_t            n_producers;
+    size_t              ring_cap;
+    timing_fleet_t     *shard;        /* n_shards fleets                  */
+    timing_pipe_ring_t *ring;         /* n_producers * n_shards rings     */
+    uint64_t           *scratch;      /* Per shard, for fleet ingest      */
+    size_t              scratch_size; /* Bytes of scratch per shard       */
+} timing_pipe_t;
+
+/**
+ * Bytes of backing memory required.
+ *
+ * @return Required size in bytes (0 if the parameters are invalid or
+ *         the size overflows)
+ */
+size_t timing_pipe_bytes(size_t n, uint32_t n_shards, uint32_t n_producers,
+                         size_t ring_cap);
+
+/**
+ * Initialise the pipeline; every endpoint starts on *cfg.
+ *
+ * @param p           Pointer to pipeline (not yet shared with other threads)
+ * @param mem         Backing memory, aligned to sizeof(uint64_t)
+ * @param mem_size    Size of mem in bytes (>= timing_pipe_bytes())
+ * @param n           Number of endpoints (n_shards <= n < 2³²)
+ * @param n_shards    Worker shards (1 .. TIMING_PIPE_MAX_SHARDS)
+ * @param n_producers Ingest threads (1 .. TIMING_PIPE_MAX_PRODUCERS)
+ * @param ring_cap    Events per ring, a power of two >= 2
+ * @param cfg         Configuration, as for timing_init()
+ * @return            0 on success, -1 on invalid parameters
+ */
+int timing_pipe_init(timing_pipe_t *p, void *mem, size_t mem_size, size_t n,
+                     uint32_t n_shards, uint32_t n_producers, size_t ring_cap,
+                     const timing_config_t *cfg);
+
+/**
+ * Post a heartbeat of endpoint id. Producer side; never blocks.
+ *
+ * @param p        Pointer to initialised pipeline
+ * @param producer Index of the calling producer
+ * @param id       Endpoint id
+ * @param ts       Heartbeat timestamp
+ * @return         1 if posted, 0 if the ring was full (nothing changed),
+ *                 -1 if producer or id is out of range
+ */
+int timing_pipe_post(timing_pipe_t *p, uint32_t producer, uint32_t id,
+                     uint64_t ts);
+
+/**
+ * Apply every event waiting for shard s. Worker side; never blocks.
+ *
+ * Each ring's waiting events go to timing_fleet_ingest() in place, at
+ * most two runs per ring (the ring wraps), then the ring is released.
+ *
+ * @param p       Pointer to initialised pipeline
+ * @param s       Shard index
+ * @param changed Room for n_producers * ring_cap ids, or NULL to count
+ * @return        Number of ids written to changed: those whose state
+ *                changed within a run (an id may appear once per run)
+ */
+size_t timing_pipe_drain(timing_pipe_t *p, uint32_t s, uint32_t *changed);
+
+/**
+ * timing_fleet_sweep() of shard s. Worker side.
+ *
+ * @param dead Room for the shard's endpoint count, or NULL to count
+ * @return     Number of ids written to dead, in ascending order
+ */
+size_t timing_pipe_sweep(timing_pipe_t *p, uint32_t s,
+                         uint64_t current_time_ms, uint32_t *dead);
+
+/**
+ * Shard owning endpoint id.
+ */
+static inline uint32_t timing_pipe_shard_of(const timing_pipe_t *p,
+                                            uint32_t id) {
+    return id % p->n_shards;
+}
+
+/**
+ * Query the timing state of endpoint id; from its shard's worker only.
+ */
+static inline timing_state_t timing_pipe_state(const timing_pipe_t *p,
+                                               uint32_t id) {
+    return timing_fleet_state(&p->shard[id % p->n_shards],
+                              id / p->n_shards);
+}
+
+#endif /* TIMING_PIPE_H */
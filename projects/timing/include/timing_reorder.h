@@ -0,0 +1,131 @@
+/**
+ * timing_reorder.h - Bounded-Lateness Reorder Stage
+ *
+ * timing_heartbeat() computes Δt = timestamp - last heartbeat and
+ * assumes heartbeats arrive in timestamp order. One that arrives late,
+ * over a slower network path, makes the unsigned Δt wrap to ~2⁶⁴: a
+ * bogus deviation, or a pulse fault.
+ *
+ * The reorder stage sits in front of one monitor. It holds up to
+ * TIMING_REORDER_CAP heartbeats in a small sorted buffer and releases
+ * them in timestamp order once the watermark has passed them:
+ *
+ *   watermark = (latest timestamp seen) - lateness_ms
+ *
+ * A heartbeat at most lateness_ms behind the latest one seen is thus
+ * always applied in order. One later still is behind a heartbeat
+ * already released; it is dropped and counted, never applied.
+ *
+ * Checks run in the same delayed time: timing_reorder_check() at now
+ * releases up to now - lateness_ms and checks the monitor at that
+ * time, so no held heartbeat can contradict a decision already made.
+ * The price is latency: DEAD is reported up to lateness_ms later.
+ *
+ * CONTRACTS:
+ *   1. ORDER:       Released timestamps are strictly increasing.
+ *   2. BOUNDED:     A heartbeat no more than lateness_ms behind the
+ *                   latest seen is released, unless it duplicates one
+ *                   held or released, or the buffer forced it out.
+ *   3. TRANSPARENT: With lateness_ms = 0 and in-order, distinct
+ *                   timestamps, every heartbeat is released at once:
+ *                   the monitor steps exactly as without the stage.
+ *
+ * When the buffer is full, the oldest heartbeat is released early:
+ * bursts of more than TIMING_REORDER_CAP within lateness_ms shorten
+ * the bound rather than lose heartbeats.
+ *
+ * REQUIREMENTS:
+ *   - Single-writer access, as for the monitor behind it
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#ifndef TIMING_REORDER_H
+#define TIMING_REORDER_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "timing.h"
+
+#define TIMING_REORDER_CAP 8   /* Heartbeats held per endpoint */
+
+/**
+ * Reorder buffer of one endpoint.
+ *
+ * INVARIANTS:
+ *   INV-1: held[0] < held[1] < ... < held[n_held - 1]
+ *   INV-2: has_out → last_out < held[0]
+ *   INV-3: n_held ≤ TIMING_REORDER_CAP
+ */
+typedef struct {
+    uint64_t held[TIMING_REORDER_CAP];  /* Waiting, ascending           */
+    uint64_t lateness_ms;               /* Bound L                      */
+    uint64_t max_seen;                  /* Latest timestamp accepted    */
+    uint64_t last_out;                  /* Latest timestamp released    */
+    uint32_t late;                      /* Dropped: behind last_out     */
+    uint32_t duplicate;                 /* Dropped: already held or out */
+    uint8_t  n_held;
+    uint8_t  has_out;                   /* last_out is valid            */
+} timing_reorder_t;
+
+/**
+ * Initialise an empty reorder buffer.
+ *
+ * @param r           Pointer to reorder buffer
+ * @param lateness_ms Bound L; 0 releases every in-order heartbeat at once
+ * @return            0 on success, -1 if r is NULL or L ≥ 2⁶³
+ */
+int timing_reorder_init(timing_reorder_t *r, uint64_t lateness_ms);
+
+/**
+ * Accept one heartbeat; release every held timestamp now behind the
+ * watermark, in order.
+ *
+ * @param r   Pointer to initialised reorder buffer
+ * @param ts  Heartbeat timestamp
+ * @param out Room for TIMING_REORDER_CAP + 1 timestamps
+ * @return    Number of timestamps written to out
+ */
+size_t timing_reorder_push(timing_reorder_t *r, uint64_t ts, uint64_t *out);
+
+/**
+ * Release every held timestamp ≤ until, in order.
+ *
+ * @param out Room for TIMING_REORDER_CAP timestamps
+ * @return    Number of timestamps written to out
+ */
+size_t timing_reorder_release(timing_reorder_t *r, uint64_t until,
+                              uint64_t *out);
+
+/**
+ * timing_heartbeat() through the reorder buffer.
+ *
+ * @param r    Pointer to initialised reorder buffer
+ * @param t    Monitor fed by r
+ * @param ts   Heartbeat timestamp
+ * @param last Receives the result of the last heartbeat released, if
+ *             any (may be NULL)
+ * @return     Number of heartbeats applied to t
+ */
+size_t timing_reorder_heartbeat(timing_reorder_t *r, timing_fsm_t *t,
+                                uint64_t ts, timing_result_t *last);
+
+/**
+ * timing_check() in delayed time: release up to now - L, then check t
+ * at now - L (at the latest heartbeat released, if that is later).
+ *
+ * @return As timing_check()
+ */
+timing_result_t timing_reorder_check(timing_reorder_t *r, timing_fsm_t *t,
+                                     uint64_t current_time_ms);
+
+/**
+ * Apply every held heartbeat to t, in order (shutdown, or a final
+ * flush before reading statistics).
+ *
+ * @return Number of heartbeats applied
+ */
+size_t timing_reorder_flush(timing_reorder_t *r, timing_fsm_t *t);
+
+#endif /* TIMING_REORDER_H */
@@ -74,6 +74,8 @@ static timing_result_t build_result(const timing_fsm_t *t,
     r.has_dt = has_dt;
     r.z = z;
     r.has_z = has_z;
+    r.phi = 0.0;
+    r.has_phi = 0;
     
     r.pulse_state = hb_state(&t->pulse);
     r.baseline_state = base_state(&t->baseline);
@@ -86,6 +88,30 @@ static timing_result_t build_result(const timing_fsm_t *t,
     return r;
 }
 
+/**
+ * Recompute the effective pulse timeout after a baseline update.
+ * 
+ * In phi-accrual mode with a ready baseline, the pulse must go DEAD
+ * once age ≥ μ + z_thr · σ, i.e. age > ceil(μ + z_thr · σ) - 1.
+ * Otherwise, and whenever that is later than T, the timeout is T.
+ */
+static void update_timeout(timing_fsm_t *t) {
+    double eff;
+    
+    t->timeout_ms = t->cfg.heartbeat_timeout_ms;
+    if (t->cfg.phi_threshold <= 0.0 || !base_ready(&t->baseline) ||
+        t->fault_baseline) {
+        return;
+    }
+    
+    eff = ceil(t->baseline.mu + t->phi_z * t->baseline.sigma) - 1.0;
+    if (eff < 0.0) {
+        t->timeout_ms = 0;
+    } else if (eff < (double)t->cfg.heartbeat_timeout_ms) {
+        t->timeout_ms = (uint64_t)eff;
+    }
+}
+
 /* ============================================================
  * PUBLIC API
  * ============================================================ */
@@ -117,6 +143,11 @@ int timing_init(timing_fsm_t *t, const timing_config_t *cfg) {
         return -1;
     }
     
+    /* Phi threshold: 0 (off) or positive; rejects NaN */
+    if (!(cfg->phi_threshold >= 0.0)) {
+        return -1;
+    }
+    
     /* Store configuration */
     t->cfg = *cfg;
     
@@ -138,6 +169,9 @@ int timing_init(timing_fsm_t *t, const timing_config_t *cfg) {
     t->state = TIMING_INITIALIZING;
     t->last_heartbeat_ms = 0;
     t->has_prev_heartbeat = 0;
+    t->timeout_ms = cfg->heartbeat_timeout_ms;
+    t->phi_z = (cfg->phi_threshold > 0.0)
+             ? timing_phi_z_for(cfg->phi_threshold) : 0.0;
     
     /* Clear fault flags */
     t->fault_pulse = 0;
@@ -203,6 +237,9 @@ timing_result_t timing_heartbeat(timing_fsm_t *t, uint64_t timestamp_ms) {
         if (base_faulted(&t->baseline)) {
             t->fault_baseline = 1;
         }
+        
+        /* Phi-accrual mode: the learned rhythm sets the next timeout */
+        update_timeout(t);
     }
     
     /* Step 4: Map component states to timing state */
@@ -263,7 +300,7 @@ timing_result_t timing_check(timing_fsm_t *t, uint64_t current_time_ms) {
     
     /* Check pulse timeout (no heartbeat seen) */
     hb_step(&t->pulse, current_time_ms, 0,
-            t->cfg.heartbeat_timeout_ms, t->cfg.init_window_ms);
+            t->timeout_ms, t->cfg.init_window_ms);
     
     /* Check for Pulse fault */
     if (hb_faulted(&t->pulse)) {
@@ -298,7 +335,17 @@ timing_result_t timing_check(timing_fsm_t *t, uint64_t current_time_ms) {
     
     t->in_step = 0;
     
-    return build_result(t, 0, 0, 0, 0);
+    timing_result_t r = build_result(t, 0, 0, 0, 0);
+    
+    /* Report the suspicion level: one divide and a table lookup */
+    if (t->cfg.phi_threshold > 0.0 && base_ready(&t->baseline) &&
+        t->has_prev_heartbeat) {
+        double silence = (double)(current_time_ms - t->last_heartbeat_ms);
+        r.phi = timing_phi_of_z((silence - t->baseline.mu) / t->baseline.sigma);
+        r.has_phi = 1;
+    }
+    
+    return r;
 }
 
 void timing_reset(timing_fsm_t *t) {
@@ -314,6 +361,7 @@ void timing_reset(timing_fsm_t *t) {
     t->state = TIMING_INITIALIZING;
     t->last_heartbeat_ms = 0;
     t->has_prev_heartbeat = 0;
+    t->timeout_ms = t->cfg.heartbeat_timeout_ms;
     
     /* Clear faults */
     t->fault_pulse = 0;
@@ -0,0 +1,647 @@
+/**
+ * timing_fleet.c - Column-Wise Fleet of Timing Monitors Implementation
+ *
+ * Each step is timing_heartbeat() / timing_check() with hb_step() and
+ * base_step() inlined against the columns, operation for operation,
+ * so the statistics round exactly as the composed monitor's do. What
+ * the components would recompute from scratch is not stored:
+ *
+ *   - hb_step() on a heartbeat always yields ALIVE (age 0, T > 0)
+ *   - pulse faults are sticky and copied into fault_pulse at once,
+ *     so FAULT_PULSE alone stands for both
+ *   - base σ is √σ² after every successful step and after reset
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#include "timing_fleet.h"
+#include <math.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define TIMING_FLEET_X86 1
+#include <immintrin.h>
+#else
+#define TIMING_FLEET_X86 0
+#endif
+
+#define PARTS(pulse_st, base_st) \
+    ((uint8_t)((unsigned)(pulse_st) | ((unsigned)(base_st) << 2)))
+#define PULSE_OF(p) ((state_t)((p) & 0x3u))
+#define BASE_OF(p)  ((base_state_t)((p) >> 2))
+
+#define RADIX 256u  /* Buckets per pass of the ingest sort */
+
+/* ============================================================
+ * INTERNAL: Composition (as timing.c)
+ * ============================================================ */
+
+/**
+ * Map component states to composed timing state.
+ *
+ * The same pure function as timing.c's map_states().
+ */
+static timing_state_t map_states(state_t pulse_st, base_state_t baseline_st) {
+    if (pulse_st == STATE_DEAD) {
+        return TIMING_DEAD;
+    }
+    if (pulse_st == STATE_UNKNOWN) {
+        return TIMING_INITIALIZING;
+    }
+    switch (baseline_st) {
+        case BASE_LEARNING:
+            return TIMING_INITIALIZING;
+        case BASE_STABLE:
+            return TIMING_HEALTHY;
+        case BASE_DEVIATION:
+            return TIMING_UNHEALTHY;
+        default:
+            return TIMING_UNHEALTHY;
+    }
+}
+
+/**
+ * Build a result struct from the columns of endpoint i.
+ */
+static timing_result_t build_result(const timing_fleet_t *f, size_t i,
+                                     double dt, uint8_t has_dt,
+                                     double z, uint8_t has_z) {
+    timing_result_t r;
+    timing_state_t st = (timing_state_t)f->state[i];
+
+    r.state = st;
+    r.dt = dt;
+    r.has_dt = has_dt;
+    r.z = z;
+    r.has_z = has_z;
+    r.phi = 0.0;
+    r.has_phi = 0;
+
+    r.pulse_state = PULSE_OF(f->parts[i]);
+    r.baseline_state = BASE_OF(f->parts[i]);
+
+    r.is_healthy = (st == TIMING_HEALTHY);
+    r.is_unhealthy = (st == TIMING_UNHEALTHY);
+    r.is_dead = (st == TIMING_DEAD);
+    r.is_anomaly = r.is_unhealthy || r.is_dead;
+
+    return r;
+}
+
+/** Result for a NULL fleet or an endpoint out of range */
+static timing_result_t dead_result(void) {
+    timing_result_t r = {0};
+    r.state = TIMING_DEAD;
+    r.is_dead = 1;
+    r.is_anomaly = 1;
+    return r;
+}
+
+/** Initial state of endpoint i, as after timing_init() */
+static void reset_endpoint(timing_fleet_t *f, size_t i) {
+    f->last_ms[i] = 0;
+    f->timeout_ms[i] = f->cfg[f->cfg_id[i]].heartbeat_timeout_ms;
+    f->mu[i] = 0.0;
+    f->variance[i] = 0.0;
+    f->count[i] = 0;
+    f->state[i] = TIMING_INITIALIZING;
+    f->parts[i] = PARTS(STATE_UNKNOWN, BASE_LEARNING);
+    f->flags[i] = 0;
+}
+
+/* ============================================================
+ * PUBLIC API
+ * ============================================================ */
+
+size_t timing_fleet_bytes(size_t n) {
+    const size_t per = 4 * sizeof(uint64_t) + sizeof(uint32_t) + 4;
+
+    if (n == 0 || n > SIZE_MAX / per) {
+        return 0;
+    }
+    return n * per;
+}
+
+int timing_fleet_init(timing_fleet_t *f, void *mem, size_t mem_size,
+                      size_t n, const timing_config_t *cfg) {
+    size_t need = timing_fleet_bytes(n);
+    uint8_t *p = (uint8_t *)mem;
+    size_t i;
+
+    if (!f || !mem || !cfg || need == 0 || mem_size < need) {
+        return -1;
+    }
+    if (((uintptr_t)mem % sizeof(uint64_t)) != 0) {
+        return -1;
+    }
+
+    f->n_cfg = 0;
+    if (timing_fleet_add_config(f, cfg) != 0) {
+        return -1;
+    }
+
+    /* 8-byte columns first, then 4-byte, then bytes: all aligned */
+    f->n = n;
+    f->last_ms    = (uint64_t *)(void *)p;  p += n * sizeof(uint64_t);
+    f->timeout_ms = (uint64_t *)(void *)p;  p += n * sizeof(uint64_t);
+    f->mu         = (double *)(void *)p;    p += n * sizeof(double);
+    f->variance   = (double *)(void *)p;    p += n * sizeof(double);
+    f->count      = (uint32_t *)(void *)p;  p += n * sizeof(uint32_t);
+    f->state      = p;                      p += n;
+    f->parts      = p;                      p += n;
+    f->flags      = p;                      p += n;
+    f->cfg_id     = p;
+
+    memset(f->cfg_id, 0, n);
+    for (i = 0; i < n; i++) {
+        reset_endpoint(f, i);
+    }
+    return 0;
+}
+
+int timing_fleet_add_config(timing_fleet_t *f, const timing_config_t *cfg) {
+    timing_fsm_t probe;
+
+    if (!f || !cfg || f->n_cfg >= TIMING_FLEET_MAX_CONFIGS) {
+        return -1;
+    }
+
+    /* Same constraints, and the same phi_z, as a single monitor */
+    if (timing_init(&probe, cfg) != 0) {
+        return -1;
+    }
+    f->cfg[f->n_cfg] = *cfg;
+    f->phi_z[f->n_cfg] = probe.phi_z;
+    return (int)f->n_cfg++;
+}
+
+int timing_fleet_assign(timing_fleet_t *f, size_t i, uint8_t cfg_id) {
+    if (!f || i >= f->n || cfg_id >= f->n_cfg) {
+        return -1;
+    }
+    f->cfg_id[i] = cfg_id;
+    reset_endpoint(f, i);
+    return 0;
+}
+
+/**
+ * timing_heartbeat() for endpoint i < n, without building the result:
+ * Δt and z go to the out-parameters, which a caller may ignore.
+ */
+static inline void heartbeat_core(timing_fleet_t *f, size_t i,
+                                  uint64_t timestamp_ms,
+                                  double *dt_out, uint8_t *has_dt_out,
+                                  double *z_out, uint8_t *has_z_out) {
+    const timing_config_t *c = &f->cfg[f->cfg_id[i]];
+    uint8_t fl = f->flags[i];
+    base_state_t bst;
+    double dt = 0.0;
+    uint8_t has_dt = 0;
+    double z = 0.0;
+    uint8_t has_z = 0;
+
+    /* Reentrancy guard */
+    if (fl & TIMING_FLEET_IN_STEP) {
+        f->flags[i] = (uint8_t)(fl | TIMING_FLEET_FAULT_PULSE);
+        f->state[i] = TIMING_DEAD;
+        *dt_out = 0.0;
+        *has_dt_out = 0;
+        *z_out = 0.0;
+        *has_z_out = 0;
+        return;
+    }
+    f->flags[i] = (uint8_t)(fl | TIMING_FLEET_IN_STEP);
+
+    /* Step 1: Compute inter-arrival time (Δt) */
+    if (fl & TIMING_FLEET_HAS_PREV) {
+        dt = (double)(timestamp_ms - f->last_ms[i]);
+        has_dt = 1;
+    }
+
+    /* Step 2: Pulse sees a heartbeat of age 0: ALIVE */
+    bst = BASE_OF(f->parts[i]);
+
+    /* Step 3: If we have Δt, step the baseline (base_step) */
+    if (has_dt && !(fl & TIMING_FLEET_FAULT_PULSE)) {
+        double alpha = c->alpha;
+        double mu_old = f->mu[i];
+        double deviation = dt - mu_old;
+        double mu_new = alpha * dt + (1.0 - alpha) * mu_old;
+        double var_new = alpha * (deviation * deviation) +
+                         (1.0 - alpha) * f->variance[i];
+        double sigma_new = sqrt(var_new);
+
+        has_z = 1;
+        if (!isfinite(mu_new) || !isfinite(var_new) || !isfinite(sigma_new)) {
+            fl = (uint8_t)(fl | TIMING_FLEET_FAULT_BASE);
+            bst = BASE_DEVIATION;
+        } else {
+            f->mu[i] = mu_new;
+            f->variance[i] = var_new;
+            f->count[i] += 1;
+            z = (var_new <= c->epsilon) ? 0.0
+              : ((deviation < 0.0) ? -deviation : deviation) / sigma_new;
+
+            switch (bst) {
+                case BASE_LEARNING:
+                    if (f->count[i] >= c->n_min && var_new > c->epsilon) {
+                        bst = BASE_STABLE;
+                    }
+                    break;
+                case BASE_STABLE:
+                    if (z > c->k) {
+                        bst = BASE_DEVIATION;
+                    }
+                    break;
+                case BASE_DEVIATION:
+                    if (!(fl & TIMING_FLEET_FAULT_BASE) && z <= c->k) {
+                        bst = BASE_STABLE;
+                    }
+                    break;
+                default:
+                    fl = (uint8_t)(fl | TIMING_FLEET_FAULT_BASE);
+                    bst = BASE_DEVIATION;
+                    break;
+            }
+        }
+
+        /* Phi-accrual mode: the learned rhythm sets the next timeout */
+        f->timeout_ms[i] = c->heartbeat_timeout_ms;
+        if (c->phi_threshold > 0.0 && timing_fleet_ready(f, i) &&
+            !(fl & TIMING_FLEET_FAULT_BASE)) {
+            double eff = ceil(f->mu[i] + f->phi_z[f->cfg_id[i]] * sigma_new)
+                       - 1.0;
+            if (eff < 0.0) {
+                f->timeout_ms[i] = 0;
+            } else if (eff < (double)c->heartbeat_timeout_ms) {
+                f->timeout_ms[i] = (uint64_t)eff;
+            }
+        }
+    }
+
+    /* Step 4: Map component states to timing state */
+    {
+        timing_state_t new_state = map_states(STATE_ALIVE, bst);
+
+        if (fl & TIMING_FLEET_FAULT_PULSE) {
+            new_state = TIMING_DEAD;
+        } else if ((fl & TIMING_FLEET_FAULT_BASE) &&
+                   new_state == TIMING_HEALTHY) {
+            new_state = TIMING_UNHEALTHY;
+        }
+        f->state[i] = (uint8_t)new_state;
+    }
+    f->parts[i] = PARTS(STATE_ALIVE, bst);
+
+    /* Update heartbeat tracking */
+    f->last_ms[i] = timestamp_ms;
+    f->flags[i] = (uint8_t)((fl | TIMING_FLEET_HAS_PREV) &
+                            ~TIMING_FLEET_IN_STEP);
+
+    *dt_out = dt;
+    *has_dt_out = has_dt;
+    *z_out = z;
+    *has_z_out = has_z;
+}
+
+timing_result_t timing_fleet_heartbeat(timing_fleet_t *f, size_t i,
+                                       uint64_t timestamp_ms) {
+    double dt, z;
+    uint8_t has_dt, has_z;
+
+    if (!f || i >= f->n) {
+        return dead_result();
+    }
+    heartbeat_core(f, i, timestamp_ms, &dt, &has_dt, &z, &has_z);
+
+    /* Step 5: Build and return result */
+    return build_result(f, i, dt, has_dt, z, has_z);
+}
+
+size_t timing_fleet_ingest_bytes(size_t n) {
+    if (n == 0 || n > SIZE_MAX / (2 * sizeof(uint64_t))) {
+        return 0;
+    }
+    return 2 * n * sizeof(uint64_t);
+}
+
+size_t timing_fleet_ingest(timing_fleet_t *f, const uint32_t *id,
+                           const uint64_t *ts, size_t n, void *scratch,
+                           size_t scratch_size, uint32_t *changed) {
+    uint64_t *key = (uint64_t *)scratch;
+    size_t m = 0;
+    size_t n_changed = 0;
+    size_t j;
+    int sorted = 1;
+
+    if (!f || !id || !ts || n == 0 || n > UINT32_MAX) {
+        return 0;
+    }
+
+    for (j = 1; j < n && sorted; j++) {
+        sorted = (id[j] >= id[j - 1]);
+    }
+
+    if (!sorted && key && scratch_size >= timing_fleet_ingest_bytes(n) &&
+        ((uintptr_t)scratch % sizeof(uint64_t)) == 0) {
+        uint32_t hist[4][RADIX];
+        uint64_t *tmp = key + n;
+        unsigned passes = 0;
+        unsigned p;
+
+        /* Key = id:position, so a stable sort on id keeps batch order */
+        memset(hist, 0, sizeof(hist));
+        for (j = 0; j < n; j++) {
+            if (id[j] < f->n) {
+                key[m++] = ((uint64_t)id[j] << 32) | (uint64_t)j;
+                hist[0][id[j] & (RADIX - 1)]++;
+                hist[1][(id[j] >> 8) & (RADIX - 1)]++;
+                hist[2][(id[j] >> 16) & (RADIX - 1)]++;
+                hist[3][id[j] >> 24]++;
+            }
+        }
+        while (passes < 4 && ((uint64_t)(f->n - 1) >> (8 * passes)) != 0) {
+            passes++;
+        }
+
+        /* LSD radix sort, one byte of id per pass */
+        for (p = 0; p < passes; p++) {
+            uint32_t sum = 0;
+            unsigned b;
+            uint64_t *swap;
+
+            for (b = 0; b < RADIX; b++) {
+                uint32_t c = hist[p][b];
+                hist[p][b] = sum;
+                sum += c;
+            }
+            for (j = 0; j < m; j++) {
+                unsigned b_j = (unsigned)(key[j] >> (32 + 8 * p)) & (RADIX - 1);
+                tmp[hist[p][b_j]++] = key[j];
+            }
+            swap = key;
+            key = tmp;
+            tmp = swap;
+        }
+
+        /* One run per endpoint */
+        j = 0;
+        while (j < m) {
+            size_t i = (size_t)(key[j] >> 32);
+            uint8_t before = f->state[i];
+
+            do {
+                double dt, z;
+                uint8_t has_dt, has_z;
+                heartbeat_core(f, i, ts[key[j] & 0xFFFFFFFFu],
+                               &dt, &has_dt, &z, &has_z);
+                j++;
+            } while (j < m && (size_t)(key[j] >> 32) == i);
+
+            if (f->state[i] != before) {
+                if (changed) changed[n_changed] = (uint32_t)i;
+                n_changed++;
+            }
+        }
+        return n_changed;
+    }
+
+    /* Sorted (or no scratch): runs of equal consecutive ids, in place */
+    j = 0;
+    while (j < n) {
+        size_t i = id[j];
+        uint8_t before;
+
+        if (i >= f->n) {
+            j++;
+            continue;
+        }
+        before = f->state[i];
+        do {
+            double dt, z;
+            uint8_t has_dt, has_z;
+            heartbeat_core(f, i, ts[j], &dt, &has_dt, &z, &has_z);
+            j++;
+        } while (j < n && id[j] == i);
+
+        if (f->state[i] != before) {
+            if (changed) changed[n_changed] = (uint32_t)i;
+            n_changed++;
+        }
+    }
+    return n_changed;
+}
+
+/**
+ * timing_check() for endpoint i < n, without building the result.
+ *
+ * @return 0 if the reentrancy guard tripped (no pulse step was taken)
+ */
+static inline uint8_t check_core(timing_fleet_t *f, size_t i,
+                                 uint64_t current_time_ms) {
+    uint8_t fl = f->flags[i];
+    state_t pst;
+    base_state_t bst;
+    timing_state_t new_state;
+
+    /* Reentrancy guard */
+    if (fl & TIMING_FLEET_IN_STEP) {
+        f->flags[i] = (uint8_t)(fl | TIMING_FLEET_FAULT_PULSE);
+        f->state[i] = TIMING_DEAD;
+        return 0;
+    }
+    f->flags[i] = (uint8_t)(fl | TIMING_FLEET_IN_STEP);
+
+    /* Check pulse timeout (hb_step, no heartbeat; t_init = 0) */
+    if (!(fl & TIMING_FLEET_HAS_PREV)) {
+        if (current_time_ms >= (1ULL << 63)) {
+            fl = (uint8_t)(fl | TIMING_FLEET_FAULT_PULSE);
+            pst = STATE_DEAD;
+        } else {
+            pst = STATE_UNKNOWN;
+        }
+    } else {
+        uint64_t age = current_time_ms - f->last_ms[i];
+        if (age >= (1ULL << 63)) {
+            fl = (uint8_t)(fl | TIMING_FLEET_FAULT_PULSE);
+            pst = STATE_DEAD;
+        } else {
+            pst = (age > f->timeout_ms[i]) ? STATE_DEAD : STATE_ALIVE;
+        }
+    }
+
+    /* Map states (baseline state unchanged since no new observation) */
+    bst = BASE_OF(f->parts[i]);
+    new_state = map_states(pst, bst);
+    if (fl & TIMING_FLEET_FAULT_PULSE) {
+        new_state = TIMING_DEAD;
+    }
+    f->state[i] = (uint8_t)new_state;
+    f->parts[i] = PARTS(pst, bst);
+    f->flags[i] = fl;
+    return 1;
+}
+
+timing_result_t timing_fleet_check(timing_fleet_t *f, size_t i,
+                                   uint64_t current_time_ms) {
+    const timing_config_t *c;
+    timing_result_t r;
+
+    if (!f || i >= f->n) {
+        return dead_result();
+    }
+    c = &f->cfg[f->cfg_id[i]];
+
+    if (!check_core(f, i, current_time_ms)) {
+        return build_result(f, i, 0, 0, 0, 0);
+    }
+    r = build_result(f, i, 0, 0, 0, 0);
+
+    /* Report the suspicion level: one divide and a table lookup */
+    if (c->phi_threshold > 0.0 && timing_fleet_ready(f, i) &&
+        (f->flags[i] & TIMING_FLEET_HAS_PREV)) {
+        double silence = (double)(current_time_ms - f->last_ms[i]);
+        r.phi = timing_phi_of_z((silence - f->mu[i]) / sqrt(f->variance[i]));
+        r.has_phi = 1;
+    }
+
+    return r;
+}
+
+/* ============================================================
+ * INTERNAL: Sweep
+ * ============================================================ */
+
+/* Eight copies of byte b, for testing eight endpoints' bytes at once */
+#define BYTES8(b) (0x0101010101010101ULL * (uint64_t)(b))
+
+/**
+ * Would a check leave endpoints [i, i + 8) as they are, given that none
+ * is late? True if each has had a heartbeat, has no fault, is not in a
+ * step and its pulse is ALIVE: its state is then map_states(ALIVE, bst)
+ * already, and a check rewrites every column with what it holds.
+ */
+static inline uint8_t group_steady(const timing_fleet_t *f, size_t i) {
+    const uint64_t flag_mask = BYTES8(TIMING_FLEET_HAS_PREV |
+                                      TIMING_FLEET_FAULT_PULSE |
+                                      TIMING_FLEET_FAULT_BASE |
+                                      TIMING_FLEET_IN_STEP);
+    uint64_t fl, pa;
+
+    memcpy(&fl, &f->flags[i], sizeof(fl));
+    memcpy(&pa, &f->parts[i], sizeof(pa));
+    return (fl & flag_mask) == BYTES8(TIMING_FLEET_HAS_PREV) &&
+           (pa & BYTES8(0x3u)) == BYTES8(STATE_ALIVE);
+}
+
+/**
+ * check_core() on endpoints [i, end), appending those that become DEAD
+ * to dead[n_dead...].
+ *
+ * @return The new n_dead
+ */
+static size_t sweep_each(timing_fleet_t *f, size_t i, size_t end,
+                         uint64_t now, uint32_t *dead, size_t n_dead) {
+    for (; i < end; i++) {
+        uint8_t was = f->state[i];
+        check_core(f, i, now);
+        if (was != TIMING_DEAD && f->state[i] == TIMING_DEAD) {
+            if (dead) dead[n_dead] = (uint32_t)i;
+            n_dead++;
+        }
+    }
+    return n_dead;
+}
+
+/**
+ * Sweep endpoints [0, end), end a multiple of 8, eight at a time:
+ * a group that is steady and has no endpoint late (age > timeout, or
+ * age ≥ 2⁶³, a time fault) is skipped without a write.
+ */
+static size_t sweep_scalar(timing_fleet_t *f, size_t end, uint64_t now,
+                           uint32_t *dead) {
+    size_t n_dead = 0;
+    size_t i, k;
+
+    for (i = 0; i < end; i += 8) {
+        uint64_t late = 0;
+
+        for (k = i; k < i + 8; k++) {
+            uint64_t age = now - f->last_ms[k];
+            late |= (uint64_t)(age > f->timeout_ms[k]) | (age >> 63);
+        }
+        if (late == 0 && group_steady(f, i)) {
+            continue;
+        }
+        n_dead = sweep_each(f, i, i + 8, now, dead, n_dead);
+    }
+    return n_dead;
+}
+
+#if TIMING_FLEET_X86
+
+/**
+ * sweep_scalar() with the eight age tests in two AVX2 registers. There
+ * is no unsigned 64-bit compare: flipping the sign bit of both sides
+ * turns age > timeout into a signed one; age ≥ 2⁶³ is age's sign bit.
+ */
+__attribute__((target("avx2")))
+static size_t sweep_avx2(timing_fleet_t *f, size_t end, uint64_t now,
+                         uint32_t *dead) {
+    const __m256i sign = _mm256_set1_epi64x((long long)(1ULL << 63));
+    const __m256i nv = _mm256_set1_epi64x((long long)now);
+    size_t n_dead = 0;
+    size_t i;
+
+    for (i = 0; i < end; i += 8) {
+        const __m256i *last = (const __m256i *)&f->last_ms[i];
+        const __m256i *timeout = (const __m256i *)&f->timeout_ms[i];
+        __m256i a0 = _mm256_sub_epi64(nv, _mm256_loadu_si256(last));
+        __m256i a1 = _mm256_sub_epi64(nv, _mm256_loadu_si256(last + 1));
+        __m256i t0 = _mm256_xor_si256(_mm256_loadu_si256(timeout), sign);
+        __m256i t1 = _mm256_xor_si256(_mm256_loadu_si256(timeout + 1), sign);
+        __m256i l0 = _mm256_cmpgt_epi64(_mm256_xor_si256(a0, sign), t0);
+        __m256i l1 = _mm256_cmpgt_epi64(_mm256_xor_si256(a1, sign), t1);
+        __m256i late = _mm256_or_si256(_mm256_or_si256(l0, a0),
+                                       _mm256_or_si256(l1, a1));
+
+        if (_mm256_movemask_pd(_mm256_castsi256_pd(late)) == 0 &&
+            group_steady(f, i)) {
+            continue;
+        }
+        n_dead = sweep_each(f, i, i + 8, now, dead, n_dead);
+    }
+    return n_dead;
+}
+
+#endif /* TIMING_FLEET_X86 */
+
+/* ============================================================
+ * PUBLIC API (continued)
+ * ============================================================ */
+
+size_t timing_fleet_sweep(timing_fleet_t *f, uint64_t current_time_ms,
+                          uint32_t *dead) {
+    size_t end, n_dead;
+
+    if (!f) {
+        return 0;
+    }
+
+    end = f->n & ~(size_t)7;
+#if TIMING_FLEET_X86
+    if (__builtin_cpu_supports("avx2")) {
+        n_dead = sweep_avx2(f, end, current_time_ms, dead);
+    } else
+#endif
+    {
+        n_dead = sweep_scalar(f, end, current_time_ms, dead);
+    }
+    return sweep_each(f, end, f->n, current_time_ms, dead, n_dead);
+}
+
+void timing_fleet_reset(timing_fleet_t *f, size_t i) {
+    if (!f || i >= f->n) return;
+    reset_endpoint(f, i);
+}
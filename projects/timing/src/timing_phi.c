@@ -0,0 +1,109 @@
+/**
+ * timing_phi.c - Table-Driven Phi-Accrual Suspicion Levels
+ * 
+ * PHI_TABLE[i] = -log10(1 - F(z)) at z = -4 + i/16, F the standard
+ * normal CDF, computed offline as -log10(erfc(z/√2) / 2).
+ * 
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#include "timing_phi.h"
+
+/* ============================================================
+ * INTERNAL: Lookup Table
+ * ============================================================ */
+
+static const double PHI_TABLE[TIMING_PHI_ENTRIES] = {
+    0.000014, 0.000018, 0.000023, 0.000030, 0.000038, 0.000049,
+    0.000063, 0.000080, 0.000101, 0.000128, 0.000160, 0.000201,
+    0.000251, 0.000312, 0.000386, 0.000477, 0.000587, 0.000719,
+    0.000878, 0.001069, 0.001296, 0.001566, 0.001886, 0.002263,
+    0.002705, 0.003223, 0.003828, 0.004529, 0.005342, 0.006279,
+    0.007355, 0.008588, 0.009994, 0.011594, 0.013406, 0.015452,
+    0.017756, 0.020339, 0.023229, 0.026450, 0.030029, 0.033994,
+    0.038373, 0.043196, 0.048492, 0.054293, 0.060628, 0.067528,
+    0.075026, 0.083152, 0.091937, 0.101413, 0.111611, 0.122562,
+    0.134295, 0.146842, 0.160231, 0.174492, 0.189653, 0.205742,
+    0.222786, 0.240812, 0.259844, 0.279909, 0.301030, 0.323231,
+    0.346535, 0.370963, 0.396538, 0.423278, 0.451205, 0.480337,
+    0.510692, 0.542288, 0.575142, 0.609270, 0.644688, 0.681410,
+    0.719451, 0.758825, 0.799546, 0.841624, 0.885074, 0.929906,
+    0.976131, 1.023761, 1.072806, 1.123274, 1.175177, 1.228522,
+    1.283318, 1.339574, 1.397298, 1.456497, 1.517178, 1.579349,
+    1.643016, 1.708186, 1.774864, 1.843057, 1.912770, 1.984009,
+    2.056779, 2.131085, 2.206932, 2.284324, 2.363267, 2.443763,
+    2.525818, 2.609436, 2.694619, 2.781372, 2.869699, 2.959602,
+    3.051086, 3.144152, 3.238805, 3.335047, 3.432881, 3.532310,
+    3.633336, 3.735962, 3.840190, 3.946023, 4.053463, 4.162512,
+    4.273172, 4.385446, 4.499335, 4.614841, 4.731967, 4.850713,
+    4.971082, 5.093076, 5.216695, 5.341942, 5.468818, 5.597325,
+    5.727464, 5.859236, 5.992644, 6.127687, 6.264367, 6.402687,
+    6.542646, 6.684246, 6.827488, 6.972373, 7.118903, 7.267078,
+    7.416899, 7.568368, 7.721485, 7.876251, 8.032667, 8.190735,
+    8.350454, 8.511825, 8.674850, 8.839530, 9.005864, 9.173855,
+    9.343501, 9.514805, 9.687767, 9.862387, 10.038667, 10.216606,
+    10.396206, 10.577467, 10.760390, 10.944975, 11.131223, 11.319134,
+    11.508709, 11.699949, 11.892854, 12.087424, 12.283660, 12.481562,
+    12.681132, 12.882369, 13.085273, 13.289846, 13.496088, 13.703999,
+    13.913579, 14.124829, 14.337750, 14.552341, 14.768603, 14.986537,
+    15.206143, 15.427420, 15.650371, 15.874994, 16.101290, 16.329260,
+    16.558903, 16.790221, 17.023213, 17.257880, 17.494222, 17.732239,
+    17.971932, 18.213300, 18.456345, 18.701067, 18.947464, 19.195539,
+    19.445291, 19.696721, 19.949828, 20.204613, 20.461076, 20.719218,
+    20.979038, 21.240537, 21.503714, 21.768572, 22.035108, 22.303325,
+    22.573221, 22.844797, 23.118053, 23.392990, 23.669608, 23.947906,
+    24.227885, 24.509546, 24.792888, 25.077911, 25.364616, 25.653003,
+    25.943072, 26.234823, 26.528256, 26.823372, 27.120171, 27.418652,
+    27.718817, 28.020664, 28.324195, 28.629409, 28.936306, 29.244888,
+    29.555153, 29.867101, 30.180734, 30.496052, 30.813053, 31.131739,
+    31.452109, 31.774165, 32.097904, 32.423329, 32.750439
+};
+
+/* ============================================================
+ * PUBLIC API
+ * ============================================================ */
+
+double timing_phi_of_z(double z) {
+    double pos = (z - TIMING_PHI_Z_MIN) * TIMING_PHI_STEPS;
+    int i;
+    
+    /* Clamp to the table (also catches NaN on the low side) */
+    if (!(pos > 0.0)) {
+        return PHI_TABLE[0];
+    }
+    if (pos >= (double)(TIMING_PHI_ENTRIES - 1)) {
+        return PHI_TABLE[TIMING_PHI_ENTRIES - 1];
+    }
+    
+    /* Linear interpolation between neighbouring entries */
+    i = (int)pos;
+    return PHI_TABLE[i] + (pos - (double)i) * (PHI_TABLE[i + 1] - PHI_TABLE[i]);
+}
+
+double timing_phi_z_for(double phi) {
+    int lo = 0;
+    int hi = TIMING_PHI_ENTRIES - 1;
+    double frac;
+    
+    if (!(phi > PHI_TABLE[0])) {
+        return TIMING_PHI_Z_MIN;
+    }
+    if (phi >= PHI_TABLE[hi]) {
+        return TIMING_PHI_Z_MAX;
+    }
+    
+    /* Binary search: PHI_TABLE[lo] < phi <= PHI_TABLE[hi] */
+    while (hi - lo > 1) {
+        int mid = (lo + hi) / 2;
+        if (PHI_TABLE[mid] < phi) {
+            lo = mid;
+        } else {
+            hi = mid;
+        }
+    }
+    
+    /* Invert the same interpolation timing_phi_of_z uses */
+    frac = (phi - PHI_TABLE[lo]) / (PHI_TABLE[hi] - PHI_TABLE[lo]);
+    return TIMING_PHI_Z_MIN + ((double)lo + frac) / TIMING_PHI_STEPS;
+}
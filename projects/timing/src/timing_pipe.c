@@ -0,0 +1,233 @@
+/**
+ * timing_pipe.c - Sharded Multi-Threaded Timing Pipeline Implementation
+ *
+ * Each ring is the classic single-producer, single-consumer queue: the
+ * producer publishes head with release ordering after writing the slot,
+ * the consumer publishes tail with release ordering after reading it.
+ * The producer keeps its last view of tail and reloads it only when the
+ * ring looks full, so a post costs one shared-line read per lap.
+ *
+ * A ring stores ids and timestamps in two arrays, already translated
+ * to the shard's fleet index, so the worker hands them straight to
+ * timing_fleet_ingest(): no copy, and one grouped pass per run.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#include "timing_pipe.h"
+#include <string.h>
+
+/* ============================================================
+ * INTERNAL: Layout
+ * ============================================================ */
+
+/** Endpoints of shard s */
+static size_t shard_size(size_t n, uint32_t n_shards, uint32_t s) {
+    return (n - s + n_shards - 1) / n_shards;
+}
+
+/** *total += count * each; -1 on overflow */
+static int add_bytes(size_t *total, size_t count, size_t each) {
+    if (each != 0 && count > (SIZE_MAX - *total) / each) {
+        return -1;
+    }
+    *total += count * each;
+    return 0;
+}
+
+/**
+ * Validate the parameters and size every region.
+ *
+ * Order in memory (each region a multiple of 8 bytes, rings of 64):
+ *   rings | fleets | scratch | ring ts[] | fleet columns | ring id[]
+ *
+ * @return 0 on success, -1 on invalid parameters or overflow
+ */
+static int layout(size_t n, uint32_t n_shards, uint32_t n_producers,
+                  size_t ring_cap, size_t *scratch_size, size_t *total) {
+    size_t rings = (size_t)n_shards * n_producers;
+    size_t ids;
+    uint32_t s;
+
+    if (n_shards == 0 || n_shards > TIMING_PIPE_MAX_SHARDS ||
+        n_producers == 0 || n_producers > TIMING_PIPE_MAX_PRODUCERS ||
+        n < n_shards || n > UINT32_MAX ||
+        ring_cap < 2 || (ring_cap & (ring_cap - 1u)) != 0) {
+        return -1;
+    }
+
+    *scratch_size = timing_fleet_ingest_bytes(ring_cap);
+    *total = TIMING_PIPE_LINE;  /* Room to align the rings */
+    if (*scratch_size == 0 || ring_cap > SIZE_MAX / rings ||
+        add_bytes(total, rings, sizeof(timing_pipe_ring_t)) != 0 ||
+        add_bytes(total, n_shards, sizeof(timing_fleet_t)) != 0 ||
+        add_bytes(total, n_shards, *scratch_size) != 0 ||
+        add_bytes(total, rings * ring_cap, sizeof(uint64_t)) != 0) {
+        return -1;
+    }
+    for (s = 0; s < n_shards; s++) {
+        size_t cols = timing_fleet_bytes(shard_size(n, n_shards, s));
+        if (cols == 0 || add_bytes(total, 1, cols) != 0) {
+            return -1;
+        }
+    }
+    ids = rings * ring_cap;
+    if (add_bytes(total, ids, sizeof(uint32_t)) != 0) {
+        return -1;
+    }
+    return 0;
+}
+
+/* ============================================================
+ * PUBLIC API
+ * ============================================================ */
+
+size_t timing_pipe_bytes(size_t n, uint32_t n_shards, uint32_t n_producers,
+                         size_t ring_cap) {
+    size_t scratch_size, total;
+
+    if (layout(n, n_shards, n_producers, ring_cap,
+               &scratch_size, &total) != 0) {
+        return 0;
+    }
+    return total;
+}
+
+int timing_pipe_init(timing_pipe_t *p, void *mem, size_t mem_size, size_t n,
+                     uint32_t n_shards, uint32_t n_producers, size_t ring_cap,
+                     const timing_config_t *cfg) {
+    size_t rings = (size_t)n_shards * n_producers;
+    size_t scratch_size, total, r;
+    uint8_t *m = (uint8_t *)mem;
+    uint32_t s;
+
+    if (!p || !mem || !cfg ||
+        layout(n, n_shards, n_producers, ring_cap,
+               &scratch_size, &total) != 0 || mem_size < total) {
+        return -1;
+    }
+    if (((uintptr_t)mem % sizeof(uint64_t)) != 0) {
+        return -1;
+    }
+
+    p->n = n;
+    p->n_shards = n_shards;
+    p->n_producers = n_producers;
+    p->ring_cap = ring_cap;
+    p->scratch_size = scratch_size;
+
+    /* Rings on their own cache lines; everything after stays 8-aligned */
+    m += (TIMING_PIPE_LINE - (uintptr_t)m % TIMING_PIPE_LINE) %
+         TIMING_PIPE_LINE;
+    p->ring = (timing_pipe_ring_t *)(void *)m;
+    m += rings * sizeof(timing_pipe_ring_t);
+    p->shard = (timing_fleet_t *)(void *)m;
+    m += n_shards * sizeof(timing_fleet_t);
+    p->scratch = (uint64_t *)(void *)m;
+    m += n_shards * scratch_size;
+
+    for (r = 0; r < rings; r++) {
+        p->ring[r].ts = (uint64_t *)(void *)m;
+        m += ring_cap * sizeof(uint64_t);
+    }
+    for (s = 0; s < n_shards; s++) {
+        size_t ns = shard_size(n, n_shards, s);
+        size_t cols = timing_fleet_bytes(ns);
+        if (timing_fleet_init(&p->shard[s], m, cols, ns, cfg) != 0) {
+            return -1;
+        }
+        m += cols;
+    }
+    for (r = 0; r < rings; r++) {
+        timing_pipe_ring_t *q = &p->ring[r];
+        q->id = (uint32_t *)(void *)m;
+        m += ring_cap * sizeof(uint32_t);
+        q->cap = ring_cap;
+        q->tail_seen = 0;
+        atomic_init(&q->head, 0);
+        atomic_init(&q->tail, 0);
+    }
+    return 0;
+}
+
+int timing_pipe_post(timing_pipe_t *p, uint32_t producer, uint32_t id,
+                     uint64_t ts) {
+    timing_pipe_ring_t *q;
+    size_t head, slot;
+
+    if (!p || producer >= p->n_producers || id >= p->n) {
+        return -1;
+    }
+    q = &p->ring[(size_t)producer * p->n_shards + id % p->n_shards];
+    head = atomic_load_explicit(&q->head, memory_order_relaxed);
+
+    /* Looks full: see how far the consumer has got */
+    if (head - q->tail_seen >= q->cap) {
+        q->tail_seen = atomic_load_explicit(&q->tail, memory_order_acquire);
+        if (head - q->tail_seen >= q->cap) {
+            return 0;
+        }
+    }
+
+    slot = head & (q->cap - 1u);
+    q->id[slot] = id / p->n_shards;
+    q->ts[slot] = ts;
+    atomic_store_explicit(&q->head, head + 1u, memory_order_release);
+    return 1;
+}
+
+size_t timing_pipe_drain(timing_pipe_t *p, uint32_t s, uint32_t *changed) {
+    timing_fleet_t *f;
+    void *scratch;
+    size_t n_changed = 0;
+    uint32_t prod;
+
+    if (!p || s >= p->n_shards) {
+        return 0;
+    }
+    f = &p->shard[s];
+    scratch = (uint8_t *)p->scratch + (size_t)s * p->scratch_size;
+
+    for (prod = 0; prod < p->n_producers; prod++) {
+        timing_pipe_ring_t *q = &p->ring[(size_t)prod * p->n_shards + s];
+        size_t tail = atomic_load_explicit(&q->tail, memory_order_relaxed);
+        size_t head = atomic_load_explicit(&q->head, memory_order_acquire);
+
+        if (head == tail) {
+            continue;
+        }
+        /* At most two runs: up to the end of the buffer, then from 0 */
+        while (tail != head) {
+            size_t off = tail & (q->cap - 1u);
+            size_t len = head - tail;
+            uint32_t *out = changed ? changed + n_changed : NULL;
+            size_t k, j;
+
+            len = (len < q->cap - off) ? len : q->cap - off;
+            k = timing_fleet_ingest(f, q->id + off, q->ts + off, len,
+                                    scratch, p->scratch_size, out);
+            for (j = 0; out && j < k; j++) {
+                out[j] = out[j] * p->n_shards + s;
+            }
+            n_changed += k;
+            tail += len;
+        }
+        atomic_store_explicit(&q->tail, tail, memory_order_release);
+    }
+    return n_changed;
+}
+
+size_t timing_pipe_sweep(timing_pipe_t *p, uint32_t s,
+                         uint64_t current_time_ms, uint32_t *dead) {
+    size_t k, j;
+
+    if (!p || s >= p->n_shards) {
+        return 0;
+    }
+    k = timing_fleet_sweep(&p->shard[s], current_time_ms, dead);
+    for (j = 0; dead && j < k; j++) {
+        dead[j] = dead[j] * p->n_shards + s;
+    }
+    return k;
+}
@@ -0,0 +1,167 @@
+/**
+ * timing_reorder.c - Bounded-Lateness Reorder Stage Implementation
+ *
+ * The buffer is a sorted array of at most TIMING_REORDER_CAP entries:
+ * an insertion moves at most seven timestamps, a release shifts the
+ * rest down. At this size that beats a heap or a ring of buckets, and
+ * the whole stage fits in two cache lines.
+ *
+ * Copyright (c) 2025 William Murray
+ * MIT License
+ */
+
+#include "timing_reorder.h"
+#include <string.h>
+
+/* ============================================================
+ * INTERNAL: Buffer
+ * ============================================================ */
+
+/** Record ts as released */
+static void mark_out(timing_reorder_t *r, uint64_t ts) {
+    r->last_out = ts;
+    r->has_out = 1;
+}
+
+/** Remove held[0 .. k-1], copying them to out */
+static void take_front(timing_reorder_t *r, size_t k, uint64_t *out) {
+    memcpy(out, r->held, k * sizeof(uint64_t));
+    memmove(r->held, r->held + k, (r->n_held - k) * sizeof(uint64_t));
+    r->n_held = (uint8_t)(r->n_held - k);
+    mark_out(r, out[k - 1]);
+}
+
+/* ============================================================
+ * PUBLIC API
+ * ============================================================ */
+
+int timing_reorder_init(timing_reorder_t *r, uint64_t lateness_ms) {
+    if (!r || lateness_ms >= (1ULL << 63)) {
+        return -1;
+    }
+    memset(r, 0, sizeof(*r));
+    r->lateness_ms = lateness_ms;
+    return 0;
+}
+
+size_t timing_reorder_push(timing_reorder_t *r, uint64_t ts, uint64_t *out) {
+    size_t i = 0;
+    size_t k = 0;
+
+    if (!r || !out) {
+        return 0;
+    }
+
+    /* Behind a heartbeat already released: cannot be placed in order */
+    if (r->has_out && ts <= r->last_out) {
+        if (ts == r->last_out) {
+            r->duplicate++;
+        } else {
+            r->late++;
+        }
+        return 0;
+    }
+
+    while (i < r->n_held && r->held[i] < ts) {
+        i++;
+    }
+    if (i < r->n_held && r->held[i] == ts) {
+        r->duplicate++;
+        return 0;
+    }
+
+    r->max_seen = (ts > r->max_seen) ? ts : r->max_seen;
+
+    /* Full: the oldest of the held and the new goes out early */
+    if (r->n_held == TIMING_REORDER_CAP && i == 0) {
+        out[k++] = ts;
+        mark_out(r, ts);
+    } else {
+        if (r->n_held == TIMING_REORDER_CAP) {
+            take_front(r, 1, out);
+            k++;
+            i--;
+        }
+        memmove(&r->held[i + 1], &r->held[i],
+                (r->n_held - i) * sizeof(uint64_t));
+        r->held[i] = ts;
+        r->n_held++;
+    }
+
+    if (r->max_seen >= r->lateness_ms) {
+        k += timing_reorder_release(r, r->max_seen - r->lateness_ms, out + k);
+    }
+    return k;
+}
+
+size_t timing_reorder_release(timing_reorder_t *r, uint64_t until,
+                              uint64_t *out) {
+    size_t k = 0;
+
+    if (!r || !out) {
+        return 0;
+    }
+    while (k < r->n_held && r->held[k] <= until) {
+        k++;
+    }
+    if (k > 0) {
+        take_front(r, k, out);
+    }
+    return k;
+}
+
+size_t timing_reorder_heartbeat(timing_reorder_t *r, timing_fsm_t *t,
+                                uint64_t ts, timing_result_t *last) {
+    uint64_t out[TIMING_REORDER_CAP + 1];
+    size_t k, j;
+
+    if (!r || !t) {
+        return 0;
+    }
+    k = timing_reorder_push(r, ts, out);
+    for (j = 0; j < k; j++) {
+        timing_result_t res = timing_heartbeat(t, out[j]);
+        if (last && j + 1 == k) {
+            *last = res;
+        }
+    }
+    return k;
+}
+
+timing_result_t timing_reorder_check(timing_reorder_t *r, timing_fsm_t *t,
+                                     uint64_t current_time_ms) {
+    uint64_t out[TIMING_REORDER_CAP];
+    uint64_t at;
+    size_t k, j;
+
+    if (!r || !t) {
+        return timing_check(NULL, current_time_ms);  /* DEAD result */
+    }
+
+    at = (current_time_ms >= r->lateness_ms)
+       ? current_time_ms - r->lateness_ms : 0;
+    k = timing_reorder_release(r, at, out);
+    for (j = 0; j < k; j++) {
+        timing_heartbeat(t, out[j]);
+    }
+
+    /* Never check before a heartbeat the monitor already holds */
+    if (r->has_out && r->last_out > at) {
+        at = r->last_out;
+    }
+    return timing_check(t, at);
+}
+
+size_t timing_reorder_flush(timing_reorder_t *r, timing_fsm_t *t) {
+    uint64_t out[TIMING_REORDER_CAP];
+    size_t k, j;
+
+    if (!r || !t) {
+        return 0;
+    }
+    k = timing_reorder_release(r, UINT64_MAX, out);
+    for (j = 0; j < k; j++) {
+        timing_heartbeat(t, out[j]);
+    }
+    return k;
+}
@@ -17,7 +17,12 @@
 #include <stdlib.h>
 #include <string.h>
 #include <math.h>
+#include <pthread.h>
+#include <sched.h>
 #include "timing.h"
+#include "timing_fleet.h"
+#include "timing_pipe.h"
+#include "timing_reorder.h"
 
 /* ============================================================
  * TEST INFRASTRUCTURE
@@ -453,6 +458,714 @@ static void test_fuzz_edge_timestamps(void) {
     PASS("Edge case timestamps handled correctly");
 }
 
+/* ============================================================
+ * PHI-ACCRUAL TESTS
+ * ============================================================ */
+
+static void test_phi_table(void) {
+    /* Table agrees with the closed form it was generated from */
+    for (double z = -4.0; z <= 12.0; z += 0.37) {
+        double exact = -log10(0.5 * erfc(z / sqrt(2.0)));
+        ASSERT(fabs(timing_phi_of_z(z) - exact) < 0.02 * (1.0 + exact),
+               "table should match -log10(1 - F(z))");
+    }
+    ASSERT(fabs(timing_phi_of_z(0.0) - 0.30103) < 1e-4, "phi(0) = log10(2)");
+    
+    /* Monotonic, clamped, and the inverse round-trips */
+    ASSERT(timing_phi_of_z(-100.0) == timing_phi_of_z(TIMING_PHI_Z_MIN),
+           "clamped below");
+    ASSERT(timing_phi_of_z(100.0) == timing_phi_of_z(TIMING_PHI_Z_MAX),
+           "clamped above");
+    for (double phi = 0.5; phi < 30.0; phi += 0.25) {
+        double z = timing_phi_z_for(phi);
+        ASSERT(fabs(timing_phi_of_z(z) - phi) < 1e-9, "inverse round-trips");
+        ASSERT(timing_phi_z_for(phi + 0.25) > z, "inverse is monotonic");
+    }
+    
+    PASS("Phi lookup table matches the normal tail and inverts");
+}
+
+static void test_phi_mode_detects_early(void) {
+    timing_fsm_t fixed, phi;
+    timing_config_t cfg = TIMING_DEFAULT_CONFIG;
+    cfg.heartbeat_timeout_ms = 5000;
+    
+    ASSERT(timing_init(&fixed, &cfg) == 0, "init fixed failed");
+    cfg.phi_threshold = 8.0;
+    ASSERT(timing_init(&phi, &cfg) == 0, "init phi failed");
+    
+    /* Learn a 100 ms rhythm with a few ms of jitter */
+    uint64_t ts = 0;
+    for (int i = 0; i < 200; i++) {
+        ts += 100 + (uint64_t)(i % 5);
+        timing_heartbeat(&fixed, ts);
+        timing_heartbeat(&phi, ts);
+    }
+    ASSERT(timing_ready(&phi), "baseline should be ready");
+    ASSERT(phi.timeout_ms < 5000, "phi mode should shorten the timeout");
+    
+    /* A normal gap is not suspicious */
+    timing_result_t r = timing_check(&phi, ts + 102);
+    ASSERT(r.has_phi && r.phi < 8.0, "normal gap should have low phi");
+    ASSERT(r.state == TIMING_HEALTHY, "normal gap should stay healthy");
+    
+    /* A long silence: DEAD in phi mode well before T */
+    r = timing_check(&phi, ts + 1000);
+    ASSERT(r.has_phi && r.phi >= 8.0, "long silence should have high phi");
+    ASSERT(r.state == TIMING_DEAD, "phi mode should declare DEAD");
+    r = timing_check(&fixed, ts + 1000);
+    ASSERT(r.state == TIMING_HEALTHY, "fixed T should still be healthy");
+    
+    /* Recovery works as usual */
+    r = timing_heartbeat(&phi, ts + 1100);
+    ASSERT(r.state != TIMING_DEAD, "heartbeat should revive");
+    
+    PASS("Phi-accrual declares DEAD early on a learned rhythm");
+}
+
+static void test_phi_never_later_than_T(void) {
+    timing_fsm_t t;
+    timing_config_t cfg = TIMING_DEFAULT_CONFIG;
+    cfg.heartbeat_timeout_ms = 500;
+    cfg.phi_threshold = 30.0;
+    
+    ASSERT(timing_init(&t, &cfg) == 0, "init failed");
+    
+    /* Wildly jittery rhythm: μ + z·σ far beyond T */
+    uint64_t ts = 0;
+    srand(7);
+    for (int i = 0; i < 100; i++) {
+        ts += 50 + (uint64_t)(rand() % 400);
+        timing_heartbeat(&t, ts);
+        ASSERT(t.timeout_ms <= cfg.heartbeat_timeout_ms, "INV-7 violated");
+    }
+    
+    timing_result_t r = timing_check(&t, ts + 501);
+    ASSERT(r.state == TIMING_DEAD, "T must still bound detection");
+    
+    PASS("Phi-accrual never detects later than T");
+}
+
+/* ============================================================
+ * FLEET TESTS
+ * ============================================================ */
+
+#define FLEET_N 12
+
+static int same_result(const timing_result_t *a, const timing_result_t *b) {
+    return a->state == b->state &&
+           memcmp(&a->dt, &b->dt, sizeof(double)) == 0 &&
+           a->has_dt == b->has_dt &&
+           memcmp(&a->z, &b->z, sizeof(double)) == 0 &&
+           a->has_z == b->has_z &&
+           memcmp(&a->phi, &b->phi, sizeof(double)) == 0 &&
+           a->has_phi == b->has_phi &&
+           a->pulse_state == b->pulse_state &&
+           a->baseline_state == b->baseline_state &&
+           a->is_healthy == b->is_healthy &&
+           a->is_unhealthy == b->is_unhealthy &&
+           a->is_dead == b->is_dead &&
+           a->is_anomaly == b->is_anomaly;
+}
+
+static int same_state(const timing_fleet_t *f, size_t i,
+                      const timing_fsm_t *t) {
+    return f->state[i] == (uint8_t)t->state &&
+           f->last_ms[i] == t->last_heartbeat_ms &&
+           f->timeout_ms[i] == t->timeout_ms &&
+           f->mu[i] == t->baseline.mu &&
+           f->variance[i] == t->baseline.variance &&
+           f->count[i] == t->baseline.n &&
+           timing_fleet_faulted(f, i) == timing_faulted(t) &&
+           timing_fleet_ready(f, i) == timing_ready(t);
+}
+
+static void test_fleet_matches_monitor(void) {
+    static uint64_t mem[FLEET_N * 5];
+    timing_fleet_t f;
+    timing_fsm_t t[FLEET_N];
+    timing_config_t cfg[3];
+    uint64_t ts[FLEET_N];
+    
+    cfg[0] = TIMING_DEFAULT_CONFIG;
+    cfg[1] = TIMING_DEFAULT_CONFIG;
+    cfg[1].phi_threshold = 8.0;
+    cfg[2] = TIMING_DEFAULT_CONFIG;
+    cfg[2].heartbeat_timeout_ms = 500;
+    cfg[2].alpha = 0.05;
+    cfg[2].n_min = 40;
+    cfg[2].phi_threshold = 3.0;
+    
+    ASSERT(timing_fleet_init(&f, mem, sizeof(mem), FLEET_N, &cfg[0]) == 0,
+           "fleet init failed");
+    ASSERT(timing_fleet_add_config(&f, &cfg[1]) == 1, "config 1");
+    ASSERT(timing_fleet_add_config(&f, &cfg[2]) == 2, "config 2");
+    for (size_t i = 0; i < FLEET_N; i++) {
+        ASSERT(timing_fleet_assign(&f, i, (uint8_t)(i % 3)) == 0, "assign");
+        ASSERT(timing_init(&t[i], &cfg[i % 3]) == 0, "init");
+        ts[i] = 1000;
+    }
+    
+    srand(21);
+    for (int step = 0; step < 200000; step++) {
+        size_t i = (size_t)rand() % FLEET_N;
+        int op = rand() % 1000;
+        timing_result_t a, b;
+        
+        if (op < 700) {
+            ts[i] += 90 + (uint64_t)(rand() % 20) + (op < 20 ? 3000 : 0);
+            if (op == 699) ts[i] -= 500;           /* Clock goes back */
+            a = timing_fleet_heartbeat(&f, i, ts[i]);
+            b = timing_heartbeat(&t[i], ts[i]);
+        } else if (op < 998) {
+            uint64_t now = ts[i] + (uint64_t)(rand() % 700);
+            if (op == 997) now = ts[i] - 1;        /* Before last: fault */
+            a = timing_fleet_check(&f, i, now);
+            b = timing_check(&t[i], now);
+        } else if (op == 998) {
+            f.flags[i] |= TIMING_FLEET_IN_STEP;    /* Reentrant call */
+            t[i].in_step = 1;
+            a = timing_fleet_heartbeat(&f, i, ts[i]);
+            b = timing_heartbeat(&t[i], ts[i]);
+            f.flags[i] &= (uint8_t)~TIMING_FLEET_IN_STEP;
+            t[i].in_step = 0;
+        } else {
+            timing_fleet_reset(&f, i);
+            timing_reset(&t[i]);
+            continue;
+        }
+        ASSERT(same_result(&a, &b), "result differs from timing_fsm_t");
+        ASSERT(same_state(&f, i, &t[i]), "state differs from timing_fsm_t");
+    }
+    
+    /* Out-of-range endpoint: total, DEAD */
+    ASSERT(timing_fleet_heartbeat(&f, FLEET_N, 0).is_dead, "bad index");
+    ASSERT(timing_fleet_check(NULL, 0, 0).is_dead, "NULL fleet");
+    
+    PASS("Fleet endpoints step exactly as timing_fsm_t");
+}
+
+static void test_fleet_config_table(void) {
+    static uint64_t mem[5 * 4 + 1];
+    timing_fleet_t f;
+    timing_config_t cfg = TIMING_DEFAULT_CONFIG;
+    
+    ASSERT(timing_fleet_bytes(4) == 4 * 40, "40 bytes an endpoint");
+    ASSERT(timing_fleet_bytes(0) == 0, "empty fleet");
+    ASSERT(timing_fleet_bytes((size_t)-1) == 0, "overflow");
+    
+    ASSERT(timing_fleet_init(&f, mem, 159, 4, &cfg) == -1, "short memory");
+    ASSERT(timing_fleet_init(&f, (char *)mem + 4, 160, 4, &cfg) == -1,
+           "misaligned memory");
+    cfg.alpha = 0.0;
+    ASSERT(timing_fleet_init(&f, mem, 160, 4, &cfg) == -1, "bad config");
+    
+    cfg = TIMING_DEFAULT_CONFIG;
+    ASSERT(timing_fleet_init(&f, mem, 160, 4, &cfg) == 0, "init failed");
+    cfg.k = -1.0;
+    ASSERT(timing_fleet_add_config(&f, &cfg) == -1, "invalid config added");
+    cfg = TIMING_DEFAULT_CONFIG;
+    for (int i = 1; i < TIMING_FLEET_MAX_CONFIGS; i++) {
+        cfg.heartbeat_timeout_ms = 1000 * (uint64_t)i;
+        ASSERT(timing_fleet_add_config(&f, &cfg) == i, "config index");
+    }
+    ASSERT(timing_fleet_add_config(&f, &cfg) == -1, "table should be full");
+    ASSERT(timing_fleet_assign(&f, 4, 0) == -1, "endpoint out of range");
+    ASSERT(timing_fleet_assign(&f, 0, TIMING_FLEET_MAX_CONFIGS) == -1,
+           "config out of range");
+    
+    /* Assigning resets under the new config */
+    ASSERT(timing_fleet_assign(&f, 3, 2) == 0, "assign failed");
+    ASSERT(f.timeout_ms[3] == 2000, "timeout of config 2");
+    timing_fleet_heartbeat(&f, 3, 100);
+    ASSERT(timing_fleet_check(&f, 3, 2101).is_dead, "DEAD after T of config 2");
+    ASSERT(!timing_fleet_check(&f, 0, 2101).is_dead, "others unaffected");
+    timing_fleet_reset(&f, 3);
+    ASSERT(timing_fleet_state(&f, 3) == TIMING_INITIALIZING &&
+           f.cfg_id[3] == 2, "reset keeps config");
+    
+    PASS("Shared config table: validation, assignment, reset");
+}
+
+static void test_fleet_ingest(void) {
+    enum { N = 300, BATCH = 2000 };
+    static uint64_t mem_a[N * 5], mem_b[N * 5], scratch[2 * BATCH];
+    static uint32_t id[BATCH], changed[BATCH];
+    static uint64_t ts[BATCH];
+    static uint8_t before[N];
+    timing_fleet_t a, b;
+    uint64_t now = 1000;
+    
+    ASSERT(timing_fleet_ingest_bytes(BATCH) == sizeof(scratch), "scratch size");
+    ASSERT(timing_fleet_init(&a, mem_a, sizeof(mem_a), N,
+                             &TIMING_DEFAULT_CONFIG) == 0, "init a");
+    ASSERT(timing_fleet_init(&b, mem_b, sizeof(mem_b), N,
+                             &TIMING_DEFAULT_CONFIG) == 0, "init b");
+    
+    srand(22);
+    for (int batch = 0; batch < 60; batch++) {
+        /* mode 0: unsorted + scratch, 1: id-sorted, 2: unsorted, none */
+        int mode = batch % 3;
+        size_t n_changed, expect = 0;
+        
+        for (size_t j = 0; j < BATCH; j++) {
+            id[j] = (uint32_t)(rand() % (N + 2));   /* Some out of range */
+            now += (uint64_t)(rand() % 3);
+            ts[j] = now;
+        }
+        if (mode == 1) {
+            /* Insertion sort by id, stable */
+            for (size_t j = 1; j < BATCH; j++) {
+                uint32_t ki = id[j];
+                uint64_t kt = ts[j];
+                size_t k = j;
+                for (; k > 0 && id[k - 1] > ki; k--) {
+                    id[k] = id[k - 1];
+                    ts[k] = ts[k - 1];
+                }
+                id[k] = ki;
+                ts[k] = kt;
+            }
+        }
+        
+        memcpy(before, a.state, N);
+        for (size_t j = 0; j < BATCH; j++) {
+            timing_fleet_heartbeat(&b, id[j], ts[j]);
+        }
+        n_changed = timing_fleet_ingest(&a, id, ts, BATCH,
+                                        mode == 0 ? scratch : NULL,
+                                        sizeof(scratch), changed);
+        
+        ASSERT(memcmp(mem_a, mem_b, sizeof(mem_a)) == 0,
+               "columns differ from per-event heartbeats");
+        for (size_t i = 0; i < N; i++) {
+            expect += (a.state[i] != before[i]);
+        }
+        if (mode == 2) {
+            ASSERT(n_changed >= expect, "fallback must report every change");
+            continue;
+        }
+        ASSERT(n_changed == expect, "each changed id reported once");
+        for (size_t k = 0; k < n_changed; k++) {
+            ASSERT(changed[k] < N && a.state[changed[k]] != before[changed[k]],
+                   "reported id did not change");
+            ASSERT(k == 0 || changed[k] > changed[k - 1],
+                   "ids in ascending order");
+        }
+    }
+    ASSERT(timing_fleet_state(&a, 0) != TIMING_INITIALIZING,
+           "endpoints should have learned");
+    ASSERT(timing_fleet_ingest(&a, id, ts, 0, NULL, 0, NULL) == 0, "empty");
+    
+    PASS("Batched ingest equals per-event heartbeats, reports changes");
+}
+
+static void test_fleet_sweep(void) {
+    enum { N = 203 };   /* Not a multiple of the sweep's group of 8 */
+    static uint64_t mem_a[N * 5 + 8], mem_b[N * 5 + 8];
+    static uint32_t dead[N];
+    static uint8_t before[N];
+    timing_fleet_t a, b;
+    timing_config_t fast = TIMING_DEFAULT_CONFIG;
+    uint64_t now = 1000;
+    size_t n_dead, expect, total = 0;
+    
+    ASSERT(timing_fleet_bytes(N) <= sizeof(mem_a), "memory size");
+    ASSERT(timing_fleet_init(&a, mem_a, sizeof(mem_a), N,
+                             &TIMING_DEFAULT_CONFIG) == 0, "init a");
+    ASSERT(timing_fleet_init(&b, mem_b, sizeof(mem_b), N,
+                             &TIMING_DEFAULT_CONFIG) == 0, "init b");
+    fast.heartbeat_timeout_ms = 40;
+    fast.phi_threshold = 8.0;
+    ASSERT(timing_fleet_add_config(&a, &fast) == 1, "add config a");
+    ASSERT(timing_fleet_add_config(&b, &fast) == 1, "add config b");
+    for (size_t i = 0; i < N; i += 3) {
+        timing_fleet_assign(&a, i, 1);
+        timing_fleet_assign(&b, i, 1);
+    }
+    
+    srand(23);
+    for (int round = 0; round < 400; round++) {
+        /* Heartbeats to most endpoints; a few silent, reset or re-entered */
+        for (size_t i = 0; i < N; i++) {
+            int r = rand() % 100;
+            uint64_t ts = now + (uint64_t)(rand() % 20);
+            if (r < 70 || (i < 64 && r < 97)) {
+                timing_fleet_heartbeat(&a, i, ts);
+                timing_fleet_heartbeat(&b, i, ts);
+            } else if (r == 98) {
+                timing_fleet_reset(&a, i);
+                timing_fleet_reset(&b, i);
+            } else if (r == 99 && rand() % 20 == 0) {
+                a.flags[i] |= TIMING_FLEET_IN_STEP;
+                b.flags[i] |= TIMING_FLEET_IN_STEP;
+            }
+        }
+        now += 10 + (uint64_t)(rand() % 60);
+        
+        memcpy(before, a.state, N);
+        n_dead = timing_fleet_sweep(&a, now, dead);
+        for (size_t i = 0; i < N; i++) {
+            timing_fleet_check(&b, i, now);
+            a.flags[i] &= (uint8_t)~TIMING_FLEET_IN_STEP;
+            b.flags[i] &= (uint8_t)~TIMING_FLEET_IN_STEP;
+        }
+        
+        ASSERT(memcmp(mem_a, mem_b, sizeof(mem_a)) == 0,
+               "columns differ from per-endpoint checks");
+        expect = 0;
+        for (size_t i = 0; i < N; i++) {
+            expect += (before[i] != TIMING_DEAD &&
+                       a.state[i] == TIMING_DEAD);
+        }
+        ASSERT(n_dead == expect, "each new death reported once");
+        for (size_t k = 0; k < n_dead; k++) {
+            ASSERT(dead[k] < N && before[dead[k]] != TIMING_DEAD &&
+                   a.state[dead[k]] == TIMING_DEAD, "reported id not new DEAD");
+            ASSERT(k == 0 || dead[k] > dead[k - 1], "ids in ascending order");
+        }
+        total += n_dead;
+    }
+    ASSERT(total > 0, "sweeps should have found deaths");
+    
+    /* A sweep changes nothing it need not: the second finds no deaths */
+    ASSERT(timing_fleet_sweep(&a, now, NULL) == 0, "repeat sweep");
+    
+    /* Time fault: every endpoint not yet DEAD dies, counted without ids */
+    expect = 0;
+    for (size_t i = 0; i < N; i++) {
+        expect += (a.state[i] != TIMING_DEAD);
+    }
+    ASSERT(timing_fleet_sweep(&a, 1ULL << 63, NULL) == expect, "fault count");
+    for (size_t i = 0; i < N; i++) {
+        timing_fleet_check(&b, i, 1ULL << 63);
+    }
+    ASSERT(memcmp(mem_a, mem_b, sizeof(mem_a)) == 0, "fault columns differ");
+    ASSERT(timing_fleet_sweep(NULL, now, dead) == 0, "NULL fleet");
+    
+    PASS("Sweep equals per-endpoint checks, reports new deaths");
+}
+
+/* ============================================================
+ * PIPELINE TESTS
+ * ============================================================ */
+
+#define PIPE_N      1000
+#define PIPE_ROUNDS 60
+
+/** Heartbeat r of endpoint id: increasing in r, jittered across ids */
+static uint64_t pipe_ts(uint32_t id, int r) {
+    return 1000 + (uint64_t)r * 100 + (uint64_t)((id * 7u + (unsigned)r * 13u) % 30u);
+}
+
+/** Endpoint id of the pipeline equals endpoint id of a reference fleet */
+static int pipe_matches(const timing_pipe_t *p, const timing_fleet_t *ref,
+                        uint32_t id) {
+    const timing_fleet_t *f = &p->shard[timing_pipe_shard_of(p, id)];
+    size_t i = id / p->n_shards;
+    return f->state[i] == ref->state[id] &&
+           f->parts[i] == ref->parts[id] &&
+           f->flags[i] == ref->flags[id] &&
+           f->last_ms[i] == ref->last_ms[id] &&
+           f->timeout_ms[i] == ref->timeout_ms[id] &&
+           f->mu[i] == ref->mu[id] &&
+           f->variance[i] == ref->variance[id] &&
+           f->count[i] == ref->count[id];
+}
+
+static void test_pipe_matches_fleet(void) {
+    enum { SHARDS = 3, PRODUCERS = 2, CAP = 64 };
+    static uint64_t mem[PIPE_N * 5 + 8192];
+    static uint64_t ref_mem[PIPE_N * 5];
+    static uint32_t changed[PRODUCERS * CAP];
+    timing_pipe_t p;
+    timing_fleet_t ref;
+    size_t total_changed = 0;
+    
+    ASSERT(timing_pipe_bytes(PIPE_N, SHARDS, PRODUCERS, CAP) <= sizeof(mem),
+           "memory size");
+    ASSERT(timing_pipe_bytes(PIPE_N, SHARDS, PRODUCERS, 48) == 0,
+           "capacity must be a power of two");
+    ASSERT(timing_pipe_bytes(2, SHARDS, PRODUCERS, CAP) == 0,
+           "fewer endpoints than shards");
+    ASSERT(timing_pipe_init(&p, mem, sizeof(mem), PIPE_N, SHARDS, PRODUCERS,
+                            CAP, &TIMING_DEFAULT_CONFIG) == 0, "init");
+    ASSERT(timing_fleet_init(&ref, ref_mem, sizeof(ref_mem), PIPE_N,
+                             &TIMING_DEFAULT_CONFIG) == 0, "init ref");
+    ASSERT(timing_pipe_post(&p, PRODUCERS, 0, 1) == -1, "bad producer");
+    ASSERT(timing_pipe_post(&p, 0, PIPE_N, 1) == -1, "bad id");
+    
+    /* Producer id % 2 posts endpoint id; drain whenever a ring fills */
+    for (int r = 0; r < PIPE_ROUNDS; r++) {
+        for (uint32_t id = 0; id < PIPE_N; id++) {
+            uint64_t ts = pipe_ts(id, r);
+            while (timing_pipe_post(&p, id % PRODUCERS, id, ts) == 0) {
+                uint32_t s = timing_pipe_shard_of(&p, id);
+                size_t k = timing_pipe_drain(&p, s, changed);
+                for (size_t j = 0; j < k; j++) {
+                    ASSERT(changed[j] < PIPE_N &&
+                           timing_pipe_shard_of(&p, changed[j]) == s,
+                           "changed id outside its shard");
+                }
+                total_changed += k;
+            }
+            timing_fleet_heartbeat(&ref, id, ts);
+        }
+    }
+    for (uint32_t s = 0; s < SHARDS; s++) {
+        total_changed += timing_pipe_drain(&p, s, NULL);
+        ASSERT(timing_pipe_drain(&p, s, changed) == 0, "rings drained");
+    }
+    ASSERT(total_changed >= PIPE_N, "every endpoint changed state");
+    for (uint32_t id = 0; id < PIPE_N; id++) {
+        ASSERT(pipe_matches(&p, &ref, id), "endpoint differs from fleet");
+        ASSERT(timing_pipe_state(&p, id) == TIMING_HEALTHY, "learned");
+    }
+    
+    /* Sweep: every endpoint dies once, reported under its global id */
+    {
+        static uint32_t dead[PIPE_N];
+        uint64_t late = pipe_ts(0, PIPE_ROUNDS) + 100000;
+        size_t n_dead = 0;
+        for (uint32_t s = 0; s < SHARDS; s++) {
+            size_t k = timing_pipe_sweep(&p, s, late, dead);
+            for (size_t j = 0; j < k; j++) {
+                ASSERT(timing_pipe_shard_of(&p, dead[j]) == s &&
+                       timing_pipe_state(&p, dead[j]) == TIMING_DEAD,
+                       "dead id");
+            }
+            n_dead += k;
+        }
+        ASSERT(n_dead == PIPE_N, "each endpoint reported dead once");
+    }
+    
+    PASS("Sharded pipeline equals one fleet, through full and wrapping rings");
+}
+
+typedef struct {
+    timing_pipe_t *p;
+    uint32_t       me;        /* Producer or shard index          */
+    atomic_int    *producing; /* Producers still running          */
+    size_t         changed;   /* Worker: changes reported         */
+} pipe_thread_t;
+
+static void *pipe_producer(void *arg) {
+    pipe_thread_t *t = (pipe_thread_t *)arg;
+    
+    for (int r = 0; r < PIPE_ROUNDS; r++) {
+        for (uint32_t id = t->me; id < PIPE_N; id += t->p->n_producers) {
+            while (timing_pipe_post(t->p, t->me, id, pipe_ts(id, r)) == 0) {
+                sched_yield();
+            }
+        }
+    }
+    atomic_fetch_sub_explicit(t->producing, 1, memory_order_release);
+    return NULL;
+}
+
+static void *pipe_worker(void *arg) {
+    pipe_thread_t *t = (pipe_thread_t *)arg;
+    
+    for (;;) {
+        /* Read the flag first: a drain after it sees every last post */
+        int done = atomic_load_explicit(t->producing,
+                                        memory_order_acquire) == 0;
+        size_t k = timing_pipe_drain(t->p, t->me, NULL);
+        t->changed += k;
+        if (done) {
+            break;
+        }
+        if (k == 0) {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void test_pipe_threads(void) {
+    enum { SHARDS = 3, PRODUCERS = 2, CAP = 32 };
+    static uint64_t mem[PIPE_N * 5 + 8192];
+    static uint64_t ref_mem[PIPE_N * 5];
+    pipe_thread_t prod[PRODUCERS], work[SHARDS];
+    pthread_t prod_tid[PRODUCERS], work_tid[SHARDS];
+    atomic_int producing;
+    timing_pipe_t p;
+    timing_fleet_t ref;
+    
+    ASSERT(timing_pipe_init(&p, mem, sizeof(mem), PIPE_N, SHARDS, PRODUCERS,
+                            CAP, &TIMING_DEFAULT_CONFIG) == 0, "init");
+    ASSERT(timing_fleet_init(&ref, ref_mem, sizeof(ref_mem), PIPE_N,
+                             &TIMING_DEFAULT_CONFIG) == 0, "init ref");
+    atomic_init(&producing, PRODUCERS);
+    
+    for (uint32_t s = 0; s < SHARDS; s++) {
+        work[s] = (pipe_thread_t){ &p, s, &producing, 0 };
+        ASSERT(pthread_create(&work_tid[s], NULL, pipe_worker, &work[s]) == 0,
+               "start worker");
+    }
+    for (uint32_t q = 0; q < PRODUCERS; q++) {
+        prod[q] = (pipe_thread_t){ &p, q, &producing, 0 };
+        ASSERT(pthread_create(&prod_tid[q], NULL, pipe_producer, &prod[q]) == 0,
+               "start producer");
+    }
+    for (uint32_t q = 0; q < PRODUCERS; q++) {
+        pthread_join(prod_tid[q], NULL);
+    }
+    for (uint32_t s = 0; s < SHARDS; s++) {
+        pthread_join(work_tid[s], NULL);
+        ASSERT(work[s].changed > 0, "worker saw changes");
+    }
+    
+    for (int r = 0; r < PIPE_ROUNDS; r++) {
+        for (uint32_t id = 0; id < PIPE_N; id++) {
+            timing_fleet_heartbeat(&ref, id, pipe_ts(id, r));
+        }
+    }
+    for (uint32_t id = 0; id < PIPE_N; id++) {
+        ASSERT(pipe_matches(&p, &ref, id), "endpoint differs from fleet");
+    }
+    
+    PASS("2 producer and 3 worker threads: per-endpoint order preserved");
+}
+
+/* ============================================================
+ * REORDER TESTS
+ * ============================================================ */
+
+/** Same heartbeats applied: same state and statistics */
+static int monitors_match(const timing_fsm_t *a, const timing_fsm_t *b) {
+    return a->state == b->state &&
+           a->last_heartbeat_ms == b->last_heartbeat_ms &&
+           a->heartbeat_count == b->heartbeat_count &&
+           a->baseline.mu == b->baseline.mu &&
+           a->baseline.variance == b->baseline.variance &&
+           a->baseline.n == b->baseline.n &&
+           timing_faulted(a) == timing_faulted(b);
+}
+
+static void test_reorder_restores_order(void) {
+    enum { N = 300 };
+    static uint64_t ts[N], arrive[N];
+    timing_fsm_t ref, t, raw;
+    timing_reorder_t r;
+    timing_result_t last;
+    size_t applied = 0;
+    
+    /* Heartbeats every ~200 ms, each delayed 0-299 ms on its path */
+    srand(25);
+    for (int j = 0; j < N; j++) {
+        ts[j] = 1000 + (uint64_t)j * 200 + (uint64_t)(rand() % 20);
+        arrive[j] = ts[j] + (uint64_t)(rand() % 300);
+    }
+    /* Arrival order: a slow path is overtaken by the next beats */
+    for (int j = 1; j < N; j++) {
+        for (int k = j; k > 0 && arrive[k - 1] > arrive[k]; k--) {
+            uint64_t a = arrive[k], b = ts[k];
+            arrive[k] = arrive[k - 1];  ts[k] = ts[k - 1];
+            arrive[k - 1] = a;          ts[k - 1] = b;
+        }
+    }
+    
+    ASSERT(timing_init(&ref, &TIMING_DEFAULT_CONFIG) == 0, "init ref");
+    ASSERT(timing_init(&t, &TIMING_DEFAULT_CONFIG) == 0, "init t");
+    ASSERT(timing_init(&raw, &TIMING_DEFAULT_CONFIG) == 0, "init raw");
+    ASSERT(timing_reorder_init(&r, 300) == 0, "init reorder");
+    ASSERT(timing_reorder_init(&r, 1ULL << 63) == -1, "absurd lateness");
+    ASSERT(timing_reorder_init(&r, 300) == 0, "init reorder");
+    
+    for (int j = 0; j < N; j++) {
+        timing_heartbeat(&raw, ts[j]);
+        applied += timing_reorder_heartbeat(&r, &t, ts[j], &last);
+    }
+    applied += timing_reorder_flush(&r, &t);
+    
+    /* The reference sees them sorted */
+    for (int j = 1; j < N; j++) {
+        for (int k = j; k > 0 && ts[k - 1] > ts[k]; k--) {
+            uint64_t b = ts[k]; ts[k] = ts[k - 1]; ts[k - 1] = b;
+        }
+    }
+    for (int j = 0; j < N; j++) {
+        timing_heartbeat(&ref, ts[j]);
+    }
+    
+    ASSERT(applied == N && r.late == 0 && r.duplicate == 0,
+           "every heartbeat within the bound is applied");
+    ASSERT(monitors_match(&t, &ref), "reordered stream equals sorted stream");
+    ASSERT(timing_state(&t) == TIMING_HEALTHY, "reordered stream healthy");
+    ASSERT(!monitors_match(&raw, &ref), "unordered stream should differ");
+    
+    /* lateness 0, in order: each heartbeat goes straight through */
+    ASSERT(timing_init(&t, &TIMING_DEFAULT_CONFIG) == 0, "init t");
+    ASSERT(timing_init(&ref, &TIMING_DEFAULT_CONFIG) == 0, "init ref");
+    ASSERT(timing_reorder_init(&r, 0) == 0, "init reorder");
+    for (int j = 0; j < N; j++) {
+        timing_result_t a = timing_heartbeat(&ref, ts[j]);
+        ASSERT(timing_reorder_heartbeat(&r, &t, ts[j], &last) == 1,
+               "released at once");
+        ASSERT(last.state == a.state && last.z == a.z, "same result");
+        a = timing_check(&ref, ts[j] + 400);
+        last = timing_reorder_check(&r, &t, ts[j] + 400);
+        ASSERT(last.state == a.state, "same check");
+    }
+    ASSERT(monitors_match(&t, &ref), "transparent with lateness 0");
+    
+    PASS("Heartbeats up to the bound late are applied in order");
+}
+
+static void test_reorder_bounds(void) {
+    uint64_t out[TIMING_REORDER_CAP + 1];
+    timing_reorder_t r;
+    timing_fsm_t t;
+    timing_result_t res;
+    uint64_t now;
+    
+    /* Watermark, late and duplicate heartbeats */
+    ASSERT(timing_reorder_init(&r, 100) == 0, "init");
+    ASSERT(timing_reorder_push(&r, 1000, out) == 0, "held");
+    ASSERT(timing_reorder_push(&r, 1050, out) == 0, "held");
+    ASSERT(timing_reorder_push(&r, 1200, out) == 2 &&
+           out[0] == 1000 && out[1] == 1050, "released in order");
+    ASSERT(timing_reorder_push(&r, 1040, out) == 0 && r.late == 1,
+           "behind a released heartbeat: late");
+    ASSERT(timing_reorder_push(&r, 1200, out) == 0 &&
+           timing_reorder_push(&r, 1050, out) == 0 && r.duplicate == 2,
+           "held or released timestamp: duplicate");
+    ASSERT(timing_reorder_push(&r, 1150, out) == 0 && r.n_held == 2,
+           "within the bound: held");
+    ASSERT(timing_reorder_release(&r, 1160, out) == 1 && out[0] == 1150,
+           "release up to a time");
+    
+    /* Full buffer: the oldest goes out early, never a loss */
+    ASSERT(timing_reorder_init(&r, 1000000) == 0, "init");
+    for (uint64_t j = 0; j < TIMING_REORDER_CAP; j++) {
+        ASSERT(timing_reorder_push(&r, 100 + j * 10, out) == 0, "held");
+    }
+    ASSERT(timing_reorder_push(&r, 500, out) == 1 && out[0] == 100,
+           "oldest held forced out");
+    ASSERT(timing_reorder_push(&r, 105, out) == 1 && out[0] == 105,
+           "new oldest forced out at once");
+    ASSERT(timing_reorder_push(&r, 101, out) == 0 && r.late == 1,
+           "behind a forced heartbeat: late");
+    
+    /* Checks run lateness_ms behind: held heartbeats cannot be missed */
+    ASSERT(timing_init(&t, &TIMING_DEFAULT_CONFIG) == 0, "init t");
+    ASSERT(timing_reorder_init(&r, 2000) == 0, "init");
+    for (now = 1000; now <= 40000; now += 1000) {
+        timing_reorder_heartbeat(&r, &t, now, NULL);
+    }
+    now -= 1000;    /* Last heartbeat; it and the one before are held */
+    ASSERT(r.n_held == 2, "two heartbeats held");
+    res = timing_reorder_check(&r, &t, now + 5500);
+    ASSERT(res.state != TIMING_DEAD, "5.5 s silence seen as 3.5 s: alive");
+    ASSERT(t.last_heartbeat_ms == now, "held heartbeats released");
+    res = timing_reorder_check(&r, &t, now + 2000 + 5001);
+    ASSERT(res.state == TIMING_DEAD, "dead after T + lateness");
+    ASSERT(!timing_faulted(&t), "no fault");
+    
+    PASS("Late, duplicate and overflowing heartbeats; delayed checks");
+}
+
 /* ============================================================
  * CONFIG VALIDATION TESTS
  * ============================================================ */
@@ -496,6 +1209,13 @@ static void test_config_validation(void) {
     cfg.n_min = 15;  /* ceil(2/0.1) = 20, so 15 is too small */
     ASSERT(timing_init(&t, &cfg) == -1, "n_min too small should fail");
     
+    /* Invalid: negative or NaN phi threshold */
+    cfg = TIMING_DEFAULT_CONFIG;
+    cfg.phi_threshold = -1.0;
+    ASSERT(timing_init(&t, &cfg) == -1, "negative phi should fail");
+    cfg.phi_threshold = NAN;
+    ASSERT(timing_init(&t, &cfg) == -1, "NaN phi should fail");
+    
     PASS("Config validation catches invalid parameters");
 }
 
@@ -529,6 +1249,29 @@ int main(void) {
     TEST(test_fuzz_random_timestamps);
     TEST(test_fuzz_edge_timestamps);
     
+    /* Phi-accrual tests */
+    printf("\n--- Phi-Accrual Tests ---\n");
+    TEST(test_phi_table);
+    TEST(test_phi_mode_detects_early);
+    TEST(test_phi_never_later_than_T);
+    
+    /* Fleet tests */
+    printf("\n--- Fleet Tests ---\n");
+    TEST(test_fleet_matches_monitor);
+    TEST(test_fleet_config_table);
+    TEST(test_fleet_ingest);
+    TEST(test_fleet_sweep);
+    
+    /* Pipeline tests */
+    printf("\n--- Pipeline Tests ---\n");
+    TEST(test_pipe_matches_fleet);
+    TEST(test_pipe_threads);
+    
+    /* Reorder tests */
+    printf("\n--- Reorder Tests ---\n");
+    TEST(test_reorder_restores_order);
+    TEST(test_reorder_bounds);
+    
     /* Config tests */
     printf("\n--- Config Validation Tests ---\n");
     TEST(test_config_validation);